@@ -0,0 +1,68 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <spectrum/Options.h>
+#include <spectrum/Result.h>
+#include <spectrum/io/IBitmapImageSink.h>
+#include <spectrum/io/IBitmapImageSource.h>
+#include <spectrum/io/IEncodedImageSink.h>
+#include <spectrum/io/IEncodedImageSource.h>
+
+#include <folly/Optional.h>
+
+#include <exception>
+
+namespace facebook {
+namespace spectrum {
+
+/**
+ * A single operation of a batch: the image is read from source and written to
+ * sink as described by options. Source and sink must not be shared with other
+ * jobs of the same batch as jobs run concurrently.
+ */
+template <class Source, class Sink, class OperationOptions>
+struct BatchJob {
+  Source& source;
+  Sink& sink;
+  OperationOptions options;
+};
+
+using DecodeJob =
+    BatchJob<io::IEncodedImageSource, io::IBitmapImageSink, DecodeOptions>;
+using EncodeJob =
+    BatchJob<io::IBitmapImageSource, io::IEncodedImageSink, EncodeOptions>;
+using TranscodeJob =
+    BatchJob<io::IEncodedImageSource, io::IEncodedImageSink, TranscodeOptions>;
+using TransformJob =
+    BatchJob<io::IBitmapImageSource, io::IBitmapImageSink, TransformOptions>;
+
+/**
+ * One of the outputs of Spectrum::transcodeMultiple: the transcoded image is
+ * written to sink as described by options.
+ */
+struct TranscodeOutput {
+  io::IEncodedImageSink& sink;
+  TranscodeOptions options;
+};
+
+/**
+ * Outcome of a single job of a batch. Exactly one of result and error is set.
+ */
+struct BatchResult {
+  /**
+   * Result of the job if it succeeded.
+   */
+  folly::Optional<Result> result;
+
+  /**
+   * The exception the job failed with (usually a SpectrumException).
+   */
+  std::exception_ptr error;
+};
+
+} // namespace spectrum
+} // namespace facebook
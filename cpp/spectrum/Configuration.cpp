@@ -43,6 +43,9 @@ void Configuration::General::merge(const General& rhs) {
   SPECTRUM_CONFIGURATION_MERGE_PROPERTY(
       propagateChromaSamplingModeFromSource, rhs);
   SPECTRUM_CONFIGURATION_MERGE_PROPERTY(chromaSamplingModeOverride, rhs);
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(numberOfScalingThreads, rhs);
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(scalingExecutor, rhs);
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(usePipelining, rhs);
 }
 
 bool Configuration::General::operator==(const General& rhs) const {
@@ -50,7 +53,10 @@ bool Configuration::General::operator==(const General& rhs) const {
       SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(interpretMetadata, rhs) &&
       SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(
              propagateChromaSamplingModeFromSource, rhs) &&
-      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(chromaSamplingModeOverride, rhs);
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(chromaSamplingModeOverride, rhs) &&
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(numberOfScalingThreads, rhs) &&
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(scalingExecutor, rhs) &&
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(usePipelining, rhs);
 }
 
 std::string Configuration::General::chromaSamplingModeOverrideStringFromValue(
@@ -166,6 +172,8 @@ void Configuration::Jpeg::merge(const Jpeg& rhs) {
   SPECTRUM_CONFIGURATION_MERGE_PROPERTY(useOptimizeScan, rhs);
   SPECTRUM_CONFIGURATION_MERGE_PROPERTY(useCompatibleDcScanOpt, rhs);
   SPECTRUM_CONFIGURATION_MERGE_PROPERTY(usePsnrQuantTable, rhs);
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(maxProgressiveScans, rhs);
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(useEmbeddedThumbnail, rhs);
 }
 
 bool Configuration::Jpeg::operator==(const Jpeg& rhs) const {
@@ -173,7 +181,9 @@ bool Configuration::Jpeg::operator==(const Jpeg& rhs) const {
       SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(useProgressive, rhs) &&
       SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(useOptimizeScan, rhs) &&
       SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(useCompatibleDcScanOpt, rhs) &&
-      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(usePsnrQuantTable, rhs);
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(usePsnrQuantTable, rhs) &&
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(maxProgressiveScans, rhs) &&
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(useEmbeddedThumbnail, rhs);
 }
 
 //
@@ -206,11 +216,15 @@ bool Configuration::Png::operator==(const Png& rhs) const {
 void Configuration::Webp::merge(const Webp& rhs) {
   SPECTRUM_CONFIGURATION_MERGE_PROPERTY(method, rhs);
   SPECTRUM_CONFIGURATION_MERGE_PROPERTY(imageHint, rhs);
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(useThreads, rhs);
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(useLowMemory, rhs);
 }
 
 bool Configuration::Webp::operator==(const Webp& rhs) const {
   return SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(method, rhs) &&
-      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(imageHint, rhs);
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(imageHint, rhs) &&
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(useThreads, rhs) &&
+      SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(useLowMemory, rhs);
 }
 
 std::string Configuration::Webp::imageHintStringFromValue(
@@ -237,6 +251,18 @@ Configuration::Webp::ImageHint Configuration::Webp::makeImageHintFromValue(
   return static_cast<Configuration::Webp::ImageHint>(value);
 }
 
+//
+// Avif
+//
+
+void Configuration::Avif::merge(const Avif& rhs) {
+  SPECTRUM_CONFIGURATION_MERGE_PROPERTY(maxThreads, rhs);
+}
+
+bool Configuration::Avif::operator==(const Avif& rhs) const {
+  return SPECTRUM_CONFIGURATION_COMPARE_PROPERTY(maxThreads, rhs);
+}
+
 //
 // Configuration
 //
@@ -246,11 +272,12 @@ void Configuration::merge(const Configuration& rhs) {
   jpeg.merge(rhs.jpeg);
   png.merge(rhs.png);
   webp.merge(rhs.webp);
+  avif.merge(rhs.avif);
 }
 
 bool Configuration::operator==(const Configuration& rhs) const {
   return general == rhs.general && jpeg == rhs.jpeg && png == rhs.png &&
-      webp == rhs.webp;
+      webp == rhs.webp && avif == rhs.avif;
 }
 
 bool Configuration::operator!=(const Configuration& rhs) const {
@@ -5,10 +5,13 @@
 
 #pragma once
 
+#include <spectrum/core/Executor.h>
 #include <spectrum/image/Color.h>
 #include <spectrum/image/Specification.h>
 
+#include <cstdint>
 #include <initializer_list>
+#include <memory>
 #include <string>
 
 #include <folly/Optional.h>
@@ -131,6 +134,37 @@ struct Configuration {
         chromaSamplingModeOverride,
         ChromaSamplingModeOverride::None);
 
+    /**
+     * General: Number of threads used to scale the image. Values above 1
+     * split the output into horizontal stripes that are scaled concurrently.
+     * The output is identical to the single threaded one.
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(
+        std::uint32_t,
+        numberOfScalingThreads,
+        1);
+
+    /**
+     * General: Executor running the scaling stripes when
+     * numberOfScalingThreads is above 1. If unset, a thread pool is created
+     * for the duration of the operation.
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(
+        std::shared_ptr<core::IExecutor>,
+        scalingExecutor,
+        nullptr);
+
+    /**
+     * General: Whether decoding, processing (e.g. scaling) and encoding run
+     * on separate threads and overlap. Reduces the latency of single large
+     * images at the cost of two extra threads per operation. The output is
+     * identical to the single threaded one.
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(
+        bool,
+        usePipelining,
+        false);
+
     void merge(const General& rhs);
     bool operator==(const General& rhs) const;
   } general;
@@ -187,6 +221,28 @@ struct Configuration {
         propagateSamplingModeFromSource,
         true);
 
+    /**
+     * The maximum number of scans of a progressive JPEG image that are
+     * decoded. Later scans only refine details, which are mostly invisible
+     * when the image is sampled down for small outputs. 0 decodes all scans.
+     * Ignored with JPEG libraries older than libjpeg-turbo 2.1.5.
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(
+        int,
+        maxProgressiveScans,
+        0);
+
+    /**
+     * Whether to decode the thumbnail embedded in the EXIF metadata instead of
+     * the image when it is large enough for the resize requirement. The
+     * thumbnail is usually of lower quality and might not reflect later edits
+     * of the image.
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(
+        bool,
+        useEmbeddedThumbnail,
+        false);
+
     void merge(const Jpeg& rhs);
     bool operator==(const Jpeg& rhs) const;
   } jpeg;
@@ -252,6 +308,18 @@ struct Configuration {
         imageHint,
         ImageHint::Default);
 
+    /**
+     * Whether the encoder may use multiple threads (maps to libwebp's
+     * `thread_level`).
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(bool, useThreads, false);
+
+    /**
+     * Whether the encoder should reduce its memory usage at the cost of
+     * encoding speed (maps to libwebp's `low_memory`).
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(bool, useLowMemory, false);
+
     void merge(const Webp& rhs);
     bool operator==(const Webp& rhs) const;
 
@@ -259,6 +327,20 @@ struct Configuration {
     static ImageHint makeImageHintFromValue(const int value);
   } webp;
 
+  //
+  // LibAvif parameters
+  //
+  struct Avif {
+    /**
+     * The maximum number of threads the AV1 decoder may use (maps to
+     * libavif's `maxThreads`).
+     */
+    SPECTRUM_CONFIGURATION_MAKE_PROPERTY_W_DEFAULTS(int, maxThreads, 1);
+
+    void merge(const Avif& rhs);
+    bool operator==(const Avif& rhs) const;
+  } avif;
+
   /**
    * Merges two configuration together.
    *
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <spectrum/Recipe.h>
+#include <spectrum/core/Operation.h>
 
 #include <functional>
 #include <memory>
@@ -118,6 +119,15 @@ struct Rule {
    * Rotation support level.
    */
   RotateSupport rotateSupport{RotateSupport::None};
+
+  /**
+   * Predicate further restricting the operations the rule matches on what
+   * the fields above can't express (e.g. the configuration or the decisions
+   * taken for the operation). Only called for operations matching all other
+   * requirements. If empty, no further restriction. A predicate that matches
+   * may hand state on to the recipe in `core::Operation::ruleState`.
+   */
+  std::function<bool(const core::Operation&)> operationPredicate;
 };
 
 } // namespace spectrum
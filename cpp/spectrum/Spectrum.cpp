@@ -6,9 +6,16 @@
 #include "Spectrum.h"
 
 #include <spectrum/core/SpectrumEnforce.h>
+#include <spectrum/core/recipes/BaseRecipe.h>
+#include <spectrum/image/ScanlinePool.h>
 #include <spectrum/io/RewindableImageSource.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace facebook {
@@ -25,6 +32,66 @@ std::uint32_t _totalTime(
       endTime - startTime);
   return SPECTRUM_CONVERT_OR_THROW(duration.count(), std::uint32_t);
 }
+
+/**
+ * Runs each job on the executor (or a temporary work-stealing one) and waits
+ * for all of them. Errors are captured per job. `run` is also given the
+ * executor of the batch.
+ */
+template <class Job, class Run>
+std::vector<BatchResult> runBatch(
+    const std::vector<Job>& jobs,
+    core::IExecutor* executor,
+    const Run& run) {
+  std::vector<BatchResult> results(jobs.size());
+  if (jobs.empty()) {
+    return results;
+  }
+
+  // the jobs' operations only borrow the executor: all of them have finished
+  // when the call returns
+  std::shared_ptr<core::IExecutor> batchExecutor;
+  if (executor == nullptr) {
+    const auto numberOfThreads = std::min<std::size_t>(
+        jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+    batchExecutor =
+        std::make_shared<core::WorkStealingExecutor>(numberOfThreads);
+  } else {
+    batchExecutor = std::shared_ptr<core::IExecutor>(
+        std::shared_ptr<core::IExecutor>{}, executor);
+  }
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::size_t numberOfPendingJobs = jobs.size();
+
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    batchExecutor->execute([&, i] {
+      try {
+        results[i].result = run(jobs[i], batchExecutor);
+      } catch (...) {
+        results[i].error = std::current_exception();
+      }
+
+      // notified while locked as the waiting thread owns the condition
+      std::lock_guard<std::mutex> lock(mutex);
+      --numberOfPendingJobs;
+      condition.notify_all();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [&] { return numberOfPendingJobs == 0; });
+  return results;
+}
+
+/**
+ * The scanline pool shared by the jobs of batches run on the current thread.
+ */
+image::ScanlinePool& threadScanlinePool() {
+  thread_local image::ScanlinePool scanlinePool;
+  return scanlinePool;
+}
 } // namespace
 
 Spectrum::Spectrum(
@@ -64,6 +131,51 @@ Result Spectrum::transcode(
   return _runEncoded(source, sink, options, startTime);
 }
 
+std::vector<Result> Spectrum::transcodeMultiple(
+    io::IEncodedImageSource& source,
+    const std::vector<TranscodeOutput>& outputs) const {
+  if (outputs.size() <= 1) {
+    std::vector<Result> results;
+    for (const auto& output : outputs) {
+      results.push_back(transcode(source, output.sink, output.options));
+    }
+    return results;
+  }
+
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  auto rewindableImageSource = io::RewindableImageSource{source};
+  SPECTRUM_ERROR_IF(
+      rewindableImageSource.available() < 1, error::EmptyInputSource);
+
+  std::vector<core::Operation> operations;
+  operations.reserve(outputs.size());
+  operations.push_back(_operationBuilder.build(
+      rewindableImageSource, outputs.front().sink, outputs.front().options));
+  for (std::size_t i = 1; i < outputs.size(); ++i) {
+    operations.push_back(_operationBuilder.build(
+        operations.front(), outputs[i].sink, outputs[i].options));
+  }
+
+  const auto outputImageSpecifications =
+      core::recipes::BaseRecipe{}.performMultiple(operations);
+  const auto duration = _totalTime(startTime);
+
+  std::vector<Result> results;
+  results.reserve(operations.size());
+  for (std::size_t i = 0; i < operations.size(); ++i) {
+    results.push_back(Result{
+        .ruleName = core::recipes::BaseRecipe::makeRule().name,
+        .inputImageSpecification =
+            operations[i].parameters.inputImageSpecification,
+        .outputImageSpecification = outputImageSpecifications[i],
+        .totalBytesRead = rewindableImageSource.getTotalBytesRead(),
+        .totalBytesWritten = operations[i].io.sink.totalBytesWritten(),
+        .duration = duration,
+    });
+  }
+  return results;
+}
+
 Result Spectrum::transform(
     io::IBitmapImageSource& source,
     io::IBitmapImageSink& sink,
@@ -72,22 +184,100 @@ Result Spectrum::transform(
   return _run(_operationBuilder.build(source, sink, options), startTime);
 }
 
+std::vector<BatchResult> Spectrum::decodeBatch(
+    const std::vector<DecodeJob>& jobs,
+    core::IExecutor* executor) const {
+  return runBatch(
+      jobs,
+      executor,
+      [this](
+          const DecodeJob& job,
+          const std::shared_ptr<core::IExecutor>& batchExecutor) {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        return _runEncoded(
+            job.source, job.sink, job.options, startTime, batchExecutor);
+      });
+}
+
+std::vector<BatchResult> Spectrum::encodeBatch(
+    const std::vector<EncodeJob>& jobs,
+    core::IExecutor* executor) const {
+  return runBatch(
+      jobs,
+      executor,
+      [this](
+          const EncodeJob& job,
+          const std::shared_ptr<core::IExecutor>& batchExecutor) {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        return _run(
+            _operationBuilder.build(job.source, job.sink, job.options),
+            startTime,
+            batchExecutor);
+      });
+}
+
+std::vector<BatchResult> Spectrum::transcodeBatch(
+    const std::vector<TranscodeJob>& jobs,
+    core::IExecutor* executor) const {
+  return runBatch(
+      jobs,
+      executor,
+      [this](
+          const TranscodeJob& job,
+          const std::shared_ptr<core::IExecutor>& batchExecutor) {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        return _runEncoded(
+            job.source, job.sink, job.options, startTime, batchExecutor);
+      });
+}
+
+std::vector<BatchResult> Spectrum::transformBatch(
+    const std::vector<TransformJob>& jobs,
+    core::IExecutor* executor) const {
+  return runBatch(
+      jobs,
+      executor,
+      [this](
+          const TransformJob& job,
+          const std::shared_ptr<core::IExecutor>& batchExecutor) {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        return _run(
+            _operationBuilder.build(job.source, job.sink, job.options),
+            startTime,
+            batchExecutor);
+      });
+}
+
 Result Spectrum::_runEncoded(
     io::IEncodedImageSource& source,
     io::IImageSink& sink,
     const Options& options,
-    const std::chrono::high_resolution_clock::time_point startTime) const {
+    const std::chrono::high_resolution_clock::time_point startTime,
+    const std::shared_ptr<core::IExecutor>& batchExecutor) const {
   auto rewindableImageSource = io::RewindableImageSource{source};
   SPECTRUM_ERROR_IF(
       rewindableImageSource.available() < 1, error::EmptyInputSource);
   return _run(
-      _operationBuilder.build(rewindableImageSource, sink, options), startTime);
+      _operationBuilder.build(rewindableImageSource, sink, options),
+      startTime,
+      batchExecutor);
 }
 
 Result Spectrum::_run(
-    const core::Operation& operation,
-    const std::chrono::high_resolution_clock::time_point startTime) const {
-  const auto rule = _ruleMatcher.findFirstMatching(operation.parameters);
+    core::Operation operation,
+    const std::chrono::high_resolution_clock::time_point startTime,
+    const std::shared_ptr<core::IExecutor>& batchExecutor) const {
+  if (batchExecutor != nullptr) {
+    // stripes that no thread of the batch has started are scaled by the job
+    // waiting for them, so sharing the batch's threads can't deadlock
+    auto& general = operation.configuration.general;
+    if (general.scalingExecutor() == nullptr) {
+      general.scalingExecutor(batchExecutor);
+    }
+    operation.scanlinePool = &threadScanlinePool();
+  }
+
+  const auto rule = _ruleMatcher.findFirstMatching(operation);
   const auto outputImageSpecification =
       rule.recipeFactory()->perform(operation);
 
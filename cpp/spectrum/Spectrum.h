@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <spectrum/Batch.h>
 #include <spectrum/Configuration.h>
 #include <spectrum/Options.h>
 #include <spectrum/Plugin.h>
@@ -12,6 +13,7 @@
 #include <spectrum/Rule.h>
 #include <spectrum/codecs/EncodedImageSpecificationDetector.h>
 #include <spectrum/codecs/Repository.h>
+#include <spectrum/core/Executor.h>
 #include <spectrum/core/OperationBuilder.h>
 #include <spectrum/core/PluginAggregator.h>
 #include <spectrum/core/RuleMatcher.h>
@@ -97,6 +99,23 @@ class Spectrum {
       io::IEncodedImageSink& sink,
       const TranscodeOptions& options) const;
 
+  /**
+   * Transcodes the image originating from the source into several outputs
+   * (e.g. the sizes of a thumbnail ladder) while decoding it only once. The
+   * image is decoded with the largest sampling ratio that suits all outputs
+   * and each output is cropped, scaled, rotated and encoded from there.
+   *
+   * Unlike `transcode`, passthrough rules are not considered when there's
+   * more than one output as the source is only read once.
+   *
+   * @param source The source from which the original image will be read from.
+   * @param outputs The sinks and options of the outputs.
+   * @return One Result per output, in the same order.
+   */
+  std::vector<Result> transcodeMultiple(
+      io::IEncodedImageSource& source,
+      const std::vector<TranscodeOutput>& outputs) const;
+
   /**
    * Transforms the image originating from the source into the sink using
    * options.
@@ -112,6 +131,45 @@ class Spectrum {
       io::IBitmapImageSink& sink,
       const TransformOptions& options = TransformOptions()) const;
 
+  /**
+   * Runs the given jobs concurrently and waits for all of them to finish. A
+   * failing job does not affect the others.
+   *
+   * @param jobs The jobs to run.
+   * Jobs configured with more than one scaling thread but no scaling executor
+   * run their scaling tasks on the executor of the batch as well. Jobs that
+   * run on the same thread recycle scanlines through a pool of that thread,
+   * which retains a bounded number of scanlines for the thread's lifetime.
+   *
+   * @param executor The executor to run the jobs on. If null, they are run on
+   * a work-stealing executor that lives for the duration of the call.
+   * @return One BatchResult for each job, in the same order.
+   */
+  std::vector<BatchResult> decodeBatch(
+      const std::vector<DecodeJob>& jobs,
+      core::IExecutor* executor = nullptr) const;
+
+  /**
+   * See decodeBatch.
+   */
+  std::vector<BatchResult> encodeBatch(
+      const std::vector<EncodeJob>& jobs,
+      core::IExecutor* executor = nullptr) const;
+
+  /**
+   * See decodeBatch.
+   */
+  std::vector<BatchResult> transcodeBatch(
+      const std::vector<TranscodeJob>& jobs,
+      core::IExecutor* executor = nullptr) const;
+
+  /**
+   * See decodeBatch.
+   */
+  std::vector<BatchResult> transformBatch(
+      const std::vector<TransformJob>& jobs,
+      core::IExecutor* executor = nullptr) const;
+
  private:
   Configuration _configuration;
   codecs::Repository _codecRepository;
@@ -122,15 +180,22 @@ class Spectrum {
       core::PluginAggregator&& pluginAggregator,
       const Configuration& configuration);
 
+  /**
+   * Runs the operation. Operations of a batch additionally get the batch's
+   * executor for their scaling tasks (unless they configure one) and the
+   * scanline pool of the current thread.
+   */
   Result _run(
-      const core::Operation& operation,
-      const std::chrono::high_resolution_clock::time_point startTime) const;
+      core::Operation operation,
+      const std::chrono::high_resolution_clock::time_point startTime,
+      const std::shared_ptr<core::IExecutor>& batchExecutor = nullptr) const;
 
   Result _runEncoded(
       io::IEncodedImageSource& source,
       io::IImageSink& sink,
       const Options& options,
-      const std::chrono::high_resolution_clock::time_point startTime) const;
+      const std::chrono::high_resolution_clock::time_point startTime,
+      const std::shared_ptr<core::IExecutor>& batchExecutor = nullptr) const;
 };
 
 } // namespace spectrum
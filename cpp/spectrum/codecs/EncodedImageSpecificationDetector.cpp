@@ -29,6 +29,15 @@ image::Specification
 EncodedImageSpecificationDetector::detectImageSpecification(
     io::RewindableImageSource& source,
     const Options& options) const {
+  const auto probedDecompressor = probe(source, options);
+  const auto imageSpecification = probedDecompressor->imageSpecification();
+  probedDecompressor->discard();
+  return imageSpecification;
+}
+
+std::shared_ptr<ProbedDecompressor> EncodedImageSpecificationDetector::probe(
+    io::RewindableImageSource& source,
+    const Options& options) const {
   const auto detectedFormat = _encodedImageFormatDetector.detectFormat(source);
 
   const auto decompressorProvider =
@@ -42,11 +51,7 @@ EncodedImageSpecificationDetector::detectImageSpecification(
   auto decompressor = decompressorProvider.decompressorFactory(
       source, folly::none, configuration);
 
-  const auto imageSpecification = decompressor->outputImageSpecification();
-
-  source.reset();
-
-  return imageSpecification;
+  return std::make_shared<ProbedDecompressor>(std::move(decompressor), source);
 }
 
 } // namespace codecs
@@ -7,10 +7,12 @@
 
 #include <spectrum/Options.h>
 #include <spectrum/codecs/EncodedImageFormatDetector.h>
+#include <spectrum/codecs/ProbedDecompressor.h>
 #include <spectrum/codecs/Repository.h>
 #include <spectrum/io/RewindableImageSource.h>
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace facebook {
@@ -55,6 +57,19 @@ class EncodedImageSpecificationDetector {
       io::RewindableImageSource& source,
       const Options& options) const;
 
+  /**
+   * Detects the input image information like `detectImageSpecification` but
+   * keeps the decompressor used for the detection, so that the headers don't
+   * need to be parsed a second time for the actual decode.
+   *
+   * @param source The image source to detect the image information from. It is
+   * left marked until the returned probe is taken or discarded.
+   * @param options The options of the current operation.
+   */
+  std::shared_ptr<ProbedDecompressor> probe(
+      io::RewindableImageSource& source,
+      const Options& options) const;
+
  private:
   const Repository& _codecRepository;
   const Configuration& _configuration;
@@ -23,6 +23,13 @@ const folly::StringPiece CompressorInputSizeTooLarge{
     "compressor_input_size_too_large"};
 } // namespace error
 
+void ICompressor::writeScanlines(
+    std::vector<std::unique_ptr<image::Scanline>> scanlines) {
+  for (auto& scanline : scanlines) {
+    writeScanline(std::move(scanline));
+  }
+}
+
 void ICompressor::enforceLossless(
     const folly::Optional<requirements::Encode>& encodeRequirement) {
   SPECTRUM_ERROR_IF(
@@ -11,6 +11,9 @@
 #include <spectrum/image/Scanline.h>
 #include <spectrum/requirements/Encode.h>
 
+#include <memory>
+#include <vector>
+
 #include <folly/Optional.h>
 #include <folly/Range.h>
 
@@ -48,6 +51,16 @@ class ICompressor {
    */
   virtual void writeScanline(std::unique_ptr<image::Scanline> scanline) = 0;
 
+  /**
+   * Writes the scanlines in the image sink in the given order. The default
+   * implementation repeatedly calls `writeScanline`; compressors that can
+   * encode several rows at once should override it.
+   *
+   * @param scanlines The scanlines to write.
+   */
+  virtual void writeScanlines(
+      std::vector<std::unique_ptr<image::Scanline>> scanlines);
+
   /**
    * Throws an exception if there's no quality defined. Lossy compressors should
    * call this function in their constructors.
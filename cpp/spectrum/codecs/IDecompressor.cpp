@@ -22,6 +22,32 @@ const folly::StringPiece DecompressorCannotSample{"decompressor_cannot_sample"};
 const folly::StringPiece DecompressorFailure{"decompressor_failure"};
 } // namespace error
 
+std::vector<std::unique_ptr<image::Scanline>> IDecompressor::readScanlines(
+    const std::size_t numberOfScanlines) {
+  std::vector<std::unique_ptr<image::Scanline>> scanlines;
+  scanlines.reserve(numberOfScanlines);
+
+  for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+    scanlines.push_back(readScanline());
+  }
+
+  return scanlines;
+}
+
+folly::Optional<image::Rect> IDecompressor::setRegionOfInterest(
+    const image::Rect& /* unused */) {
+  return folly::none;
+}
+
+folly::Optional<std::vector<std::uint8_t>>
+IDecompressor::embeddedThumbnail() {
+  return folly::none;
+}
+
+void IDecompressor::setScanlinePool(image::ScanlinePool* scanlinePool) {
+  _scanlinePool = scanlinePool;
+}
+
 void IDecompressor::_ensureNoSamplingRatio(
     const folly::Optional<image::Ratio>& samplingRatio) {
   SPECTRUM_ERROR_IF(
@@ -6,8 +6,10 @@
 #pragma once
 
 #include <spectrum/image/Scanline.h>
+#include <spectrum/image/ScanlinePool.h>
 #include <spectrum/image/Specification.h>
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -52,6 +54,46 @@ class IDecompressor {
    */
   virtual std::unique_ptr<image::Scanline> readScanline() = 0;
 
+  /**
+   * The next `numberOfScanlines` scanlines from the image source. Callers must
+   * not request more scanlines than are left in the image. The default
+   * implementation repeatedly calls `readScanline`; decompressors that can
+   * decode several rows at once should override it.
+   *
+   * @param numberOfScanlines The number of scanlines to read.
+   */
+  virtual std::vector<std::unique_ptr<image::Scanline>> readScanlines(
+      const std::size_t numberOfScanlines);
+
+  /**
+   * Restricts the scanlines read from now on to a region of the output image,
+   * e.g. so that parts that are cropped away are not decoded. Must be called
+   * before the first scanline is read. The decompressor may produce a larger
+   * region than requested (e.g. aligned to its blocks) that contains it.
+   * Afterwards, `outputImageSpecification` reports the produced region's size.
+   *
+   * @param region The region of the output image to produce.
+   * @return The region that is produced, or folly::none if the decompressor
+   * does not support regions and keeps producing the whole image.
+   */
+  virtual folly::Optional<image::Rect> setRegionOfInterest(
+      const image::Rect& region);
+
+  /**
+   * Returns the encoded bytes of a smaller version of the image embedded in
+   * its metadata (e.g. an EXIF thumbnail). Only reads the image's headers.
+   *
+   * @return The thumbnail's encoded bytes, or folly::none if the image has no
+   * embedded thumbnail or the decompressor doesn't support extracting it.
+   */
+  virtual folly::Optional<std::vector<std::uint8_t>> embeddedThumbnail();
+
+  /**
+   * Sets the pool the decompressor allocates the scanlines it reads from.
+   * Passing nullptr disables pooling.
+   */
+  void setScanlinePool(image::ScanlinePool* scanlinePool);
+
  protected:
   IDecompressor() = default;
   IDecompressor(const IDecompressor&) = delete;
@@ -65,6 +107,8 @@ class IDecompressor {
    */
   static void _ensureNoSamplingRatio(
       const folly::Optional<image::Ratio>& samplingRatio);
+
+  image::ScanlinePool* _scanlinePool{nullptr};
 };
 
 } // namespace codecs
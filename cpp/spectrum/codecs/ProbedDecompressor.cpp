@@ -0,0 +1,58 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ProbedDecompressor.h"
+
+#include <spectrum/core/SpectrumEnforce.h>
+
+namespace facebook {
+namespace spectrum {
+namespace codecs {
+
+ProbedDecompressor::ProbedDecompressor(
+    std::unique_ptr<IDecompressor> decompressor,
+    io::RewindableImageSource& source)
+    : _decompressor(std::move(decompressor)),
+      _source(source),
+      _imageSpecification(_decompressor->outputImageSpecification()) {}
+
+folly::Optional<std::vector<std::uint8_t>>
+ProbedDecompressor::embeddedThumbnail() {
+  if (_decompressor == nullptr) {
+    return folly::none;
+  }
+
+  return _decompressor->embeddedThumbnail();
+}
+
+std::unique_ptr<IDecompressor> ProbedDecompressor::take(
+    const folly::Optional<image::Ratio>& samplingRatio) {
+  if (_decompressor == nullptr) {
+    return nullptr;
+  }
+
+  if (samplingRatio.hasValue()) {
+    discard();
+    return nullptr;
+  }
+
+  // the decompressor continues reading after the headers, so the buffered
+  // bytes will never be read again
+  _source.unmark();
+  return std::move(_decompressor);
+}
+
+void ProbedDecompressor::discard() {
+  if (_decompressor == nullptr) {
+    return;
+  }
+
+  _decompressor.reset();
+  _source.reset();
+}
+
+} // namespace codecs
+} // namespace spectrum
+} // namespace facebook
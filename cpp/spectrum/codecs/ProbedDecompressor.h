@@ -0,0 +1,82 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <spectrum/codecs/IDecompressor.h>
+#include <spectrum/image/Specification.h>
+#include <spectrum/io/RewindableImageSource.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <folly/Optional.h>
+
+namespace facebook {
+namespace spectrum {
+namespace codecs {
+
+/**
+ * Holds the decompressor that was used to detect the specification of an
+ * encoded image. Its headers (and metadata markers) have already been parsed
+ * and the marked source is positioned right after them.
+ *
+ * The decompressor is either taken to decode the image without parsing the
+ * headers again, or discarded, which rewinds the source to the start of the
+ * image.
+ */
+class ProbedDecompressor {
+ public:
+  ProbedDecompressor(
+      std::unique_ptr<IDecompressor> decompressor,
+      io::RewindableImageSource& source);
+
+  ProbedDecompressor(const ProbedDecompressor&) = delete;
+  ProbedDecompressor(ProbedDecompressor&&) = default;
+
+  /**
+   * The output image specification detected by the decompressor.
+   */
+  const image::Specification& imageSpecification() const {
+    return _imageSpecification;
+  }
+
+  /**
+   * The thumbnail embedded in the image's metadata as found by the probed
+   * decompressor. Leaves the decompressor and the source untouched.
+   *
+   * @return The thumbnail's encoded bytes or folly::none if there is none (or
+   * the decompressor has already been taken / discarded).
+   */
+  folly::Optional<std::vector<std::uint8_t>> embeddedThumbnail();
+
+  /**
+   * Hands out the probed decompressor if it can produce scanlines with the
+   * given sampling ratio. The probe is performed without sampling, so any
+   * sampling ratio discards the decompressor instead.
+   *
+   * @return The decompressor or nullptr if it cannot be reused (or has already
+   * been taken / discarded).
+   */
+  std::unique_ptr<IDecompressor> take(
+      const folly::Optional<image::Ratio>& samplingRatio);
+
+  /**
+   * Drops the probed decompressor and rewinds the source to the start of the
+   * image. Does nothing if the decompressor has already been taken or
+   * discarded.
+   */
+  void discard();
+
+ private:
+  std::unique_ptr<IDecompressor> _decompressor;
+  io::RewindableImageSource& _source;
+  image::Specification _imageSpecification;
+};
+
+} // namespace codecs
+} // namespace spectrum
+} // namespace facebook
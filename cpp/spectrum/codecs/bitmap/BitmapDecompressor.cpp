@@ -29,8 +29,10 @@ std::unique_ptr<image::Scanline> BitmapDecompressor::readScanline() {
   const auto imageSpecification = _source.imageSpecification();
   SPECTRUM_ENFORCE_IF_NOT(_currentLine < imageSpecification.size.height);
 
-  auto inputScanline = std::make_unique<image::Scanline>(
-      imageSpecification.pixelSpecification, imageSpecification.size.width);
+  auto inputScanline = image::makeScanline(
+      _scanlinePool,
+      imageSpecification.pixelSpecification,
+      imageSpecification.size.width);
   const std::size_t widthBytes = imageSpecification.size.width *
       imageSpecification.pixelSpecification.bytesPerPixel;
   const std::size_t numBytesRead =
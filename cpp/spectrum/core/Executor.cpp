@@ -0,0 +1,178 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "Executor.h"
+
+#include <spectrum/core/SpectrumEnforce.h>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+
+ThreadPoolExecutor::ThreadPoolExecutor(const std::size_t numberOfThreads) {
+  SPECTRUM_ENFORCE_IF_NOT(numberOfThreads > 0);
+
+  _threads.reserve(numberOfThreads);
+  for (std::size_t i = 0; i < numberOfThreads; ++i) {
+    _threads.emplace_back([this] { _runTasks(); });
+  }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isStopping = true;
+  }
+  _condition.notify_all();
+
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+void ThreadPoolExecutor::execute(std::function<void()> task) {
+  SPECTRUM_ENFORCE_IF_NOT(task != nullptr);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    SPECTRUM_ENFORCE_IF(_isStopping);
+    _tasks.push_back(std::move(task));
+  }
+  _condition.notify_one();
+}
+
+void ThreadPoolExecutor::_runTasks() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this] { return _isStopping || !_tasks.empty(); });
+
+      // pending tasks are drained before stopping
+      if (_tasks.empty()) {
+        return;
+      }
+
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+    }
+
+    task();
+  }
+}
+
+namespace {
+// identifies the work-stealing executor and worker the current thread belongs
+// to, if any
+thread_local const WorkStealingExecutor* currentExecutor = nullptr;
+thread_local std::size_t currentWorkerIndex = 0;
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(const std::size_t numberOfThreads) {
+  SPECTRUM_ENFORCE_IF_NOT(numberOfThreads > 0);
+
+  _workers.reserve(numberOfThreads);
+  for (std::size_t i = 0; i < numberOfThreads; ++i) {
+    _workers.push_back(std::make_unique<Worker>());
+  }
+
+  _threads.reserve(numberOfThreads);
+  for (std::size_t i = 0; i < numberOfThreads; ++i) {
+    _threads.emplace_back([this, i] { _runTasks(i); });
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isStopping = true;
+  }
+  _condition.notify_all();
+
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+void WorkStealingExecutor::execute(std::function<void()> task) {
+  SPECTRUM_ENFORCE_IF_NOT(task != nullptr);
+
+  const auto workerIndex = currentExecutor == this
+      ? currentWorkerIndex
+      : _nextWorker++ % _workers.size();
+  auto& worker = *_workers[workerIndex];
+
+  {
+    // the task is counted before it can be taken, which keeps the count from
+    // underflowing
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // tasks may still schedule tasks while pending ones are drained
+    SPECTRUM_ENFORCE_IF(_isStopping && currentExecutor != this);
+    {
+      std::lock_guard<std::mutex> workerLock(worker.mutex);
+      worker.tasks.push_back(std::move(task));
+    }
+    ++_numberOfTasks;
+  }
+  _condition.notify_one();
+}
+
+bool WorkStealingExecutor::_takeTask(
+    const std::size_t workerIndex,
+    std::function<void()>& task) {
+  // the most recent own task is likely to find its data in the cache
+  {
+    auto& worker = *_workers[workerIndex];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+    }
+  }
+
+  // otherwise steal the oldest task of another worker
+  for (std::size_t i = 1; task == nullptr && i < _workers.size(); ++i) {
+    auto& worker = *_workers[(workerIndex + i) % _workers.size()];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+    }
+  }
+
+  if (task == nullptr) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  --_numberOfTasks;
+  return true;
+}
+
+void WorkStealingExecutor::_runTasks(const std::size_t workerIndex) {
+  currentExecutor = this;
+  currentWorkerIndex = workerIndex;
+
+  while (true) {
+    std::function<void()> task;
+    if (_takeTask(workerIndex, task)) {
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(
+        lock, [this] { return _isStopping || _numberOfTasks > 0; });
+
+    // pending tasks are drained before stopping
+    if (_numberOfTasks == 0) {
+      return;
+    }
+  }
+}
+
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
@@ -0,0 +1,111 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+
+/**
+ * Runs tasks on behalf of Spectrum (e.g. the stripes of a parallel resize).
+ * Implementations must be thread-safe and may run tasks on any thread and in
+ * any order. Integrators can provide their own implementation to share an
+ * existing thread pool.
+ */
+class IExecutor {
+ public:
+  virtual ~IExecutor() = default;
+
+  /**
+   * Schedules the task to be run. Must not block until the task has run.
+   */
+  virtual void execute(std::function<void()> task) = 0;
+};
+
+/**
+ * Executor running tasks on a fixed number of threads that it owns. Pending
+ * tasks are run before the destructor returns.
+ */
+class ThreadPoolExecutor : public IExecutor {
+ public:
+  explicit ThreadPoolExecutor(const std::size_t numberOfThreads);
+  ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+  ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+  ~ThreadPoolExecutor() override;
+
+  void execute(std::function<void()> task) override;
+
+  std::size_t numberOfThreads() const {
+    return _threads.size();
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::deque<std::function<void()>> _tasks;
+  bool _isStopping{false};
+  std::vector<std::thread> _threads;
+
+  void _runTasks();
+};
+
+/**
+ * Executor running tasks on a fixed number of threads that it owns. Each
+ * thread has its own queue: tasks scheduled from one of the threads are queued
+ * there and run most recent first, while idle threads steal the oldest tasks
+ * from the others. Pending tasks are run before the destructor returns.
+ */
+class WorkStealingExecutor : public IExecutor {
+ public:
+  explicit WorkStealingExecutor(const std::size_t numberOfThreads);
+  WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+  WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+  ~WorkStealingExecutor() override;
+
+  void execute(std::function<void()> task) override;
+
+  std::size_t numberOfThreads() const {
+    return _threads.size();
+  }
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+  std::vector<std::unique_ptr<Worker>> _workers;
+
+  // guards the number of queued tasks and the stopping flag which idle
+  // threads wait on
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::size_t _numberOfTasks{0};
+  bool _isStopping{false};
+
+  // workers that tasks scheduled from other threads are queued on in turn
+  std::atomic<std::size_t> _nextWorker{0};
+
+  std::vector<std::thread> _threads;
+
+  bool _takeTask(const std::size_t workerIndex, std::function<void()>& task);
+  void _runTasks(const std::size_t workerIndex);
+};
+
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
@@ -11,10 +11,22 @@ namespace core {
 
 std::unique_ptr<codecs::IDecompressor> Operation::makeDecompressor(
     const folly::Optional<image::Ratio>& samplingRatio) const {
+  if (probedDecompressor != nullptr) {
+    if (auto decompressor = probedDecompressor->take(samplingRatio)) {
+      return decompressor;
+    }
+  }
+
   return codecs.decompressorProvider.decompressorFactory(
       io.source, samplingRatio, configuration);
 }
 
+void Operation::rewindSource() const {
+  if (probedDecompressor != nullptr) {
+    probedDecompressor->discard();
+  }
+}
+
 std::unique_ptr<codecs::ICompressor> Operation::makeCompressor(
     const image::Specification& outputImageSpecification) const {
   const auto options = codecs::CompressorOptions{
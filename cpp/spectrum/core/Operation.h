@@ -9,13 +9,17 @@
 #include <spectrum/Transformations.h>
 #include <spectrum/codecs/CompressorProvider.h>
 #include <spectrum/codecs/DecompressorProvider.h>
+#include <spectrum/codecs/ProbedDecompressor.h>
 #include <spectrum/codecs/Repository.h>
 #include <spectrum/image/Metadata.h>
+#include <spectrum/image/ScanlinePool.h>
 #include <spectrum/image/Specification.h>
 #include <spectrum/io/IImageSink.h>
 #include <spectrum/io/IImageSource.h>
 #include <spectrum/requirements/Encode.h>
 
+#include <memory>
+
 #include <folly/Optional.h>
 
 namespace facebook {
@@ -49,8 +53,36 @@ struct Operation {
   Parameters parameters;
   Configuration configuration;
 
+  /**
+   * The decompressor used to detect the input image specification of an
+   * encoded source (if any). It is reused by `makeDecompressor` when possible.
+   */
+  std::shared_ptr<codecs::ProbedDecompressor> probedDecompressor{nullptr};
+
+  /**
+   * The pool scanlines are recycled through if it outlives the operation,
+   * e.g. the one of the thread running the jobs of a batch. Recipes use a
+   * pool of their own if null. Must only be used on the calling thread.
+   */
+  image::ScanlinePool* scanlinePool{nullptr};
+
+  /**
+   * What the operation predicate of the matching rule has computed for the
+   * rule's recipe (e.g. the embedded thumbnail to decode instead of the
+   * image), so that the recipe does not compute it again. Cleared before each
+   * predicate is called.
+   */
+  mutable std::shared_ptr<const void> ruleState{nullptr};
+
   std::unique_ptr<codecs::IDecompressor> makeDecompressor(
       const folly::Optional<image::Ratio>& samplingRatio) const;
+
+  /**
+   * Positions the source at the start of the encoded image. Recipes that read
+   * from `io.source` directly instead of through `makeDecompressor` must call
+   * this first.
+   */
+  void rewindSource() const;
   std::unique_ptr<codecs::ICompressor> makeCompressor(
       const image::Specification& outputImageSpecification) const;
 };
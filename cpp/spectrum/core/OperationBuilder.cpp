@@ -32,10 +32,23 @@ Operation OperationBuilder::build(
     io::RewindableImageSource& source,
     io::IImageSink& sink,
     const Options& options) const {
-  const auto inputImageSpecification =
-      _encodedImageSpecificationDetector.detectImageSpecification(
-          source, options);
-  return _build(source, sink, inputImageSpecification, options);
+  auto probedDecompressor =
+      _encodedImageSpecificationDetector.probe(source, options);
+  auto operation = _build(
+      source, sink, probedDecompressor->imageSpecification(), options);
+  operation.probedDecompressor = std::move(probedDecompressor);
+  return operation;
+}
+
+Operation OperationBuilder::build(
+    const Operation& operation,
+    io::IImageSink& sink,
+    const Options& options) const {
+  return _build(
+      operation.io.source,
+      sink,
+      operation.parameters.inputImageSpecification,
+      options);
 }
 
 Operation OperationBuilder::_build(
@@ -38,6 +38,16 @@ class OperationBuilder {
       io::IImageSink& sink,
       const Options& options) const;
 
+  /**
+   * Builds an operation on the same source as the given one, reusing its
+   * input image specification instead of probing the source again. The new
+   * operation has no probed decompressor.
+   */
+  Operation build(
+      const Operation& operation,
+      io::IImageSink& sink,
+      const Options& options) const;
+
  private:
   const Configuration& _configuration;
   const codecs::Repository& _codecRepository;
@@ -19,14 +19,17 @@ RuleMatcher::RuleMatcher(
     : _rules(std::move(rules)),
       _requirementMatchers(std::move(requirementMatchers)) {}
 
-Rule RuleMatcher::findFirstMatching(
-    const Operation::Parameters& parameters) const {
+Rule RuleMatcher::findFirstMatching(const Operation& operation) const {
   for (const auto& rule : _rules) {
-    if (_matchesRequirements(rule, parameters).success()) {
+    operation.ruleState = nullptr;
+    if (_matchesRequirements(rule, operation.parameters).success() &&
+        (!rule.operationPredicate || rule.operationPredicate(operation))) {
       return rule;
     }
   }
 
+  operation.ruleState = nullptr;
+
   SPECTRUM_ERROR(error::NoMatchingRule);
 }
 
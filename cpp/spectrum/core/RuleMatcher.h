@@ -33,10 +33,11 @@ class RuleMatcher {
           matchers::makeAll());
 
   /**
-   * Returns the first matching rule that can handle the given transcode
-   * options. Throws error::NoMatchingRule if no rule matches.
+   * Returns the first matching rule that can handle the given operation.
+   * Throws error::NoMatchingRule if no rule matches. Leaves the operation's
+   * rule state as set by the matching rule's predicate.
    */
-  Rule findFirstMatching(const Operation::Parameters& parameters) const;
+  Rule findFirstMatching(const Operation& operation) const;
 
  private:
   /**
@@ -41,17 +41,13 @@ image::Specification _calculateOutputImageSpecification(
           parameters.preserveXmpMetadata),
   };
 }
-} // namespace
 
-BaseDecision BaseDecision::calculate(const Operation& operation) {
+BaseDecision _calculate(
+    const Operation& operation,
+    const ResizeDecision& resize) {
   const auto& parameters = operation.parameters;
   const auto& codecs = operation.codecs;
 
-  const auto resize = calculateResizeDecision(
-      parameters.inputImageSpecification.size,
-      parameters.transformations.resizeRequirement,
-      codecs.decompressorProvider.supportedSamplingRatios,
-      parameters.transformations.cropRequirement);
   const auto orientation = OrientationDecision::calculate(
       parameters.transformations.rotateRequirement,
       parameters.inputImageSpecification.orientation,
@@ -66,6 +62,66 @@ BaseDecision BaseDecision::calculate(const Operation& operation) {
           _calculateOutputImageSpecification(operation, orientation, resize),
   };
 }
+} // namespace
+
+BaseDecision BaseDecision::calculate(const Operation& operation) {
+  const auto& parameters = operation.parameters;
+  return _calculate(
+      operation,
+      calculateResizeDecision(
+          parameters.inputImageSpecification.size,
+          parameters.transformations.resizeRequirement,
+          operation.codecs.decompressorProvider.supportedSamplingRatios,
+          parameters.transformations.cropRequirement));
+}
+
+BaseDecision BaseDecision::calculate(
+    const Operation& operation,
+    const folly::Optional<image::Ratio>& samplingRatio) {
+  const auto& parameters = operation.parameters;
+  if (!samplingRatio.hasValue()) {
+    return _calculate(
+        operation,
+        calculateResizeDecision(
+            parameters.inputImageSpecification.size,
+            parameters.transformations.resizeRequirement,
+            {},
+            parameters.transformations.cropRequirement));
+  }
+
+  // decide as if the sampled image was the input and record the sampling
+  const auto sizeAfterSampling = parameters.inputImageSpecification.size.scaled(
+      *samplingRatio, numeric::RoundingMode::Up);
+  auto cropRequirement = parameters.transformations.cropRequirement;
+  if (cropRequirement.hasValue()) {
+    cropRequirement = cropRequirement->scaled(*samplingRatio);
+  }
+
+  auto resize = calculateResizeDecision(
+      sizeAfterSampling,
+      parameters.transformations.resizeRequirement,
+      {},
+      cropRequirement);
+  resize.sampling(*samplingRatio, sizeAfterSampling);
+  return _calculate(operation, resize);
+}
+
+folly::Optional<image::Ratio> BaseDecision::calculateCommonSamplingRatio(
+    const std::vector<Operation>& operations) {
+  folly::Optional<image::Ratio> commonSamplingRatio;
+  for (std::size_t i = 0; i < operations.size(); ++i) {
+    const auto samplingRatio =
+        calculate(operations[i]).resize.getSamplingRatio();
+    if (!samplingRatio.hasValue() || samplingRatio->one()) {
+      return folly::none;
+    }
+
+    if (i == 0 || samplingRatio->value() > commonSamplingRatio->value()) {
+      commonSamplingRatio = samplingRatio;
+    }
+  }
+  return commonSamplingRatio;
+}
 
 } // namespace decisions
 } // namespace core
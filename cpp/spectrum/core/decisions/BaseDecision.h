@@ -12,6 +12,8 @@
 
 #include <folly/Optional.h>
 
+#include <vector>
+
 namespace facebook {
 namespace spectrum {
 namespace core {
@@ -23,6 +25,23 @@ struct BaseDecision {
   image::Specification outputImageSpecification;
 
   static BaseDecision calculate(const Operation& operation);
+
+  /**
+   * Calculates the decision for the operation's image when it is decoded with
+   * the given sampling ratio, regardless of the ratio that would be best for
+   * the operation on its own. Used when several outputs share one decode.
+   */
+  static BaseDecision calculate(
+      const Operation& operation,
+      const folly::Optional<image::Ratio>& samplingRatio);
+
+  /**
+   * The sampling ratio that is usable by all operations: the one that keeps
+   * the most detail among the ratios the operations would choose on their
+   * own. `folly::none` if any of them decodes without sampling.
+   */
+  static folly::Optional<image::Ratio> calculateCommonSamplingRatio(
+      const std::vector<Operation>& operations);
 };
 
 } // namespace decisions
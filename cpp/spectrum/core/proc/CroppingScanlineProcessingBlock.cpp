@@ -40,6 +40,7 @@ void CroppingScanlineProcessingBlock::consume(
   if (inputScanline < cropRect.minY() || inputScanline >= cropRect.maxY()) {
     // drop scanlines before and after output area
     inputScanline++;
+    image::releaseScanline(_scanlinePool, std::move(scanline));
     return;
   }
 
@@ -49,15 +50,9 @@ void CroppingScanlineProcessingBlock::consume(
     output.push(std::move(scanline));
 
   } else {
-    auto outputScanline = std::make_unique<image::Scanline>(
-        _pixelSpecification, cropRect.size.width);
-
-    // TODO t21061498: Optimize using SIMD instructions (or memcpy)
-    for (std::size_t i = 0; i < cropRect.size.width; i++) {
-      copyPixelFromTo(scanline, cropRect.topLeft.x + i, outputScanline, i);
-    }
-
-    output.push(std::move(outputScanline));
+    // the cropped scanline is a view into the input scanline
+    output.push(std::make_unique<image::Scanline>(
+        std::move(scanline), cropRect.topLeft.x, cropRect.size.width));
   }
 }
 
@@ -9,34 +9,291 @@
 #include <spectrum/core/proc/ScanlineProcessingBlock.h>
 #include <spectrum/image/Scanline.h>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace facebook {
 namespace spectrum {
 namespace core {
 namespace proc {
 
+namespace {
+
+/**
+ * Output scanlines produced at once when transposing. Together with the tile
+ * width, this bounds the memory touched by the inner loops.
+ */
+constexpr std::uint32_t BandHeight = 16;
+constexpr std::uint32_t TileWidth = 16;
+
+/**
+ * Describes where the pixels of a transposed band come from: output row `y`
+ * reads input column `column(y)` and output column `x` reads input row
+ * `row(x)`. Both mappings are either identity or reversed.
+ */
+struct Transposition {
+  const std::uint8_t* image;
+  std::size_t inputStride;
+  std::uint32_t inputWidth;
+  std::uint32_t inputHeight;
+  bool reverseRows;
+  bool reverseColumns;
+
+  std::uint32_t row(const std::uint32_t x) const {
+    return reverseRows ? inputHeight - x - 1 : x;
+  }
+
+  std::uint32_t column(const std::uint32_t y) const {
+    return reverseColumns ? inputWidth - y - 1 : y;
+  }
+};
+
+template <std::size_t BytesPerPixel>
+inline void copyPixel(const std::uint8_t* pSrc, std::uint8_t* pDst) {
+  std::memcpy(pDst, pSrc, BytesPerPixel);
+}
+
+/**
+ * Transposes output rows [bandBegin, bandBegin + bandRows.size()) and output
+ * columns [xBegin, xEnd) pixel by pixel.
+ */
+template <std::size_t BytesPerPixel>
+void transposeTile(
+    const Transposition& transposition,
+    const std::uint32_t bandBegin,
+    const std::vector<std::uint8_t*>& bandRows,
+    const std::uint32_t yBegin,
+    const std::uint32_t yEnd,
+    const std::uint32_t xBegin,
+    const std::uint32_t xEnd,
+    const std::size_t bytesPerPixel) {
+  const auto pixelSize = BytesPerPixel > 0 ? BytesPerPixel : bytesPerPixel;
+  for (auto y = yBegin; y < yEnd; ++y) {
+    const std::uint8_t* pColumn =
+        transposition.image + transposition.column(y) * pixelSize;
+    std::uint8_t* pDst = bandRows[y - bandBegin] + xBegin * pixelSize;
+    for (auto x = xBegin; x < xEnd; ++x, pDst += pixelSize) {
+      const std::uint8_t* pSrc =
+          pColumn + transposition.row(x) * transposition.inputStride;
+      if (BytesPerPixel > 0) {
+        copyPixel<BytesPerPixel>(pSrc, pDst);
+      } else {
+        std::memcpy(pDst, pSrc, pixelSize);
+      }
+    }
+  }
+}
+
+#if defined(__SSE2__)
+/**
+ * Transposes a 4x4 block of 4 byte pixels: output rows [y, y + 4) and output
+ * columns [x, x + 4).
+ */
+inline void transposeBlock4x4(
+    const Transposition& transposition,
+    const std::uint32_t bandBegin,
+    const std::vector<std::uint8_t*>& bandRows,
+    const std::uint32_t y,
+    const std::uint32_t x) {
+  // the 4 input columns are contiguous in memory
+  const std::uint32_t firstColumn =
+      std::min(transposition.column(y), transposition.column(y + 3));
+  const std::uint8_t* pColumns = transposition.image + firstColumn * 4;
+
+  const auto loadRow = [&](const std::uint32_t outputColumn) {
+    return _mm_loadu_si128((const __m128i*)(pColumns +
+        transposition.row(outputColumn) * transposition.inputStride));
+  };
+  const __m128i r0 = loadRow(x);
+  const __m128i r1 = loadRow(x + 1);
+  const __m128i r2 = loadRow(x + 2);
+  const __m128i r3 = loadRow(x + 3);
+
+  const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+  const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+  const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+  const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+  // transposed[k] holds input column firstColumn + k
+  const __m128i transposed[4] = {
+      _mm_unpacklo_epi64(t0, t1),
+      _mm_unpackhi_epi64(t0, t1),
+      _mm_unpacklo_epi64(t2, t3),
+      _mm_unpackhi_epi64(t2, t3),
+  };
+
+  for (std::uint32_t k = 0; k < 4; ++k) {
+    const auto outputRow = transposition.reverseColumns ? y + 3 - k : y + k;
+    _mm_storeu_si128(
+        (__m128i*)(bandRows[outputRow - bandBegin] + x * 4), transposed[k]);
+  }
+}
+#endif
+
+template <std::size_t BytesPerPixel>
+void transposeBand(
+    const Transposition& transposition,
+    const std::uint32_t bandBegin,
+    const std::vector<std::uint8_t*>& bandRows,
+    const std::size_t bytesPerPixel) {
+  const std::uint32_t bandEnd = bandBegin + bandRows.size();
+  const std::uint32_t outputWidth = transposition.inputHeight;
+
+  for (std::uint32_t xBegin = 0; xBegin < outputWidth; xBegin += TileWidth) {
+    const auto xEnd = std::min(xBegin + TileWidth, outputWidth);
+    auto yBegin = bandBegin;
+
+#if defined(__SSE2__)
+    if (BytesPerPixel == 4) {
+      const auto xBlocksEnd = xBegin + (xEnd - xBegin) / 4 * 4;
+      const auto yBlocksEnd = bandBegin + (bandEnd - bandBegin) / 4 * 4;
+      for (auto y = bandBegin; y < yBlocksEnd; y += 4) {
+        for (auto x = xBegin; x < xBlocksEnd; x += 4) {
+          transposeBlock4x4(transposition, bandBegin, bandRows, y, x);
+        }
+      }
+      transposeTile<BytesPerPixel>(
+          transposition,
+          bandBegin,
+          bandRows,
+          bandBegin,
+          yBlocksEnd,
+          xBlocksEnd,
+          xEnd,
+          bytesPerPixel);
+      yBegin = yBlocksEnd;
+    }
+#endif
+
+    transposeTile<BytesPerPixel>(
+        transposition,
+        bandBegin,
+        bandRows,
+        yBegin,
+        bandEnd,
+        xBegin,
+        xEnd,
+        bytesPerPixel);
+  }
+}
+
+template <std::size_t BytesPerPixel>
+void reverseRow(
+    const std::uint8_t* pSrc,
+    std::uint8_t* pDst,
+    const std::uint32_t width,
+    const std::size_t bytesPerPixel) {
+  const auto pixelSize = BytesPerPixel > 0 ? BytesPerPixel : bytesPerPixel;
+  const std::uint8_t* pSrcPixel = pSrc + (width - 1) * pixelSize;
+  for (std::uint32_t x = 0; x < width; ++x) {
+    if (BytesPerPixel > 0) {
+      copyPixel<BytesPerPixel>(pSrcPixel, pDst);
+    } else {
+      std::memcpy(pDst, pSrcPixel, pixelSize);
+    }
+    pSrcPixel -= pixelSize;
+    pDst += pixelSize;
+  }
+}
+
+void reverseRow(
+    const std::uint8_t* pSrc,
+    std::uint8_t* pDst,
+    const std::uint32_t width,
+    const std::size_t bytesPerPixel) {
+  switch (bytesPerPixel) {
+    case 1:
+      return reverseRow<1>(pSrc, pDst, width, bytesPerPixel);
+    case 3:
+      return reverseRow<3>(pSrc, pDst, width, bytesPerPixel);
+    case 4:
+      return reverseRow<4>(pSrc, pDst, width, bytesPerPixel);
+    default:
+      return reverseRow<0>(pSrc, pDst, width, bytesPerPixel);
+  }
+}
+
+} // namespace
+
 void RotationScanlineProcessingBlock::consume(
     std::unique_ptr<image::Scanline> scanline) {
   SPECTRUM_ENFORCE_IF_NOT(scanline->specification() == _pixelSpecification);
   SPECTRUM_ENFORCE_IF_NOT(scanline->width() == inputSize.width);
-  SPECTRUM_ENFORCE_IF_NOT(input.size() < inputSize.height);
-  SPECTRUM_ENFORCE_IF_NOT(outputScanline == 0);
-  input.push_back(std::move(scanline));
+  SPECTRUM_ENFORCE_IF_NOT(consumedScanlines < inputSize.height);
+
+  if (orientation == image::Orientation::UpMirrored) {
+    input.push_back(std::move(scanline));
+  } else {
+    SPECTRUM_ENFORCE_IF_NOT(outputScanline == 0);
+    if (inputImage.empty()) {
+      inputImage.resize(inputStride * inputSize.height);
+    }
+    std::memcpy(
+        inputImage.data() + consumedScanlines * inputStride,
+        scanline->data(),
+        inputStride);
+    image::releaseScanline(_scanlinePool, std::move(scanline));
+  }
+
+  consumedScanlines++;
+}
+
+void RotationScanlineProcessingBlock::produceBand() {
+  const std::uint32_t bandBegin = outputScanline + output.size();
+  const std::uint32_t bandEnd =
+      std::min(bandBegin + BandHeight, outputSize.height);
+
+  std::vector<std::uint8_t*> bandRows;
+  bandRows.reserve(bandEnd - bandBegin);
+  for (auto y = bandBegin; y < bandEnd; ++y) {
+    output.push_back(image::makeScanline(
+        _scanlinePool, _pixelSpecification, outputSize.width));
+    bandRows.push_back(output.back()->data());
+  }
+
+  const Transposition transposition{
+      inputImage.data(),
+      inputStride,
+      inputSize.width,
+      inputSize.height,
+      orientation == image::Orientation::Right ||
+          orientation == image::Orientation::RightMirrored,
+      orientation == image::Orientation::RightMirrored ||
+          orientation == image::Orientation::Left,
+  };
+
+  const std::size_t bytesPerPixel = _pixelSpecification.bytesPerPixel;
+  switch (bytesPerPixel) {
+    case 1:
+      transposeBand<1>(transposition, bandBegin, bandRows, bytesPerPixel);
+      break;
+    case 3:
+      transposeBand<3>(transposition, bandBegin, bandRows, bytesPerPixel);
+      break;
+    case 4:
+      transposeBand<4>(transposition, bandBegin, bandRows, bytesPerPixel);
+      break;
+    default:
+      transposeBand<0>(transposition, bandBegin, bandRows, bytesPerPixel);
+      break;
+  }
 }
 
 std::unique_ptr<image::Scanline> RotationScanlineProcessingBlock::produce() {
-  if ((orientation == image::Orientation::UpMirrored &&
-       static_cast<std::size_t>(outputScanline) >= input.size()) ||
-      static_cast<std::size_t>(inputSize.height) > input.size()) {
+  if (outputScanline >= outputSize.height ||
+      (orientation == image::Orientation::UpMirrored && input.empty()) ||
+      (orientation != image::Orientation::UpMirrored &&
+       consumedScanlines < inputSize.height)) {
     return nullptr;
   }
 
-  SPECTRUM_ENFORCE_IF_NOT(outputScanline < outputSize.height);
-
-  auto result =
-      std::make_unique<image::Scanline>(_pixelSpecification, outputSize.width);
+  std::unique_ptr<image::Scanline> result;
 
   switch (orientation) {
     case image::Orientation::Up:
@@ -44,65 +301,56 @@ std::unique_ptr<image::Scanline> RotationScanlineProcessingBlock::produce() {
       break;
 
     case image::Orientation::UpMirrored:
-      for (int idx = 0; idx < outputSize.width; idx++) {
-        copyPixelFromTo(
-            input[outputScanline], inputSize.width - idx - 1, result, idx);
-      }
-      break;
-
-    case image::Orientation::Right:
-      for (int idx = 0; idx < outputSize.width; idx++) {
-        copyPixelFromTo(
-            input[inputSize.height - idx - 1], outputScanline, result, idx);
-      }
-      break;
-
-    case image::Orientation::RightMirrored:
-      for (int idx = 0; idx < outputSize.width; idx++) {
-        copyPixelFromTo(
-            input[inputSize.height - idx - 1],
-            inputSize.width - outputScanline - 1,
-            result,
-            idx);
-      }
+      result = image::makeScanline(
+          _scanlinePool, _pixelSpecification, outputSize.width);
+      reverseRow(
+          input.front()->data(),
+          result->data(),
+          outputSize.width,
+          _pixelSpecification.bytesPerPixel);
+      image::releaseScanline(_scanlinePool, std::move(input.front()));
+      input.pop_front();
       break;
 
     case image::Orientation::Bottom:
-      for (int idx = 0; idx < outputSize.width; idx++) {
-        copyPixelFromTo(
-            input[inputSize.height - outputScanline - 1],
-            inputSize.width - idx - 1,
-            result,
-            idx);
-      }
+      result = image::makeScanline(
+          _scanlinePool, _pixelSpecification, outputSize.width);
+      reverseRow(
+          inputImage.data() +
+              (inputSize.height - outputScanline - 1) * inputStride,
+          result->data(),
+          outputSize.width,
+          _pixelSpecification.bytesPerPixel);
       break;
 
     case image::Orientation::BottomMirrored:
-      for (int idx = 0; idx < outputSize.width; idx++) {
-        copyPixelFromTo(
-            input[inputSize.height - outputScanline - 1], idx, result, idx);
-      }
+      result = image::makeScanline(
+          _scanlinePool, _pixelSpecification, outputSize.width);
+      std::memcpy(
+          result->data(),
+          inputImage.data() +
+              (inputSize.height - outputScanline - 1) * inputStride,
+          inputStride);
       break;
 
+    case image::Orientation::Right:
+    case image::Orientation::RightMirrored:
     case image::Orientation::Left:
-      for (int idx = 0; idx < outputSize.width; idx++) {
-        copyPixelFromTo(
-            input[idx], inputSize.width - outputScanline - 1, result, idx);
-      }
-      break;
-
     case image::Orientation::LeftMirrored:
-      for (int idx = 0; idx < outputSize.width; idx++) {
-        copyPixelFromTo(input[idx], outputScanline, result, idx);
+      if (output.empty()) {
+        produceBand();
       }
+      result = std::move(output.front());
+      output.pop_front();
       break;
   }
 
   outputScanline++;
   if (outputScanline == outputSize.height) {
     // optimization: if the last output line has been read, it is safe to
-    // forget the input scanlines
-    input.clear();
+    // forget the input image
+    inputImage.clear();
+    inputImage.shrink_to_fit();
   }
 
   return result;
@@ -10,6 +10,8 @@
 #include <spectrum/image/Geometry.h>
 #include <spectrum/image/Scanline.h>
 
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -21,7 +23,12 @@ namespace proc {
 /**
  * Reads scanlines from an input image and rotates it by either 90, 180 or 270
  * degree. Output scanlines are only produced once the entire image has been
- * consumed.
+ * consumed, except for horizontal flips which are done line by line.
+ *
+ * The consumed scanlines are copied into a contiguous image buffer and
+ * released right away. Rotations by 90 and 270 degree are produced in bands
+ * of output scanlines by transposing tiles of the buffer, which keeps the
+ * accessed memory in cache.
  */
 class RotationScanlineProcessingBlock : public ScanlineProcessingBlock {
  private:
@@ -30,8 +37,19 @@ class RotationScanlineProcessingBlock : public ScanlineProcessingBlock {
   const image::Size outputSize;
   const image::Orientation orientation;
 
-  std::vector<std::unique_ptr<image::Scanline>> input = {};
-  int outputScanline = 0;
+  const std::size_t inputStride;
+
+  // scanlines awaiting a horizontal flip
+  std::deque<std::unique_ptr<image::Scanline>> input = {};
+
+  // entire input image for all other orientations
+  std::vector<std::uint8_t> inputImage = {};
+  std::uint32_t consumedScanlines = 0;
+
+  std::deque<std::unique_ptr<image::Scanline>> output = {};
+  std::uint32_t outputScanline = 0;
+
+  void produceBand();
 
  public:
   RotationScanlineProcessingBlock(
@@ -41,7 +59,8 @@ class RotationScanlineProcessingBlock : public ScanlineProcessingBlock {
       : _pixelSpecification(pixelSpecification),
         inputSize(inputSize),
         outputSize(inputSize.oriented(orientation)),
-        orientation(orientation) {
+        orientation(orientation),
+        inputStride(inputSize.width * pixelSpecification.bytesPerPixel) {
     SPECTRUM_ENFORCE_IF_NOT(orientation != image::orientationDefault);
   }
   ~RotationScanlineProcessingBlock() override{};
@@ -11,10 +11,22 @@
 #include <spectrum/core/proc/legacy/Sharpener.h>
 #include <spectrum/image/Scanline.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <deque>
+#include <future>
 #include <memory>
+#include <queue>
+#include <tuple>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace facebook {
 namespace spectrum {
 namespace core {
@@ -74,10 +86,11 @@ void ScalingBlockImpl::consume(std::unique_ptr<image::Scanline> scanline) {
 
 class MagicKernelScalingBlockImpl : public ScalingBlockImpl {
  private:
-  // for magic kernel only
-  std::vector<std::unique_ptr<image::Scanline>> magicOutput = {};
-  void runMagicKernel();
-  std::unique_ptr<image::Scanline> produceMagicKernel();
+  const std::size_t stride;
+  std::unique_ptr<std::uint8_t[]> lineBuffer;
+  legacy::SeparableFiltersResampler magicResampler;
+  legacy::Sharpener magicSharpener;
+  std::queue<std::unique_ptr<image::Scanline>> magicOutput = {};
 
  public:
   MagicKernelScalingBlockImpl(
@@ -85,6 +98,7 @@ class MagicKernelScalingBlockImpl : public ScalingBlockImpl {
       const image::Size& inputSize,
       const image::Size& outputSize);
   ~MagicKernelScalingBlockImpl() override = default;
+  void consume(std::unique_ptr<image::Scanline> scanline) override;
   std::unique_ptr<image::Scanline> produce() override;
 };
 
@@ -92,72 +106,340 @@ MagicKernelScalingBlockImpl::MagicKernelScalingBlockImpl(
     const image::pixel::Specification& pixelSpecification,
     const image::Size& inputSize,
     const image::Size& outputSize)
-    : ScalingBlockImpl(pixelSpecification, inputSize, outputSize) {}
-
-void MagicKernelScalingBlockImpl::runMagicKernel() {
-  const auto numComponents = _pixelSpecification.bytesPerPixel;
-  const auto stride = outputSize.width * numComponents;
-
-  std::unique_ptr<std::uint8_t[]> lineBuffer(new std::uint8_t[stride]);
-
-  legacy::SeparableFiltersResampler magicResampler(
-      inputSize.width,
-      inputSize.height,
-      outputSize.width,
-      outputSize.height,
-      numComponents);
-
-  legacy::Sharpener magicSharpener(
-      outputSize.width, outputSize.height, numComponents, lineBuffer.get());
-
-  // run
-  const std::size_t inputSize = input.size();
-  while (nextLineToRelease < inputSize) {
-    // input -> resampler
-    SPECTRUM_ENFORCE_IF_NOT(input[nextLineToRelease]);
-    std::uint8_t* buffer =
-        reinterpret_cast<std::uint8_t*>(input[nextLineToRelease]->data());
-    SPECTRUM_ENFORCE_IF_NOT(buffer);
-    magicResampler.putLine(buffer);
-
-    // resampler -> sharpener
-    // elements of `pResampledRow` are Q21.11 fixed-point numbers
-    while (const int32_t* pResampledRow = magicResampler.getLine()) {
-      magicSharpener.putLine(pResampledRow);
-
-      // sharpener -> output
-      while (magicSharpener.getLine(lineBuffer.get())) {
-        auto scanline = std::make_unique<image::Scanline>(
-            _pixelSpecification, outputSize.width);
-
-        SPECTRUM_ENFORCE_IF_NOT(stride == scanline->sizeBytes());
-        SPECTRUM_ENFORCE_IF_NOT(scanline && scanline->data());
-        SPECTRUM_ENFORCE_IF_NOT(lineBuffer.get());
-
-        memcpy(scanline->data(), lineBuffer.get(), stride);
-
-        magicOutput.push_back(std::move(scanline));
+    : ScalingBlockImpl(pixelSpecification, inputSize, outputSize),
+      stride(outputSize.width * pixelSpecification.bytesPerPixel),
+      lineBuffer(new std::uint8_t[stride]),
+      magicResampler(
+          inputSize.width,
+          inputSize.height,
+          outputSize.width,
+          outputSize.height,
+          pixelSpecification.bytesPerPixel),
+      magicSharpener(
+          outputSize.width,
+          outputSize.height,
+          pixelSpecification.bytesPerPixel,
+          lineBuffer.get()) {}
+
+void MagicKernelScalingBlockImpl::consume(
+    std::unique_ptr<image::Scanline> scanline) {
+  SPECTRUM_ENFORCE_IF_NOT(scanline->specification() == _pixelSpecification);
+  SPECTRUM_ENFORCE_IF_NOT(scanline->width() == inputSize.width);
+  SPECTRUM_ENFORCE_IF_NOT(nextLineToRelease < inputSize.height);
+
+  // input -> resampler
+  magicResampler.putLine(scanline->data());
+  image::releaseScanline(_scanlinePool, std::move(scanline));
+
+  // resampler -> sharpener
+  // elements of `pResampledRow` are Q21.11 fixed-point numbers
+  while (const int32_t* pResampledRow = magicResampler.getLine()) {
+    magicSharpener.putLine(pResampledRow);
+
+    // sharpener -> output
+    while (magicSharpener.getLine(lineBuffer.get())) {
+      auto result = image::makeScanline(
+          _scanlinePool, _pixelSpecification, outputSize.width);
+      SPECTRUM_ENFORCE_IF_NOT(stride == result->sizeBytes());
+
+      memcpy(result->data(), lineBuffer.get(), stride);
+      magicOutput.push(std::move(result));
+    }
+  }
+
+  // the input scanline is freed as soon as it has been fed to the resampler
+  nextLineToRelease++;
+}
+
+std::unique_ptr<image::Scanline> MagicKernelScalingBlockImpl::produce() {
+  if (magicOutput.empty()) {
+    return nullptr;
+  }
+
+  auto result = std::move(magicOutput.front());
+  magicOutput.pop();
+  outputScanline++;
+  return result;
+}
+
+//
+// Magic kernel, stripe-parallel
+//
+
+class ParallelMagicKernelScalingBlockImpl : public ScalingBlockImpl {
+ private:
+  struct Stripe {
+    // output rows [outputBegin, outputEnd)
+    std::uint32_t outputBegin;
+    std::uint32_t outputEnd;
+    // resampled rows [resampledBegin, resampledEnd) needed for sharpening
+    std::uint32_t resampledBegin;
+    std::uint32_t resampledEnd;
+    // input rows [inputBegin, inputEnd) needed for resampling
+    std::uint32_t inputBegin;
+    std::uint32_t inputEnd;
+  };
+
+  // a stripe is scaled by whichever thread claims it first: one of the
+  // executor or the one waiting for it. the latter keeps the block from
+  // deadlocking on an executor whose threads all wait for their stripes
+  // (e.g. the one running the jobs of a batch)
+  struct StripeTask {
+    std::atomic<bool> isClaimed{false};
+    std::packaged_task<void()> task;
+
+    void runUnlessClaimed() {
+      if (!isClaimed.exchange(true)) {
+        task();
       }
     }
+  };
+
+  struct PendingStripe {
+    std::shared_ptr<StripeTask> task;
+    std::future<void> future;
+    std::vector<std::unique_ptr<image::Scanline>> output;
+  };
+
+  IExecutor& executor;
+  const std::size_t maxPendingStripes;
+  const legacy::SeparableFiltersResampler magicResampler;
+  const legacy::Sharpener magicSharpener;
+
+  std::vector<Stripe> stripes;
+  std::size_t nextStripe = 0;
+  std::deque<PendingStripe> pendingStripes = {};
+
+  // input rows [inputBase, inputBase + inputRows.size()) that are still needed
+  std::deque<std::unique_ptr<image::Scanline>> inputRows = {};
+  std::uint32_t inputBase = 0;
+
+  std::queue<std::unique_ptr<image::Scanline>> magicOutput = {};
+
+  void dispatchStripe(const Stripe& stripe);
+  void collectStripe();
+  void releaseInputRows();
+  void scaleStripe(
+      const Stripe& stripe,
+      const std::vector<const std::uint8_t*>& input,
+      const std::vector<std::uint8_t*>& output) const;
+
+ public:
+  ParallelMagicKernelScalingBlockImpl(
+      const image::pixel::Specification& pixelSpecification,
+      const image::Size& inputSize,
+      const image::Size& outputSize,
+      IExecutor& executor,
+      const std::uint32_t numberOfThreads);
+  ~ParallelMagicKernelScalingBlockImpl() override;
+  void consume(std::unique_ptr<image::Scanline> scanline) override;
+  std::unique_ptr<image::Scanline> produce() override;
+
+  /**
+   * Whether the stripes can be processed independently and yield the same
+   * result as the sequential implementation. The sharpener handles images
+   * narrower or shorter than its kernel differently.
+   */
+  static bool isSupported(const image::Size& outputSize) {
+    return outputSize.width >= 2 && outputSize.height >= 3;
+  }
+
+  std::size_t numberOfStripes() const {
+    return stripes.size();
+  }
+};
+
+ParallelMagicKernelScalingBlockImpl::ParallelMagicKernelScalingBlockImpl(
+    const image::pixel::Specification& pixelSpecification,
+    const image::Size& inputSize,
+    const image::Size& outputSize,
+    IExecutor& executor,
+    const std::uint32_t numberOfThreads)
+    : ScalingBlockImpl(pixelSpecification, inputSize, outputSize),
+      executor(executor),
+      maxPendingStripes(2 * numberOfThreads),
+      magicResampler(
+          inputSize.width,
+          inputSize.height,
+          outputSize.width,
+          outputSize.height,
+          pixelSpecification.bytesPerPixel),
+      magicSharpener(
+          outputSize.width,
+          outputSize.height,
+          pixelSpecification.bytesPerPixel,
+          nullptr) {
+  SPECTRUM_ENFORCE_IF_NOT(numberOfThreads > 0);
+  SPECTRUM_ENFORCE_IF_NOT(isSupported(outputSize));
+
+  // a few stripes per thread balance the load while keeping stripes tall
+  // enough to amortize the rows they share with their neighbours
+  static constexpr std::uint32_t MinStripeHeight = 16;
+  const std::uint32_t height = outputSize.height;
+  const std::uint32_t stripeHeight = std::max(
+      MinStripeHeight,
+      (height + 4 * numberOfThreads - 1) / (4 * numberOfThreads));
+
+  for (std::uint32_t begin = 0; begin < height; begin += stripeHeight) {
+    Stripe stripe;
+    stripe.outputBegin = begin;
+    stripe.outputEnd = std::min(begin + stripeHeight, height);
+    stripe.resampledBegin = begin > 0 ? begin - 1 : 0;
+    stripe.resampledEnd = std::min(stripe.outputEnd + 1, height);
+    std::tie(stripe.inputBegin, stripe.inputEnd) = magicResampler.srcRowRange(
+        stripe.resampledBegin, stripe.resampledEnd);
+    stripes.push_back(stripe);
+  }
+}
 
-    // free processed input
-    input[nextLineToRelease].reset();
-    nextLineToRelease++;
+ParallelMagicKernelScalingBlockImpl::~ParallelMagicKernelScalingBlockImpl() {
+  // stripes reference the input rows and this block: wait for the running ones
+  // even if the operation failed. the others are claimed so they never run
+  for (auto& pendingStripe : pendingStripes) {
+    if (pendingStripe.task->isClaimed.exchange(true)) {
+      pendingStripe.future.wait();
+    }
   }
 }
 
-std::unique_ptr<image::Scanline> MagicKernelScalingBlockImpl::produce() {
-  if (input.size() == inputSize.height) {
-    // TODO T21712884: stream scanlines instead of processing of all at once
-    runMagicKernel();
-    input.clear();
+void ParallelMagicKernelScalingBlockImpl::consume(
+    std::unique_ptr<image::Scanline> scanline) {
+  SPECTRUM_ENFORCE_IF_NOT(scanline->specification() == _pixelSpecification);
+  SPECTRUM_ENFORCE_IF_NOT(scanline->width() == inputSize.width);
+
+  const std::uint32_t numberOfInputRows = inputBase + inputRows.size() + 1;
+  SPECTRUM_ENFORCE_IF_NOT(numberOfInputRows <= inputSize.height);
+  inputRows.push_back(std::move(scanline));
+
+  // dispatch every stripe whose input is complete
+  while (nextStripe < stripes.size() &&
+         stripes[nextStripe].inputEnd <= numberOfInputRows) {
+    if (pendingStripes.size() >= maxPendingStripes) {
+      collectStripe();
+    }
+    dispatchStripe(stripes[nextStripe++]);
   }
 
-  if (outputScanline < magicOutput.size()) {
-    return std::move(magicOutput[outputScanline++]);
-  } else {
+  // collect finished stripes in order. all of them once the input is complete
+  const bool isLastInputRow = numberOfInputRows == inputSize.height;
+  while (!pendingStripes.empty() &&
+         (isLastInputRow ||
+          pendingStripes.front().future.wait_for(std::chrono::seconds(0)) ==
+              std::future_status::ready)) {
+    collectStripe();
+  }
+
+  releaseInputRows();
+}
+
+std::unique_ptr<image::Scanline>
+ParallelMagicKernelScalingBlockImpl::produce() {
+  if (magicOutput.empty()) {
     return nullptr;
   }
+
+  auto result = std::move(magicOutput.front());
+  magicOutput.pop();
+  outputScanline++;
+  return result;
+}
+
+void ParallelMagicKernelScalingBlockImpl::dispatchStripe(const Stripe& stripe) {
+  // scanlines are taken from and returned to the pool on this thread only
+  std::vector<const std::uint8_t*> input;
+  input.reserve(stripe.inputEnd - stripe.inputBegin);
+  for (auto row = stripe.inputBegin; row < stripe.inputEnd; ++row) {
+    input.push_back(inputRows[row - inputBase]->data());
+  }
+
+  PendingStripe pendingStripe;
+  std::vector<std::uint8_t*> output;
+  output.reserve(stripe.outputEnd - stripe.outputBegin);
+  for (auto row = stripe.outputBegin; row < stripe.outputEnd; ++row) {
+    pendingStripe.output.push_back(image::makeScanline(
+        _scanlinePool, _pixelSpecification, outputSize.width));
+    output.push_back(pendingStripe.output.back()->data());
+  }
+
+  auto task = std::make_shared<StripeTask>();
+  task->task = std::packaged_task<void()>(
+      [this, stripe, input = std::move(input), output = std::move(output)] {
+        scaleStripe(stripe, input, output);
+      });
+  pendingStripe.task = task;
+  pendingStripe.future = task->task.get_future();
+  pendingStripes.push_back(std::move(pendingStripe));
+  executor.execute([task] { task->runUnlessClaimed(); });
+}
+
+void ParallelMagicKernelScalingBlockImpl::collectStripe() {
+  auto pendingStripe = std::move(pendingStripes.front());
+  pendingStripes.pop_front();
+
+  // scales the stripe here if no thread of the executor has started it yet.
+  // rethrows any exception raised while scaling the stripe
+  pendingStripe.task->runUnlessClaimed();
+  pendingStripe.future.get();
+
+  for (auto& scanline : pendingStripe.output) {
+    magicOutput.push(std::move(scanline));
+  }
+}
+
+void ParallelMagicKernelScalingBlockImpl::releaseInputRows() {
+  // rows before the first input row of the oldest unfinished stripe are not
+  // needed anymore
+  std::uint32_t firstNeededRow = inputSize.height;
+  if (!pendingStripes.empty() || nextStripe < stripes.size()) {
+    const auto oldestStripe = nextStripe - pendingStripes.size();
+    firstNeededRow = stripes[oldestStripe].inputBegin;
+  }
+
+  while (!inputRows.empty() && inputBase < firstNeededRow) {
+    image::releaseScanline(_scanlinePool, std::move(inputRows.front()));
+    inputRows.pop_front();
+    inputBase++;
+  }
+}
+
+void ParallelMagicKernelScalingBlockImpl::scaleStripe(
+    const Stripe& stripe,
+    const std::vector<const std::uint8_t*>& input,
+    const std::vector<std::uint8_t*>& output) const {
+  const std::size_t pitch = magicResampler.dstPitch();
+
+  // input -> resampler (x dimension)
+  std::vector<int32_t> resampledX(input.size() * pitch);
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    magicResampler.resampleRowX(input[i], resampledX.data() + i * pitch);
+  }
+
+  // resampler (y dimension) -> sharpener (x dimension)
+  // elements of the resampled rows are Q21.11 fixed-point numbers
+  std::vector<int32_t> resampledY(pitch);
+  std::vector<int32_t> sharpenedX(
+      (stripe.resampledEnd - stripe.resampledBegin) * pitch);
+  for (auto row = stripe.resampledBegin; row < stripe.resampledEnd; ++row) {
+    magicResampler.resampleRowY(
+        row, resampledX.data(), stripe.inputBegin, resampledY.data());
+    magicSharpener.sharpenRowX(
+        resampledY.data(),
+        sharpenedX.data() + (row - stripe.resampledBegin) * pitch);
+  }
+
+  // sharpener (y dimension) -> output. edge rows are repeated
+  const auto sharpenedRow = [&](const std::uint32_t row) {
+    return sharpenedX.data() + (row - stripe.resampledBegin) * pitch;
+  };
+  const std::uint32_t lastRow = outputSize.height - 1;
+  for (auto row = stripe.outputBegin; row < stripe.outputEnd; ++row) {
+    magicSharpener.sharpenRowY(
+        sharpenedRow(row > 0 ? row - 1 : 0),
+        sharpenedRow(row),
+        sharpenedRow(std::min(row + 1, lastRow)),
+        resampledY.data(),
+        output[row - stripe.outputBegin]);
+  }
 }
 
 //
@@ -183,31 +465,138 @@ static inline float bicubicCompute(
   return a + 0.5f * deltaX * (b + deltaX * (c + deltaX * d));
 }
 
-static std::vector<std::uint8_t> bicubicComputeAndClamp(
-    const std::uint8_t numberOfComponents,
+static inline std::uint8_t bicubicComputeAndClamp(
     const float deltaX,
-    const std::uint8_t* pix0,
-    const std::uint8_t* pix1,
-    const std::uint8_t* pix2,
-    const std::uint8_t* pix3) {
-  auto result = std::vector<std::uint8_t>(numberOfComponents);
-
-  for (std::uint8_t componentOffset = 0; componentOffset < numberOfComponents;
-       componentOffset++) {
-    const auto resultValue = bicubicCompute(
-        deltaX,
-        static_cast<float>(pix0[componentOffset]),
-        static_cast<float>(pix1[componentOffset]),
-        static_cast<float>(pix2[componentOffset]),
-        static_cast<float>(pix3[componentOffset]));
-    result[componentOffset] = clamp(resultValue, 0, 255);
+    const std::uint8_t p0,
+    const std::uint8_t p1,
+    const std::uint8_t p2,
+    const std::uint8_t p3) {
+  return clamp(
+      bicubicCompute(
+          deltaX,
+          static_cast<float>(p0),
+          static_cast<float>(p1),
+          static_cast<float>(p2),
+          static_cast<float>(p3)),
+      0,
+      255);
+}
+
+#if defined(__SSE2__)
+// same operations as `bicubicCompute` on 4 lanes
+static inline __m128 bicubicCompute(
+    const __m128 deltaX,
+    const __m128 p0,
+    const __m128 p1,
+    const __m128 p2,
+    const __m128 p3) {
+  const __m128 b = _mm_sub_ps(p2, p0);
+  const __m128 c = _mm_sub_ps(
+      _mm_add_ps(
+          _mm_sub_ps(
+              _mm_mul_ps(_mm_set1_ps(2.0f), p0),
+              _mm_mul_ps(_mm_set1_ps(5.0f), p1)),
+          _mm_mul_ps(_mm_set1_ps(4.0f), p2)),
+      p3);
+  const __m128 d = _mm_sub_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_sub_ps(p1, p2)), p3), p0);
+  const __m128 halfDeltaX = _mm_mul_ps(_mm_set1_ps(0.5f), deltaX);
+  return _mm_add_ps(
+      p1,
+      _mm_mul_ps(
+          halfDeltaX,
+          _mm_add_ps(
+              b,
+              _mm_mul_ps(
+                  deltaX, _mm_add_ps(c, _mm_mul_ps(deltaX, d))))));
+}
+
+static inline __m128 bicubicLoad(const __m128i pixels, const int lane) {
+  // lane-th group of 4 bytes as floats
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i words = lane < 2 ? _mm_unpacklo_epi8(pixels, zero)
+                                 : _mm_unpackhi_epi8(pixels, zero);
+  const __m128i dwords = lane % 2 == 0 ? _mm_unpacklo_epi16(words, zero)
+                                       : _mm_unpackhi_epi16(words, zero);
+  return _mm_cvtepi32_ps(dwords);
+}
+#endif
+
+// interpolates n interleaved components of 4 rows with the same delta
+static void bicubicComputeAndClampRows(
+    const float deltaY,
+    const std::uint8_t* pRow0,
+    const std::uint8_t* pRow1,
+    const std::uint8_t* pRow2,
+    const std::uint8_t* pRow3,
+    std::uint8_t* pOut,
+    const std::size_t n) {
+  std::size_t i = 0;
+#if defined(__SSE2__)
+  const __m128 delta = _mm_set1_ps(deltaY);
+  const __m128 min = _mm_setzero_ps();
+  const __m128 max = _mm_set1_ps(255.0f);
+  for (; i + 16 <= n; i += 16) {
+    const __m128i row0 = _mm_loadu_si128((const __m128i*)(pRow0 + i));
+    const __m128i row1 = _mm_loadu_si128((const __m128i*)(pRow1 + i));
+    const __m128i row2 = _mm_loadu_si128((const __m128i*)(pRow2 + i));
+    const __m128i row3 = _mm_loadu_si128((const __m128i*)(pRow3 + i));
+
+    __m128i values[4];
+    for (int lane = 0; lane < 4; ++lane) {
+      const __m128 value = bicubicCompute(
+          delta,
+          bicubicLoad(row0, lane),
+          bicubicLoad(row1, lane),
+          bicubicLoad(row2, lane),
+          bicubicLoad(row3, lane));
+      // clamping before truncation keeps the packs below from saturating
+      values[lane] =
+          _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(value, max), min));
+    }
+
+    _mm_storeu_si128(
+        (__m128i*)(pOut + i),
+        _mm_packus_epi16(
+            _mm_packs_epi32(values[0], values[1]),
+            _mm_packs_epi32(values[2], values[3])));
+  }
+#endif
+  for (; i < n; ++i) {
+    pOut[i] = bicubicComputeAndClamp(
+        deltaY, pRow0[i], pRow1[i], pRow2[i], pRow3[i]);
   }
-  return result;
 }
 
 } // namespace
 
+/**
+ * Bicubic scaling done as a horizontal pass followed by a vertical pass. Each
+ * input row is horizontally scaled once and kept until no output row depends
+ * on it anymore. The taps of each output column are computed upfront.
+ */
 class BicubicScalingBlockImpl : public ScalingBlockImpl {
+ private:
+  static constexpr std::size_t NumberOfTaps = 4;
+
+  struct ColumnTaps {
+    // byte offsets of the 4 input pixels
+    std::array<std::size_t, NumberOfTaps> offsets;
+    float delta;
+  };
+
+  const std::size_t stride;
+  std::vector<ColumnTaps> columnTaps;
+
+  // horizontally scaled input rows, slot `row % NumberOfTaps` holds `row`
+  std::array<std::vector<std::uint8_t>, NumberOfTaps> scaledRows;
+  std::array<int, NumberOfTaps> scaledRowIndices;
+
+  const std::uint8_t* scaledRow(const int row);
+
+  template <std::uint8_t NumberOfComponents>
+  void scaleRow(const std::uint8_t* pSrc, std::uint8_t* pDst) const;
+
  public:
   BicubicScalingBlockImpl(
       const image::pixel::Specification& pixelSpecification,
@@ -221,16 +610,94 @@ BicubicScalingBlockImpl::BicubicScalingBlockImpl(
     const image::pixel::Specification& pixelSpecification,
     const image::Size& inputSize,
     const image::Size& outputSize)
-    : ScalingBlockImpl(pixelSpecification, inputSize, outputSize) {}
+    : ScalingBlockImpl(pixelSpecification, inputSize, outputSize),
+      stride(outputSize.width * pixelSpecification.bytesPerPixel) {
+  columnTaps.reserve(outputSize.width);
+  for (std::uint32_t xOffset = 0; xOffset < outputSize.width; xOffset++) {
+    const float middleX =
+        0.5f * invScalingX * static_cast<float>(xOffset + xOffset + 1);
+
+    // shift from pixel center to logical index
+    const float logicalMiddleX = clamp(middleX - 0.5f, 0.0f, inputSize.width);
+
+    const int x1 = static_cast<int>(floor(logicalMiddleX));
+    const int x2 = x1 < inputSize.width - 1 ? x1 + 1 : x1;
+    SPECTRUM_ENFORCE_IF_NOT(x1 >= 0 && x1 <= x2 && x2 < inputSize.width);
+
+    const float deltaX = (x1 == x2) ? 0 : (logicalMiddleX - x1) / (x2 - x1);
+    SPECTRUM_ENFORCE_IF_NOT(deltaX >= 0.0f && deltaX <= 1.0f);
+
+    const int x0 = x1 == 0 ? 0 : x1 - 1;
+    const int x3 = x2 < inputSize.width - 1 ? x2 + 1 : x2;
+    SPECTRUM_ENFORCE_IF_NOT(x0 >= 0 && x0 <= x3 && x3 < inputSize.width);
+
+    const std::size_t bytesPerPixel = pixelSpecification.bytesPerPixel;
+    columnTaps.push_back(ColumnTaps{
+        {{x0 * bytesPerPixel,
+          x1 * bytesPerPixel,
+          x2 * bytesPerPixel,
+          x3 * bytesPerPixel}},
+        deltaX});
+  }
+
+  // padding bytes of the scaled rows stay zero
+  for (auto& row : scaledRows) {
+    row.resize(stride);
+  }
+  scaledRowIndices.fill(-1);
+}
+
+template <std::uint8_t NumberOfComponents>
+void BicubicScalingBlockImpl::scaleRow(
+    const std::uint8_t* pSrc,
+    std::uint8_t* pDst) const {
+  const auto numberOfComponents = NumberOfComponents > 0
+      ? NumberOfComponents
+      : _pixelSpecification.numberOfComponents();
+  const std::size_t bytesPerPixel = _pixelSpecification.bytesPerPixel;
+
+  for (const auto& taps : columnTaps) {
+    const std::uint8_t* pPixel0 = pSrc + taps.offsets[0];
+    const std::uint8_t* pPixel1 = pSrc + taps.offsets[1];
+    const std::uint8_t* pPixel2 = pSrc + taps.offsets[2];
+    const std::uint8_t* pPixel3 = pSrc + taps.offsets[3];
+    for (std::uint8_t c = 0; c < numberOfComponents; ++c) {
+      pDst[c] = bicubicComputeAndClamp(
+          taps.delta, pPixel0[c], pPixel1[c], pPixel2[c], pPixel3[c]);
+    }
+    pDst += bytesPerPixel;
+  }
+}
+
+const std::uint8_t* BicubicScalingBlockImpl::scaledRow(const int row) {
+  const auto slot = row % NumberOfTaps;
+  auto* pDst = scaledRows[slot].data();
+  if (scaledRowIndices[slot] != row) {
+    const auto* pSrc = input[row]->data();
+    switch (_pixelSpecification.numberOfComponents()) {
+      case 1:
+        scaleRow<1>(pSrc, pDst);
+        break;
+      case 3:
+        scaleRow<3>(pSrc, pDst);
+        break;
+      case 4:
+        scaleRow<4>(pSrc, pDst);
+        break;
+      default:
+        scaleRow<0>(pSrc, pDst);
+        break;
+    }
+    scaledRowIndices[slot] = row;
+  }
+  return pDst;
+}
 
 std::unique_ptr<image::Scanline> BicubicScalingBlockImpl::produce() {
   if (outputScanline == outputSize.height) {
     return nullptr;
   }
 
-  auto result =
-      std::make_unique<image::Scanline>(_pixelSpecification, outputSize.width);
-
   const float middleY = 0.5f * invScalingY *
       static_cast<float>(outputScanline + outputScanline + 1);
 
@@ -252,79 +719,26 @@ std::unique_ptr<image::Scanline> BicubicScalingBlockImpl::produce() {
     return nullptr;
   }
 
-  for (int xOffset = 0; xOffset < outputSize.width; xOffset++) {
-    const float middleX =
-        0.5f * invScalingX * static_cast<float>(xOffset + xOffset + 1);
-
-    // shift from pixel center to logical index
-    const float logicalMiddleX = clamp(middleX - 0.5f, 0.0f, inputSize.width);
-
-    const int x1 = static_cast<int>(floor(logicalMiddleX));
-    const int x2 = x1 < inputSize.width - 1 ? x1 + 1 : x1;
-    SPECTRUM_ENFORCE_IF_NOT(x1 >= 0 && x1 <= x2 && x2 < inputSize.width);
-
-    const float deltaX = (x1 == x2) ? 0 : (logicalMiddleX - x1) / (x2 - x1);
-    SPECTRUM_ENFORCE_IF_NOT(deltaX >= 0.0f && deltaX <= 1.0f);
-
-    const int x0 = x1 == 0 ? 0 : x1 - 1;
-    const int x3 = x2 < inputSize.width - 1 ? x2 + 1 : x2;
-    SPECTRUM_ENFORCE_IF_NOT(x0 >= 0 && x0 <= x3 && x3 < inputSize.width);
-
-    const auto numberOfComponents = _pixelSpecification.numberOfComponents();
-    const auto bicubicSum0 = bicubicComputeAndClamp(
-        numberOfComponents,
-        deltaX,
-        (*input[y0]).dataAtPixel(x0),
-        (*input[y0]).dataAtPixel(x1),
-        (*input[y0]).dataAtPixel(x2),
-        (*input[y0]).dataAtPixel(x3));
-
-    const auto bicubicSum1 = bicubicComputeAndClamp(
-        numberOfComponents,
-        deltaX,
-        (*input[y1]).dataAtPixel(x0),
-        (*input[y1]).dataAtPixel(x1),
-        (*input[y1]).dataAtPixel(x2),
-        (*input[y1]).dataAtPixel(x3));
-
-    const auto bicubicSum2 = bicubicComputeAndClamp(
-        numberOfComponents,
-        deltaX,
-        (*input[y2]).dataAtPixel(x0),
-        (*input[y2]).dataAtPixel(x1),
-        (*input[y2]).dataAtPixel(x2),
-        (*input[y2]).dataAtPixel(x3));
-
-    const auto bicubicSum3 = bicubicComputeAndClamp(
-        numberOfComponents,
-        deltaX,
-        (*input[y3]).dataAtPixel(x0),
-        (*input[y3]).dataAtPixel(x1),
-        (*input[y3]).dataAtPixel(x2),
-        (*input[y3]).dataAtPixel(x3));
-
-    const auto pxl = bicubicComputeAndClamp(
-        numberOfComponents,
-        deltaY,
-        bicubicSum0.data(),
-        bicubicSum1.data(),
-        bicubicSum2.data(),
-        bicubicSum3.data());
-
-    auto dst = result->dataAtPixel(xOffset);
-    for (std::uint8_t componentOffset = 0; componentOffset < numberOfComponents;
-         componentOffset++) {
-      *(dst + componentOffset) = pxl[componentOffset];
-    }
-  }
-
   // free scanlines that will not be touched again
   for (int i = nextLineToRelease; i < y0; i++) {
     SPECTRUM_ENFORCE_IF(input[i] == nullptr);
-    input[i].reset();
+    image::releaseScanline(_scanlinePool, std::move(input[i]));
   }
   nextLineToRelease = y0;
 
+  auto result = image::makeScanline(
+      _scanlinePool, _pixelSpecification, outputSize.width);
+  SPECTRUM_ENFORCE_IF_NOT(stride == result->sizeBytes());
+
+  bicubicComputeAndClampRows(
+      deltaY,
+      scaledRow(y0),
+      scaledRow(y1),
+      scaledRow(y2),
+      scaledRow(y3),
+      result->data(),
+      stride);
+
   ++outputScanline;
   return result;
 }
@@ -367,7 +781,9 @@ ScalingScanlineProcessingBlock::ScalingScanlineProcessingBlock(
     const image::pixel::Specification& pixelSpecification,
     const image::Size& inputSize,
     const image::Size& outputSize,
-    const Configuration::General::SamplingMethod samplingMethod)
+    const Configuration::General::SamplingMethod samplingMethod,
+    IExecutor* executor,
+    const std::uint32_t numberOfThreads)
     : _pixelSpecification(pixelSpecification) {
   if (inputSize == outputSize) {
     delegate = std::make_unique<NoOpScalingBlockImpl>(
@@ -375,6 +791,22 @@ ScalingScanlineProcessingBlock::ScalingScanlineProcessingBlock(
   } else {
     switch (samplingMethod) {
       case Configuration::General::SamplingMethod::MagicKernel:
+        if (executor != nullptr && numberOfThreads > 1 &&
+            ParallelMagicKernelScalingBlockImpl::isSupported(outputSize)) {
+          auto parallelDelegate =
+              std::make_unique<ParallelMagicKernelScalingBlockImpl>(
+                  pixelSpecification,
+                  inputSize,
+                  outputSize,
+                  *executor,
+                  numberOfThreads);
+
+          // a single stripe would only add the scheduling overhead
+          if (parallelDelegate->numberOfStripes() > 1) {
+            delegate = std::move(parallelDelegate);
+            break;
+          }
+        }
         delegate = std::make_unique<MagicKernelScalingBlockImpl>(
             pixelSpecification, inputSize, outputSize);
         break;
@@ -401,6 +833,12 @@ std::unique_ptr<image::Scanline> ScalingScanlineProcessingBlock::produce() {
   return delegate->produce();
 }
 
+void ScalingScanlineProcessingBlock::setScanlinePool(
+    image::ScanlinePool* scanlinePool) {
+  ScanlineProcessingBlock::setScanlinePool(scanlinePool);
+  delegate->setScanlinePool(scanlinePool);
+}
+
 } // namespace proc
 } // namespace core
 } // namespace spectrum
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <spectrum/Configuration.h>
+#include <spectrum/core/Executor.h>
 #include <spectrum/core/SpectrumEnforce.h>
 #include <spectrum/core/proc/ScanlineProcessingBlock.h>
 #include <spectrum/core/proc/legacy/SeparableFiltersResampler.h>
@@ -29,6 +30,10 @@ class ScalingBlockImpl;
 /**
  * Processing block that is able to down-scale and up-scale an input image. The
  * consumed scanlines are freed as soon as possible.
+ *
+ * If an executor and more than one thread are provided, the magic kernel
+ * scales horizontal stripes of the output concurrently. Stripes are produced
+ * in order and the output is identical to the sequential one.
  */
 class ScalingScanlineProcessingBlock : public ScanlineProcessingBlock {
  private:
@@ -40,11 +45,14 @@ class ScalingScanlineProcessingBlock : public ScanlineProcessingBlock {
       const image::pixel::Specification& pixelSpecification,
       const image::Size& inputSize,
       const image::Size& outputSize,
-      const Configuration::General::SamplingMethod samplingMethod);
+      const Configuration::General::SamplingMethod samplingMethod,
+      IExecutor* executor = nullptr,
+      const std::uint32_t numberOfThreads = 1);
   ~ScalingScanlineProcessingBlock() override;
 
   void consume(std::unique_ptr<image::Scanline> scanline) override;
   std::unique_ptr<image::Scanline> produce() override;
+  void setScanlinePool(image::ScanlinePool* scanlinePool) override;
 };
 
 } // namespace proc
@@ -0,0 +1,105 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ScanlineBatchQueue.h"
+
+#include <spectrum/core/SpectrumEnforce.h>
+
+#include <thread>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+
+namespace {
+// number of times a waiting side yields before going to sleep
+constexpr std::size_t NumberOfSpins = 64;
+} // namespace
+
+ScanlineBatchQueue::ScanlineBatchQueue(const std::size_t capacity)
+    : _slots(capacity + 1) {
+  SPECTRUM_ENFORCE_IF_NOT(capacity > 0);
+}
+
+bool ScanlineBatchQueue::push(Scanlines batch) {
+  const auto tail = _tail.load(std::memory_order_relaxed);
+  const auto nextTail = _next(tail);
+  _waitUntil([&] {
+    return _isCancelled.load() || nextTail != _head.load();
+  });
+
+  if (_isCancelled.load()) {
+    return false;
+  }
+
+  _slots[tail] = std::move(batch);
+  _tail.store(nextTail);
+  _notify();
+  return true;
+}
+
+bool ScanlineBatchQueue::pop(Scanlines& batch) {
+  const auto head = _head.load(std::memory_order_relaxed);
+  _waitUntil([&] {
+    return _isCancelled.load() || head != _tail.load() || _isClosed.load();
+  });
+
+  // batches pushed before closing are still handed out
+  if (_isCancelled.load() || head == _tail.load()) {
+    return false;
+  }
+
+  batch = std::move(_slots[head]);
+  _slots[head] = Scanlines{};
+  _head.store(_next(head));
+  _notify();
+  return true;
+}
+
+void ScanlineBatchQueue::close() {
+  _isClosed.store(true);
+  _notify();
+}
+
+void ScanlineBatchQueue::cancel() {
+  _isCancelled.store(true);
+  _notify();
+}
+
+std::size_t ScanlineBatchQueue::_next(const std::size_t index) const {
+  return index + 1 == _slots.size() ? 0 : index + 1;
+}
+
+template <typename Predicate>
+void ScanlineBatchQueue::_waitUntil(Predicate&& predicate) {
+  for (std::size_t i = 0; i < NumberOfSpins; ++i) {
+    if (predicate()) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+
+  // the sleeper is registered before checking the predicate again, so a
+  // notifying side either sees it or has already made the predicate true
+  std::unique_lock<std::mutex> lock(_mutex);
+  ++_numberOfSleepers;
+  _condition.wait(lock, predicate);
+  --_numberOfSleepers;
+}
+
+void ScanlineBatchQueue::_notify() {
+  if (_numberOfSleepers.load() > 0) {
+    // synchronizes with a sleeper that is between checking the predicate and
+    // waiting on the condition
+    { std::lock_guard<std::mutex> lock(_mutex); }
+    _condition.notify_all();
+  }
+}
+
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
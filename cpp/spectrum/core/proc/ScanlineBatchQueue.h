@@ -0,0 +1,95 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <spectrum/image/Scanline.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+
+/**
+ * Bounded queue handing batches of scanlines from exactly one producer thread
+ * to exactly one consumer thread in order.
+ *
+ * Pushing and popping are lock-free ring buffer operations. A side that has to
+ * wait for the other (i.e. the queue is full or empty) spins briefly and then
+ * sleeps until it is notified.
+ */
+class ScanlineBatchQueue {
+ public:
+  using Scanlines = std::vector<std::unique_ptr<image::Scanline>>;
+
+  /**
+   * @param capacity The maximum number of batches in the queue.
+   */
+  explicit ScanlineBatchQueue(const std::size_t capacity);
+
+  ScanlineBatchQueue(const ScanlineBatchQueue&) = delete;
+  ScanlineBatchQueue& operator=(const ScanlineBatchQueue&) = delete;
+
+  /**
+   * Appends a batch, waiting while the queue is full. Producer only.
+   *
+   * @return false if the queue has been cancelled and the batch was dropped.
+   */
+  bool push(Scanlines batch);
+
+  /**
+   * Removes the oldest batch, waiting while the queue is empty. Consumer only.
+   *
+   * @return false if the queue has been cancelled, or closed and all batches
+   * have been popped. `batch` is left untouched then.
+   */
+  bool pop(Scanlines& batch);
+
+  /**
+   * Signals that no more batches will be pushed. Producer only.
+   */
+  void close();
+
+  /**
+   * Makes all pending and future pushes and pops fail, e.g. because the other
+   * side has failed. Can be called from any thread.
+   */
+  void cancel();
+
+  bool isCancelled() const {
+    return _isCancelled.load();
+  }
+
+ private:
+  // one slot is always left empty to tell a full queue from an empty one
+  std::vector<Scanlines> _slots;
+  std::atomic<std::size_t> _head{0};
+  std::atomic<std::size_t> _tail{0};
+  std::atomic<bool> _isClosed{false};
+  std::atomic<bool> _isCancelled{false};
+
+  // only used for sleeping, never on the fast path
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::atomic<std::size_t> _numberOfSleepers{0};
+
+  std::size_t _next(const std::size_t index) const;
+
+  template <typename Predicate>
+  void _waitUntil(Predicate&& predicate);
+  void _notify();
+};
+
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
@@ -9,6 +9,22 @@
 #include <spectrum/image/Pixel.h>
 #include <spectrum/image/Scanline.h>
 
+#include <array>
+#include <cstring>
+#include <vector>
+
+// x86 row conversions are compiled for their instruction set and selected at
+// runtime
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SPECTRUM_SCANLINE_CONVERSION_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SPECTRUM_SCANLINE_CONVERSION_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace facebook {
 namespace spectrum {
 namespace core {
@@ -129,6 +145,477 @@ rgbaToGray(const Pixel_4& in, Pixel_1& out, const image::Color& background) {
 
 } // namespace convertwithbackground
 
+namespace rows {
+
+// the scalar rows reuse the pixel conversions. as each pixel is read before
+// it is written, they convert in place too
+template <
+    typename PI,
+    typename PO,
+    void _pixelConversionFunction(const PI&, PO&, const image::Color&)>
+void convertRow(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  for (std::size_t i = 0; i < width; ++i) {
+    _pixelConversionFunction(
+        reinterpret_cast<const PI*>(input)[i],
+        reinterpret_cast<PO*>(output)[i],
+        background);
+  }
+}
+
+// the vectorized rows convert blocks of pixels and leave the remainder to the
+// scalar rows. all of them are bit-exact with the scalar rows
+
+#if SPECTRUM_SCANLINE_CONVERSION_X86
+__attribute__((target("ssse3"))) void grayToRgbSsse3(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  const auto mask0 =
+      _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+  const auto mask1 =
+      _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+  const auto mask2 = _mm_setr_epi8(
+      10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto gray =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+    auto* out = reinterpret_cast<__m128i*>(output + 3 * i);
+    _mm_storeu_si128(out, _mm_shuffle_epi8(gray, mask0));
+    _mm_storeu_si128(out + 1, _mm_shuffle_epi8(gray, mask1));
+    _mm_storeu_si128(out + 2, _mm_shuffle_epi8(gray, mask2));
+  }
+
+  convertRow<Pixel_1, Pixel_3, convert::grayToRgb>(
+      input + i, output + 3 * i, width - i, background);
+}
+
+template <bool AlphaFirst>
+__attribute__((target("ssse3"))) void grayToRgbxSsse3(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  const auto opaque = _mm_set1_epi8(-1);
+
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto gray =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+    const auto grayGrayLow = _mm_unpacklo_epi8(gray, gray);
+    const auto grayGrayHigh = _mm_unpackhi_epi8(gray, gray);
+    // pairs of gray and alpha in the order of the output
+    const auto grayAlphaLow = AlphaFirst ? _mm_unpacklo_epi8(opaque, gray)
+                                         : _mm_unpacklo_epi8(gray, opaque);
+    const auto grayAlphaHigh = AlphaFirst ? _mm_unpackhi_epi8(opaque, gray)
+                                          : _mm_unpackhi_epi8(gray, opaque);
+    const auto first = AlphaFirst ? grayAlphaLow : grayGrayLow;
+    const auto second = AlphaFirst ? grayGrayLow : grayAlphaLow;
+    const auto third = AlphaFirst ? grayAlphaHigh : grayGrayHigh;
+    const auto fourth = AlphaFirst ? grayGrayHigh : grayAlphaHigh;
+
+    auto* out = reinterpret_cast<__m128i*>(output + 4 * i);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(first, second));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(first, second));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(third, fourth));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(third, fourth));
+  }
+
+  if (AlphaFirst) {
+    convertRow<Pixel_1, Pixel_4, convert::grayToArgb>(
+        input + i, output + 4 * i, width - i, background);
+  } else {
+    convertRow<Pixel_1, Pixel_4, convert::grayToRgba>(
+        input + i, output + 4 * i, width - i, background);
+  }
+}
+
+__attribute__((target("ssse3"))) void rgbToGraySsse3(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  // gathers the red, green and blue components of 16 pixels from the three
+  // vectors spanning them
+  const __m128i masks[3][3] = {
+      {_mm_setr_epi8(
+           0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+       _mm_setr_epi8(
+           -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1),
+       _mm_setr_epi8(
+           -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)},
+      {_mm_setr_epi8(
+           1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+       _mm_setr_epi8(
+           -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1),
+       _mm_setr_epi8(
+           -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)},
+      {_mm_setr_epi8(
+           2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1),
+       _mm_setr_epi8(
+           -1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1),
+       _mm_setr_epi8(
+           -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)},
+  };
+  const auto zero = _mm_setzero_si128();
+  // x / 3 == (x * 0xAAAB) >> 17 for all sums of three components
+  const auto oneThird = _mm_set1_epi16(static_cast<short>(0xAAAB));
+
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto* in = reinterpret_cast<const __m128i*>(input + 3 * i);
+    const __m128i vectors[3] = {
+        _mm_loadu_si128(in), _mm_loadu_si128(in + 1), _mm_loadu_si128(in + 2)};
+
+    auto sumLow = zero;
+    auto sumHigh = zero;
+    for (std::size_t c = 0; c < 3; ++c) {
+      const auto component = _mm_or_si128(
+          _mm_or_si128(
+              _mm_shuffle_epi8(vectors[0], masks[c][0]),
+              _mm_shuffle_epi8(vectors[1], masks[c][1])),
+          _mm_shuffle_epi8(vectors[2], masks[c][2]));
+      sumLow = _mm_add_epi16(sumLow, _mm_unpacklo_epi8(component, zero));
+      sumHigh = _mm_add_epi16(sumHigh, _mm_unpackhi_epi8(component, zero));
+    }
+
+    const auto averageLow =
+        _mm_srli_epi16(_mm_mulhi_epu16(sumLow, oneThird), 1);
+    const auto averageHigh =
+        _mm_srli_epi16(_mm_mulhi_epu16(sumHigh, oneThird), 1);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(output + i),
+        _mm_packus_epi16(averageLow, averageHigh));
+  }
+
+  convertRow<Pixel_3, Pixel_1, convert::rgbToGray>(
+      input + 3 * i, output + i, width - i, background);
+}
+
+template <bool AlphaFirst>
+__attribute__((target("ssse3"))) void rgbToRgbxSsse3(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  const auto mask = AlphaFirst
+      ? _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11)
+      : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const auto alpha = AlphaFirst ? _mm_set1_epi32(0x000000FF)
+                                : _mm_set1_epi32(0xFF000000);
+
+  // loads 16 bytes for 4 pixels, hence stops 2 pixels before the end
+  std::size_t i = 0;
+  for (; i + 6 <= width; i += 4) {
+    const auto rgb =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 3 * i));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(output + 4 * i),
+        _mm_or_si128(_mm_shuffle_epi8(rgb, mask), alpha));
+  }
+
+  if (AlphaFirst) {
+    convertRow<Pixel_3, Pixel_4, convert::rgbToArgb>(
+        input + 3 * i, output + 4 * i, width - i, background);
+  } else {
+    convertRow<Pixel_3, Pixel_4, convert::rgbToRgba>(
+        input + 3 * i, output + 4 * i, width - i, background);
+  }
+}
+
+template <bool ToAlphaFirst>
+__attribute__((target("ssse3"))) void swapAlphaSsse3(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  const auto mask = ToAlphaFirst
+      ? _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14)
+      : _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+
+  std::size_t i = 0;
+  for (; i + 4 <= width; i += 4) {
+    const auto pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 4 * i));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(output + 4 * i),
+        _mm_shuffle_epi8(pixels, mask));
+  }
+
+  if (ToAlphaFirst) {
+    convertRow<Pixel_4, Pixel_4, convert::rgbaToArgb>(
+        input + 4 * i, output + 4 * i, width - i, background);
+  } else {
+    convertRow<Pixel_4, Pixel_4, convert::argbToRgba>(
+        input + 4 * i, output + 4 * i, width - i, background);
+  }
+}
+
+// blends one pixel per vector with the same float operations as
+// `blendPixelWithBackgroundToRgb`. without fused multiply-adds, the results
+// are identical for all alpha values
+template <bool AlphaFirst>
+__attribute__((target("ssse3"))) void blendRgbxToRgbSsse3(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  constexpr int alphaIndex = AlphaFirst ? 0 : 3;
+  const auto backgroundVector = AlphaFirst
+      ? _mm_setr_ps(0.0f, background.red, background.green, background.blue)
+      : _mm_setr_ps(background.red, background.green, background.blue, 0.0f);
+  const auto dropAlpha = AlphaFirst
+      ? _mm_setr_epi8(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1)
+      : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  const auto fullAlphaVector = _mm_set1_ps(static_cast<float>(fullAlpha));
+  const auto one = _mm_set1_ps(1.0f);
+  const auto zero = _mm_setzero_si128();
+
+  // writes 16 bytes for 4 pixels, hence stops 2 pixels before the end
+  std::size_t i = 0;
+  for (; i + 6 <= width; i += 4) {
+    const auto pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 4 * i));
+    const auto low = _mm_unpacklo_epi8(pixels, zero);
+    const auto high = _mm_unpackhi_epi8(pixels, zero);
+    const __m128i components[4] = {
+        _mm_unpacklo_epi16(low, zero),
+        _mm_unpackhi_epi16(low, zero),
+        _mm_unpacklo_epi16(high, zero),
+        _mm_unpackhi_epi16(high, zero)};
+
+    __m128i blended[4];
+    for (std::size_t p = 0; p < 4; ++p) {
+      const auto pixel = _mm_cvtepi32_ps(components[p]);
+      const auto alpha = _mm_div_ps(
+          _mm_shuffle_ps(
+              pixel,
+              pixel,
+              _MM_SHUFFLE(alphaIndex, alphaIndex, alphaIndex, alphaIndex)),
+          fullAlphaVector);
+      const auto inverseAlpha = _mm_sub_ps(one, alpha);
+      blended[p] = _mm_cvttps_epi32(_mm_add_ps(
+          _mm_mul_ps(pixel, alpha),
+          _mm_mul_ps(backgroundVector, inverseAlpha)));
+    }
+
+    const auto packed = _mm_packus_epi16(
+        _mm_packs_epi32(blended[0], blended[1]),
+        _mm_packs_epi32(blended[2], blended[3]));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(output + 3 * i),
+        _mm_shuffle_epi8(packed, dropAlpha));
+  }
+
+  if (AlphaFirst) {
+    convertRow<Pixel_4, Pixel_3, convertwithbackground::argbToRgb>(
+        input + 4 * i, output + 3 * i, width - i, background);
+  } else {
+    convertRow<Pixel_4, Pixel_3, convertwithbackground::rgbaToRgb>(
+        input + 4 * i, output + 3 * i, width - i, background);
+  }
+}
+#endif // SPECTRUM_SCANLINE_CONVERSION_X86
+
+#if SPECTRUM_SCANLINE_CONVERSION_NEON
+void grayToRgbNeon(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto gray = vld1q_u8(input + i);
+    vst3q_u8(output + 3 * i, uint8x16x3_t{{gray, gray, gray}});
+  }
+
+  convertRow<Pixel_1, Pixel_3, convert::grayToRgb>(
+      input + i, output + 3 * i, width - i, background);
+}
+
+template <bool AlphaFirst>
+void grayToRgbxNeon(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  const auto opaque = vdupq_n_u8(fullAlpha);
+
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto gray = vld1q_u8(input + i);
+    vst4q_u8(
+        output + 4 * i,
+        AlphaFirst ? uint8x16x4_t{{opaque, gray, gray, gray}}
+                   : uint8x16x4_t{{gray, gray, gray, opaque}});
+  }
+
+  if (AlphaFirst) {
+    convertRow<Pixel_1, Pixel_4, convert::grayToArgb>(
+        input + i, output + 4 * i, width - i, background);
+  } else {
+    convertRow<Pixel_1, Pixel_4, convert::grayToRgba>(
+        input + i, output + 4 * i, width - i, background);
+  }
+}
+
+void rgbToGrayNeon(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  // x / 3 == (x * 0xAAAB) >> 17 for all sums of three components
+  const auto divideByThree = [](const uint16x8_t sum) {
+    const auto low = vshrn_n_u32(vmull_n_u16(vget_low_u16(sum), 0xAAAB), 16);
+    const auto high = vshrn_n_u32(vmull_n_u16(vget_high_u16(sum), 0xAAAB), 16);
+    return vmovn_u16(vshrq_n_u16(vcombine_u16(low, high), 1));
+  };
+
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto rgb = vld3q_u8(input + 3 * i);
+    const auto sumLow = vaddw_u8(
+        vaddl_u8(vget_low_u8(rgb.val[0]), vget_low_u8(rgb.val[1])),
+        vget_low_u8(rgb.val[2]));
+    const auto sumHigh = vaddw_u8(
+        vaddl_u8(vget_high_u8(rgb.val[0]), vget_high_u8(rgb.val[1])),
+        vget_high_u8(rgb.val[2]));
+    vst1q_u8(
+        output + i,
+        vcombine_u8(divideByThree(sumLow), divideByThree(sumHigh)));
+  }
+
+  convertRow<Pixel_3, Pixel_1, convert::rgbToGray>(
+      input + 3 * i, output + i, width - i, background);
+}
+
+template <bool AlphaFirst>
+void rgbToRgbxNeon(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  const auto opaque = vdupq_n_u8(fullAlpha);
+
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto rgb = vld3q_u8(input + 3 * i);
+    vst4q_u8(
+        output + 4 * i,
+        AlphaFirst
+            ? uint8x16x4_t{{opaque, rgb.val[0], rgb.val[1], rgb.val[2]}}
+            : uint8x16x4_t{{rgb.val[0], rgb.val[1], rgb.val[2], opaque}});
+  }
+
+  if (AlphaFirst) {
+    convertRow<Pixel_3, Pixel_4, convert::rgbToArgb>(
+        input + 3 * i, output + 4 * i, width - i, background);
+  } else {
+    convertRow<Pixel_3, Pixel_4, convert::rgbToRgba>(
+        input + 3 * i, output + 4 * i, width - i, background);
+  }
+}
+
+template <bool ToAlphaFirst>
+void swapAlphaNeon(
+    const std::uint8_t* input,
+    std::uint8_t* output,
+    const std::size_t width,
+    const image::Color& background) {
+  std::size_t i = 0;
+  for (; i + 16 <= width; i += 16) {
+    const auto pixels = vld4q_u8(input + 4 * i);
+    vst4q_u8(
+        output + 4 * i,
+        ToAlphaFirst
+            ? uint8x16x4_t{{pixels.val[3],
+                            pixels.val[0],
+                            pixels.val[1],
+                            pixels.val[2]}}
+            : uint8x16x4_t{{pixels.val[1],
+                            pixels.val[2],
+                            pixels.val[3],
+                            pixels.val[0]}});
+  }
+
+  if (ToAlphaFirst) {
+    convertRow<Pixel_4, Pixel_4, convert::rgbaToArgb>(
+        input + 4 * i, output + 4 * i, width - i, background);
+  } else {
+    convertRow<Pixel_4, Pixel_4, convert::argbToRgba>(
+        input + 4 * i, output + 4 * i, width - i, background);
+  }
+}
+#endif // SPECTRUM_SCANLINE_CONVERSION_NEON
+
+struct RowConversion {
+  image::pixel::Specification inputSpecification;
+  image::pixel::Specification outputSpecification;
+  RowScanlineConverter::RowConversionFunction function;
+};
+
+/**
+ * Returns the vectorized row conversion between the given specifications if
+ * there is one for the running cpu.
+ */
+RowScanlineConverter::RowConversionFunction vectorizedRowConversionFunction(
+    const image::pixel::Specification& inputSpecification,
+    const image::pixel::Specification& outputSpecification) {
+  namespace specifications = image::pixel::specifications;
+
+#if SPECTRUM_SCANLINE_CONVERSION_X86
+  if (!__builtin_cpu_supports("ssse3")) {
+    return nullptr;
+  }
+
+  static const std::vector<RowConversion> rowConversions = {
+      {specifications::Gray, specifications::RGB, &grayToRgbSsse3},
+      {specifications::Gray, specifications::RGBA, &grayToRgbxSsse3<false>},
+      {specifications::Gray, specifications::ARGB, &grayToRgbxSsse3<true>},
+      {specifications::RGB, specifications::Gray, &rgbToGraySsse3},
+      {specifications::RGB, specifications::RGBA, &rgbToRgbxSsse3<false>},
+      {specifications::RGB, specifications::ARGB, &rgbToRgbxSsse3<true>},
+      {specifications::RGBA, specifications::ARGB, &swapAlphaSsse3<true>},
+      {specifications::ARGB, specifications::RGBA, &swapAlphaSsse3<false>},
+  // with fused multiply-adds the scalar blending might round differently
+#if !defined(__FMA__)
+      {specifications::RGBA, specifications::RGB, &blendRgbxToRgbSsse3<false>},
+      {specifications::ARGB, specifications::RGB, &blendRgbxToRgbSsse3<true>},
+#endif
+  };
+#elif SPECTRUM_SCANLINE_CONVERSION_NEON
+  static const std::vector<RowConversion> rowConversions = {
+      {specifications::Gray, specifications::RGB, &grayToRgbNeon},
+      {specifications::Gray, specifications::RGBA, &grayToRgbxNeon<false>},
+      {specifications::Gray, specifications::ARGB, &grayToRgbxNeon<true>},
+      {specifications::RGB, specifications::Gray, &rgbToGrayNeon},
+      {specifications::RGB, specifications::RGBA, &rgbToRgbxNeon<false>},
+      {specifications::RGB, specifications::ARGB, &rgbToRgbxNeon<true>},
+      {specifications::RGBA, specifications::ARGB, &swapAlphaNeon<true>},
+      {specifications::ARGB, specifications::RGBA, &swapAlphaNeon<false>},
+  };
+#else
+  static const std::vector<RowConversion> rowConversions;
+#endif
+
+  for (const auto& rowConversion : rowConversions) {
+    if (rowConversion.inputSpecification == inputSpecification &&
+        rowConversion.outputSpecification == outputSpecification) {
+      return rowConversion.function;
+    }
+  }
+
+  return nullptr;
+}
+
+} // namespace rows
+
 namespace {
 inline std::uint8_t _extractAlpha(
     const std::uint8_t* const pixel,
@@ -328,6 +815,61 @@ ScanlineConverter::ScanlineConverter(
       _outputSpecification(outputSpecification),
       _backgroundColor(backgroundColor) {}
 
+void ScanlineConverter::setScanlinePool(image::ScanlinePool* scanlinePool) {
+  _scanlinePool = scanlinePool;
+}
+
+template <typename ConvertPixels>
+std::unique_ptr<image::Scanline> ScanlineConverter::_convertScanline(
+    std::unique_ptr<image::Scanline> input,
+    const ConvertPixels& convertPixels) const {
+  SPECTRUM_ENFORCE_IF_NOT(input->specification() == _inputSpecification);
+
+  if (_inputSpecification.bytesPerPixel ==
+      _outputSpecification.bytesPerPixel) {
+    convertPixels(input->data(), input->data(), input->width());
+    input->reinterpretAs(_outputSpecification);
+    return input;
+  }
+
+  auto output =
+      image::makeScanline(_scanlinePool, _outputSpecification, input->width());
+  convertPixels(input->data(), output->data(), input->width());
+
+  image::releaseScanline(_scanlinePool, std::move(input));
+  return output;
+}
+
+//
+// RowScanlineConverter
+//
+
+RowScanlineConverter::RowScanlineConverter(
+    const image::pixel::Specification& inputSpecification,
+    const image::pixel::Specification& outputSpecification,
+    const image::Color& backgroundColor,
+    const RowConversionFunction rowConversionFunction)
+    : ScanlineConverter(
+          inputSpecification,
+          outputSpecification,
+          backgroundColor),
+      _rowConversionFunction(rowConversionFunction) {
+  SPECTRUM_ENFORCE_IF_NOT(_rowConversionFunction);
+}
+
+std::unique_ptr<image::Scanline> RowScanlineConverter::convertScanline(
+    std::unique_ptr<image::Scanline> input) const {
+  return _convertScanline(
+      std::move(input),
+      [this](
+          const std::uint8_t* inputData,
+          std::uint8_t* outputData,
+          const std::size_t width) {
+        _rowConversionFunction(
+            inputData, outputData, width, this->_backgroundColor);
+      });
+}
+
 //
 // DynamicScanlineConverter
 //
@@ -355,31 +897,45 @@ template <typename InputIndices, typename OutputIndices>
 std::unique_ptr<image::Scanline>
 DynamicScanlineConverter<InputIndices, OutputIndices>::convertScanline(
     std::unique_ptr<image::Scanline> input) const {
-  SPECTRUM_ENFORCE_IF_NOT(input->specification() == this->_inputSpecification);
-
-  auto output = std::make_unique<image::Scanline>(
-      this->_outputSpecification, input->width());
-
-  for (std::size_t i = 0; i < input->width(); ++i) {
-    const auto inputPixel = input->dataAtPixel(i);
-    const auto outputPixel = output->dataAtPixel(i);
-
-    _convertDynamicPixel(
-        _inputIndices,
-        inputPixel,
-        _outputIndices,
-        outputPixel,
-        this->_backgroundColor);
-
-    if (_outputIndices.hasAlpha) {
-      outputPixel[_outputIndices.alpha] = _extractAlpha(
-          inputPixel, _inputIndices.hasAlpha, _inputIndices.alpha);
-    }
-  }
-
-  return output;
+  const auto inputBytesPerPixel = this->_inputSpecification.bytesPerPixel;
+  const auto outputBytesPerPixel = this->_outputSpecification.bytesPerPixel;
+
+  return this->_convertScanline(
+      std::move(input),
+      [&](const std::uint8_t* inputData,
+          std::uint8_t* outputData,
+          const std::size_t width) {
+        // the input pixel is copied first as the output might overwrite it
+        std::array<std::uint8_t, 4> inputPixel;
+        SPECTRUM_ENFORCE_IF_NOT(inputBytesPerPixel <= inputPixel.size());
+
+        for (std::size_t i = 0; i < width; ++i) {
+          const auto outputPixel = outputData + i * outputBytesPerPixel;
+          std::memcpy(
+              inputPixel.data(),
+              inputData + i * inputBytesPerPixel,
+              inputBytesPerPixel);
+
+          _convertDynamicPixel(
+              _inputIndices,
+              inputPixel.data(),
+              _outputIndices,
+              outputPixel,
+              this->_backgroundColor);
+
+          if (_outputIndices.hasAlpha) {
+            outputPixel[_outputIndices.alpha] = _extractAlpha(
+                inputPixel.data(), _inputIndices.hasAlpha, _inputIndices.alpha);
+          }
+        }
+      });
 }
 
+template class DynamicScanlineConverter<indices::RGB, indices::RGB>;
+template class DynamicScanlineConverter<indices::RGB, indices::Gray>;
+template class DynamicScanlineConverter<indices::Gray, indices::RGB>;
+template class DynamicScanlineConverter<indices::Gray, indices::Gray>;
+
 //
 // DefaultScanlineConverter
 //
@@ -405,19 +961,15 @@ template <
 std::unique_ptr<image::Scanline>
 DefaultScanlineConverter<PI, PO, _pixelConversionFunction>::convertScanline(
     std::unique_ptr<image::Scanline> input) const {
-  SPECTRUM_ENFORCE_IF_NOT(input->specification() == this->_inputSpecification);
-
-  auto output = std::make_unique<image::Scanline>(
-      this->_outputSpecification, input->width());
-
-  for (std::size_t i = 0; i < input->width(); ++i) {
-    _pixelConversionFunction(
-        reinterpret_cast<const PI*>(input->data())[i],
-        reinterpret_cast<PO*>(output->data())[i],
-        this->_backgroundColor);
-  }
-
-  return output;
+  return this->_convertScanline(
+      std::move(input),
+      [this](
+          const std::uint8_t* inputData,
+          std::uint8_t* outputData,
+          const std::size_t width) {
+        rows::convertRow<PI, PO, _pixelConversionFunction>(
+            inputData, outputData, width, this->_backgroundColor);
+      });
 }
 
 //
@@ -449,6 +1001,14 @@ std::unique_ptr<ScanlineConverter> makeScanlineConverter(
   if (inputSpecification == outputSpecification) {
     return std::make_unique<NoOpScanlineConverter>(
         inputSpecification, outputSpecification, backgroundColor);
+  } else if (
+      const auto rowConversionFunction = rows::vectorizedRowConversionFunction(
+          inputSpecification, outputSpecification)) {
+    return std::make_unique<RowScanlineConverter>(
+        inputSpecification,
+        outputSpecification,
+        backgroundColor,
+        rowConversionFunction);
   } else if (
       inputSpecification == image::pixel::specifications::Gray &&
       outputSpecification == image::pixel::specifications::RGB) {
@@ -8,6 +8,11 @@
 #include <spectrum/image/Color.h>
 #include <spectrum/image/Pixel.h>
 #include <spectrum/image/Scanline.h>
+#include <spectrum/image/ScanlinePool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 
 #include <folly/Range.h>
 
@@ -58,10 +63,56 @@ class ScanlineConverter {
   virtual std::unique_ptr<image::Scanline> convertScanline(
       std::unique_ptr<image::Scanline> input) const = 0;
 
+  /**
+   * Sets the pool used to allocate converted scanlines and to recycle the
+   * input scanlines. Passing nullptr disables pooling.
+   */
+  void setScanlinePool(image::ScanlinePool* scanlinePool);
+
  protected:
   image::pixel::Specification _inputSpecification;
   image::pixel::Specification _outputSpecification;
   image::Color _backgroundColor;
+  image::ScanlinePool* _scanlinePool{nullptr};
+
+  /**
+   * Converts the input scanline with the given function, which converts
+   * `width` pixels from `input` to `output`. If both specifications have the
+   * same number of bytes per pixel, the input scanline is converted in place
+   * (`input` and `output` are equal) and returned. Otherwise, the output is
+   * written to a new scanline.
+   */
+  template <typename ConvertPixels>
+  std::unique_ptr<image::Scanline> _convertScanline(
+      std::unique_ptr<image::Scanline> input,
+      const ConvertPixels& convertPixels) const;
+};
+
+/**
+ * Converts whole rows at once with a vectorized conversion function. Used for
+ * the common pairs of specifications (see `makeScanlineConverter`).
+ */
+class RowScanlineConverter : public ScanlineConverter {
+ public:
+  using RowConversionFunction = void (*)(
+      const std::uint8_t* input,
+      std::uint8_t* output,
+      const std::size_t width,
+      const image::Color& backgroundColor);
+
+  RowScanlineConverter(
+      const image::pixel::Specification& inputSpecification,
+      const image::pixel::Specification& outputSpecification,
+      const image::Color& backgroundColor,
+      const RowConversionFunction rowConversionFunction);
+
+  ~RowScanlineConverter() override = default;
+
+  std::unique_ptr<image::Scanline> convertScanline(
+      std::unique_ptr<image::Scanline> input) const override;
+
+ private:
+  RowConversionFunction _rowConversionFunction;
 };
 
 template <
@@ -0,0 +1,90 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ScanlineFanOut.h"
+
+#include <spectrum/core/SpectrumEnforce.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+
+ScanlineFanOut::ScanlineFanOut(
+    std::vector<Branch> branches,
+    const std::size_t batchSize,
+    image::ScanlinePool* scanlinePool)
+    : _batchSize(batchSize), _scanlinePool(scanlinePool) {
+  SPECTRUM_ENFORCE_IF(branches.empty());
+  SPECTRUM_ENFORCE_IF_NOT(batchSize != 0);
+
+  _branches.reserve(branches.size());
+  for (auto& branch : branches) {
+    SPECTRUM_ENFORCE_IF_NOT(branch.scanlineBatchConsumer != nullptr);
+    for (auto& block : branch.processingBlocks) {
+      block->setScanlinePool(scanlinePool);
+    }
+
+    _branches.push_back(BranchState{std::move(branch), {}});
+    _branches.back().output.reserve(batchSize);
+  }
+}
+
+void ScanlineFanOut::consume(ScanlinePump::Scanlines scanlines) {
+  for (auto& scanline : scanlines) {
+    SPECTRUM_ENFORCE_IF_NOT(scanline);
+
+    // the last branch takes the scanline itself, the others a copy
+    for (std::size_t i = 0; i + 1 < _branches.size(); ++i) {
+      _push(_branches[i], _copy(*scanline));
+    }
+    _push(_branches.back(), std::move(scanline));
+  }
+}
+
+void ScanlineFanOut::finish() {
+  for (auto& state : _branches) {
+    _flush(state);
+  }
+}
+
+std::unique_ptr<image::Scanline> ScanlineFanOut::_copy(
+    const image::Scanline& scanline) {
+  auto copy = image::makeScanline(
+      _scanlinePool, scanline.specification(), scanline.width());
+  std::memcpy(copy->data(), scanline.data(), scanline.sizeBytes());
+  return copy;
+}
+
+void ScanlineFanOut::_push(
+    BranchState& state,
+    std::unique_ptr<image::Scanline> scanline) {
+  ScanlinePump::process(
+      state.branch.processingBlocks,
+      std::move(scanline),
+      [&](std::unique_ptr<image::Scanline> output) {
+        state.output.push_back(std::move(output));
+        if (state.output.size() >= _batchSize) {
+          _flush(state);
+        }
+      });
+}
+
+void ScanlineFanOut::_flush(BranchState& state) {
+  if (!state.output.empty()) {
+    state.branch.scanlineBatchConsumer(std::move(state.output));
+    state.output = ScanlinePump::Scanlines{};
+    state.output.reserve(_batchSize);
+  }
+}
+
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
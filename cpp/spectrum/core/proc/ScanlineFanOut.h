@@ -0,0 +1,76 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <spectrum/core/proc/ScanlineProcessingBlock.h>
+#include <spectrum/core/proc/ScanlinePump.h>
+#include <spectrum/image/Scanline.h>
+#include <spectrum/image/ScanlinePool.h>
+
+#include <memory>
+#include <vector>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+
+/**
+ * The scanline fan out hands the same scanlines to several independent
+ * branches, each made of its own processing blocks and consumer. It lets a
+ * single scanline pump (e.g. reading from one decompressor) feed several
+ * outputs.
+ *
+ * All but the last branch receive copies of the consumed scanlines. Each
+ * branch's output is handed to its consumer in batches of up to `batchSize`
+ * scanlines.
+ */
+class ScanlineFanOut {
+ public:
+  struct Branch {
+    std::vector<std::unique_ptr<ScanlineProcessingBlock>> processingBlocks;
+    ScanlinePump::ScanlineBatchConsumer scanlineBatchConsumer;
+  };
+
+  ScanlineFanOut(
+      std::vector<Branch> branches,
+      const std::size_t batchSize,
+      image::ScanlinePool* scanlinePool = nullptr);
+
+  ScanlineFanOut(const ScanlineFanOut&) = delete;
+  ScanlineFanOut& operator=(const ScanlineFanOut&) = delete;
+
+  /**
+   * Pushes the scanlines through every branch. Can be used as the batch
+   * consumer of a scanline pump.
+   */
+  void consume(ScanlinePump::Scanlines scanlines);
+
+  /**
+   * Hands the output that is still pending in the branches to their
+   * consumers. Must be called after the last scanline has been consumed.
+   */
+  void finish();
+
+ private:
+  struct BranchState {
+    Branch branch;
+    ScanlinePump::Scanlines output;
+  };
+
+  std::vector<BranchState> _branches;
+  const std::size_t _batchSize;
+  image::ScanlinePool* const _scanlinePool;
+
+  std::unique_ptr<image::Scanline> _copy(const image::Scanline& scanline);
+  void _push(BranchState& state, std::unique_ptr<image::Scanline> scanline);
+  void _flush(BranchState& state);
+};
+
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <spectrum/image/Scanline.h>
+#include <spectrum/image/ScanlinePool.h>
 
 #include <memory>
 
@@ -26,6 +27,9 @@ namespace proc {
  * There is no required 1:1 relation between consumed and produced scanline. For
  * instance, a scaling processing block might produce less scanlines than it
  * consumes.
+ *
+ * If a scanline pool is set, blocks allocate the scanlines they produce from it
+ * and hand consumed scanlines they don't forward back to it.
  */
 class ScanlineProcessingBlock {
  public:
@@ -43,6 +47,17 @@ class ScanlineProcessingBlock {
    * output.
    */
   virtual std::unique_ptr<image::Scanline> produce() = 0;
+
+  /**
+   * Sets the pool used to allocate and recycle scanlines. Passing nullptr
+   * disables pooling.
+   */
+  virtual void setScanlinePool(image::ScanlinePool* scanlinePool) {
+    _scanlinePool = scanlinePool;
+  }
+
+ protected:
+  image::ScanlinePool* _scanlinePool{nullptr};
 };
 
 } // namespace proc
@@ -6,10 +6,15 @@
 #include "ScanlinePump.h"
 
 #include <spectrum/core/SpectrumEnforce.h>
+#include <spectrum/core/proc/ScanlineBatchQueue.h>
 #include <spectrum/core/proc/ScanlineProcessingBlock.h>
 #include <spectrum/image/Scanline.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
+#include <thread>
 #include <vector>
 
 namespace facebook {
@@ -17,38 +22,211 @@ namespace spectrum {
 namespace core {
 namespace proc {
 
+ScanlinePump::ScanlineBatchGenerator ScanlinePump::makeBatchGenerator(
+    ScanlineGenerator scanlineGenerator) {
+  SPECTRUM_ENFORCE_IF_NOT(scanlineGenerator != nullptr);
+  return [scanlineGenerator = std::move(scanlineGenerator)](
+             const std::size_t numberOfScanlines) {
+    Scanlines scanlines;
+    scanlines.reserve(numberOfScanlines);
+    for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+      scanlines.push_back(scanlineGenerator());
+    }
+    return scanlines;
+  };
+}
+
+ScanlinePump::ScanlineBatchConsumer ScanlinePump::makeBatchConsumer(
+    ScanlineConsumer scanlineConsumer) {
+  SPECTRUM_ENFORCE_IF_NOT(scanlineConsumer != nullptr);
+  return [scanlineConsumer = std::move(scanlineConsumer)](Scanlines scanlines) {
+    for (auto& scanline : scanlines) {
+      scanlineConsumer(std::move(scanline));
+    }
+  };
+}
+
+std::size_t ScanlinePump::numScanlinesToGenerate(
+    const std::size_t numPumpedScanlines) const {
+  return std::min(batchSize, numInputScanlines - numPumpedScanlines);
+}
+
+void ScanlinePump::process(
+    std::vector<std::unique_ptr<ScanlineProcessingBlock>>& processingBlocks,
+    std::unique_ptr<image::Scanline> scanline,
+    const ScanlineConsumer& emit) {
+  SPECTRUM_ENFORCE_IF_NOT(scanline);
+
+  // execute processing blocks and consumer while there's actual processing
+  // happening in any of the processing steps
+  bool change;
+  do {
+    change = false;
+    for (auto& block : processingBlocks) {
+      // consume scanline of previous block (possible from input block)
+      if (scanline) {
+        block->consume(std::move(scanline));
+      }
+
+      // set current scanline to output of this block
+      SPECTRUM_ENFORCE_IF_NOT(!scanline);
+      scanline = block->produce();
+
+      if (scanline) {
+        change = true;
+      }
+    }
+
+    // the scanlineConsumer behaves as a last block that does not produce
+    if (scanline) {
+      emit(std::move(scanline));
+    }
+
+  } while (change);
+}
+
 void ScanlinePump::pumpAll() {
-  for (std::size_t i = 0; i < numInputScanlines; i++) {
-    // generate one input scanline
-    auto scanline = scanlineGenerator();
-    SPECTRUM_ENFORCE_IF_NOT(scanline);
-
-    // execute processing blocks and consumer while there's actual processing
-    // happening in any of the processing steps
-    bool change;
-    do {
-      change = false;
-      for (auto& block : processingBlocks) {
-        // consume scanline of previous block (possible from input block)
-        if (scanline) {
-          block->consume(std::move(scanline));
+  Scanlines output;
+  output.reserve(batchSize);
+
+  const auto flushOutput = [&]() {
+    if (!output.empty()) {
+      scanlineBatchConsumer(std::move(output));
+      output = Scanlines{};
+      output.reserve(batchSize);
+    }
+  };
+
+  const ScanlineConsumer emit =
+      [&](std::unique_ptr<image::Scanline> scanline) {
+        output.push_back(std::move(scanline));
+        if (output.size() >= batchSize) {
+          flushOutput();
         }
+      };
+
+  std::size_t numPumpedScanlines = 0;
+  while (numPumpedScanlines < numInputScanlines) {
+    // generate a batch of input scanlines
+    const auto numScanlines = numScanlinesToGenerate(numPumpedScanlines);
+    auto input = scanlineBatchGenerator(numScanlines);
+    SPECTRUM_ENFORCE_IF_NOT(input.size() == numScanlines);
+    numPumpedScanlines += numScanlines;
 
-        // set current scanline to output of this block
-        SPECTRUM_ENFORCE_IF_NOT(!scanline);
-        scanline = block->produce();
+    for (auto& inputScanline : input) {
+      process(processingBlocks, std::move(inputScanline), emit);
+    }
+  }
+
+  flushOutput();
+}
 
-        if (scanline) {
-          change = true;
+void ScanlinePump::generateInto(ScanlineBatchQueue& inputQueue) {
+  std::size_t numPumpedScanlines = 0;
+  while (numPumpedScanlines < numInputScanlines) {
+    const auto numScanlines = numScanlinesToGenerate(numPumpedScanlines);
+    auto input = scanlineBatchGenerator(numScanlines);
+    SPECTRUM_ENFORCE_IF_NOT(input.size() == numScanlines);
+    numPumpedScanlines += numScanlines;
+
+    if (!inputQueue.push(std::move(input))) {
+      return;
+    }
+  }
+
+  inputQueue.close();
+}
+
+void ScanlinePump::processInto(
+    ScanlineBatchQueue& inputQueue,
+    ScanlineBatchQueue& outputQueue) {
+  Scanlines output;
+  output.reserve(batchSize);
+  bool isCancelled = false;
+
+  const ScanlineConsumer emit =
+      [&](std::unique_ptr<image::Scanline> scanline) {
+        output.push_back(std::move(scanline));
+        if (output.size() >= batchSize) {
+          isCancelled = !outputQueue.push(std::move(output));
+          output = Scanlines{};
+          output.reserve(batchSize);
         }
-      }
+      };
 
-      // the scanlineConsumer behaves as a last block that does not produce
-      if (scanline) {
-        scanlineConsumer(std::move(scanline));
+  Scanlines input;
+  while (!isCancelled && inputQueue.pop(input)) {
+    for (auto& inputScanline : input) {
+      process(processingBlocks, std::move(inputScanline), emit);
+    }
+  }
+
+  // the input queue also stops popping when cancelled
+  if (isCancelled || inputQueue.isCancelled()) {
+    return;
+  }
+
+  if (!output.empty() && !outputQueue.push(std::move(output))) {
+    return;
+  }
+  outputQueue.close();
+}
+
+void ScanlinePump::pumpAllPipelined(const std::size_t queueCapacity) {
+  ScanlineBatchQueue inputQueue{queueCapacity};
+  ScanlineBatchQueue outputQueue{queueCapacity};
+
+  // the first error of any stage. only written by the stage that failed
+  // first and read once all stages have joined
+  std::exception_ptr error;
+  std::atomic<bool> hasFailed{false};
+  const auto fail = [&] {
+    if (!hasFailed.exchange(true)) {
+      error = std::current_exception();
+    }
+    inputQueue.cancel();
+    outputQueue.cancel();
+  };
+
+  std::thread generatorThread([&] {
+    try {
+      generateInto(inputQueue);
+    } catch (...) {
+      fail();
+    }
+  });
+
+  std::thread processingThread;
+  try {
+    processingThread = std::thread([&] {
+      try {
+        processInto(inputQueue, outputQueue);
+      } catch (...) {
+        fail();
       }
+    });
+  } catch (...) {
+    // the generator must not outlive the pump
+    inputQueue.cancel();
+    generatorThread.join();
+    throw;
+  }
+
+  try {
+    Scanlines output;
+    while (outputQueue.pop(output)) {
+      scanlineBatchConsumer(std::move(output));
+      output = Scanlines{};
+    }
+  } catch (...) {
+    fail();
+  }
+
+  generatorThread.join();
+  processingThread.join();
 
-    } while (change);
+  if (error != nullptr) {
+    std::rethrow_exception(error);
   }
 }
 
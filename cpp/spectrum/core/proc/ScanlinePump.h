@@ -6,10 +6,13 @@
 #pragma once
 
 #include <spectrum/core/SpectrumEnforce.h>
+#include <spectrum/core/proc/ScanlineBatchQueue.h>
 #include <spectrum/core/proc/ScanlineProcessingBlock.h>
 #include <spectrum/image/Scanline.h>
+#include <spectrum/image/ScanlinePool.h>
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace facebook {
@@ -24,31 +27,128 @@ namespace proc {
  *
  * It allow for processing blocks to buffer any number of scanlines during the
  * process like e.g. the rotation processor does.
+ *
+ * When given a scanline pool, the pump hands it to all processing blocks so
+ * that scanlines are recycled between them instead of being reallocated.
+ *
+ * Scanlines are requested from the generator and handed to the consumer in
+ * batches of up to `batchSize` scanlines so that codecs can amortise their
+ * per-call overhead over several rows.
+ *
+ * The pump can either run all stages in lockstep on the calling thread
+ * (`pumpAll`) or overlap them on separate threads (`pumpAllPipelined`).
  */
 class ScanlinePump {
+ public:
+  using Scanlines = std::vector<std::unique_ptr<image::Scanline>>;
+  using ScanlineGenerator = std::function<std::unique_ptr<image::Scanline>()>;
+  using ScanlineConsumer =
+      std::function<void(std::unique_ptr<image::Scanline>)>;
+  using ScanlineBatchGenerator =
+      std::function<Scanlines(const std::size_t numberOfScanlines)>;
+  using ScanlineBatchConsumer = std::function<void(Scanlines scanlines)>;
+
+  /**
+   * Number of scanlines per batch used by the recipes. Matches the height of
+   * the largest JPEG iMCU row.
+   */
+  static constexpr std::size_t DefaultBatchSize = 16;
+
+  /**
+   * Number of batches that can be in flight between two pipelined stages.
+   */
+  static constexpr std::size_t DefaultQueueCapacity = 4;
+
+  /**
+   * Runs a scanline through the processing blocks and hands the scanlines
+   * they produce in return to `emit`. Shared with the other drivers of
+   * processing blocks so that all of them iterate the same way.
+   */
+  static void process(
+      std::vector<std::unique_ptr<ScanlineProcessingBlock>>& processingBlocks,
+      std::unique_ptr<image::Scanline> scanline,
+      const ScanlineConsumer& emit);
+
  private:
-  std::function<std::unique_ptr<image::Scanline>()> scanlineGenerator;
+  ScanlineBatchGenerator scanlineBatchGenerator;
   std::vector<std::unique_ptr<ScanlineProcessingBlock>> processingBlocks;
-  std::function<void(std::unique_ptr<image::Scanline>)> scanlineConsumer;
+  ScanlineBatchConsumer scanlineBatchConsumer;
 
   const std::size_t numInputScanlines;
+  const std::size_t batchSize;
+
+  static ScanlineBatchGenerator makeBatchGenerator(
+      ScanlineGenerator scanlineGenerator);
+  static ScanlineBatchConsumer makeBatchConsumer(
+      ScanlineConsumer scanlineConsumer);
+
+  std::size_t numScanlinesToGenerate(
+      const std::size_t numPumpedScanlines) const;
+
+  /**
+   * Stages of `pumpAllPipelined`. Each stops early if its queues have been
+   * cancelled and closes its output queue when done.
+   */
+  void generateInto(ScanlineBatchQueue& inputQueue);
+  void processInto(
+      ScanlineBatchQueue& inputQueue,
+      ScanlineBatchQueue& outputQueue);
 
  public:
   ScanlinePump(
-      std::function<std::unique_ptr<image::Scanline>()> scanlineGenerator,
+      ScanlineGenerator scanlineGenerator,
+      std::vector<std::unique_ptr<ScanlineProcessingBlock>> processingBlocks,
+      ScanlineConsumer scanlineConsumer,
+      const int numInputScanlines,
+      image::ScanlinePool* scanlinePool = nullptr)
+      : ScanlinePump(
+            makeBatchGenerator(std::move(scanlineGenerator)),
+            std::move(processingBlocks),
+            makeBatchConsumer(std::move(scanlineConsumer)),
+            numInputScanlines,
+            1,
+            scanlinePool) {}
+
+  ScanlinePump(
+      ScanlineBatchGenerator scanlineBatchGenerator,
       std::vector<std::unique_ptr<ScanlineProcessingBlock>> processingBlocks,
-      std::function<void(std::unique_ptr<image::Scanline>)> scanlineConsumer,
-      const int numInputScanlines)
-      : scanlineGenerator(scanlineGenerator),
+      ScanlineBatchConsumer scanlineBatchConsumer,
+      const int numInputScanlines,
+      const std::size_t batchSize,
+      image::ScanlinePool* scanlinePool = nullptr)
+      : scanlineBatchGenerator(std::move(scanlineBatchGenerator)),
         processingBlocks(std::move(processingBlocks)),
-        scanlineConsumer(scanlineConsumer),
-        numInputScanlines(numInputScanlines) {
+        scanlineBatchConsumer(std::move(scanlineBatchConsumer)),
+        numInputScanlines(numInputScanlines),
+        batchSize(batchSize) {
     SPECTRUM_ENFORCE_IF_NOT(numInputScanlines != 0);
-    SPECTRUM_ENFORCE_IF_NOT(scanlineGenerator != nullptr);
-    SPECTRUM_ENFORCE_IF_NOT(scanlineConsumer != nullptr);
+    SPECTRUM_ENFORCE_IF_NOT(batchSize != 0);
+    SPECTRUM_ENFORCE_IF_NOT(this->scanlineBatchGenerator != nullptr);
+    SPECTRUM_ENFORCE_IF_NOT(this->scanlineBatchConsumer != nullptr);
+
+    for (auto& block : this->processingBlocks) {
+      block->setScanlinePool(scanlinePool);
+    }
   }
 
   void pumpAll();
+
+  /**
+   * Pumps all scanlines like `pumpAll` but with the generator, the processing
+   * blocks and the consumer each running on their own thread (the consumer on
+   * the calling thread). Consecutive stages are connected by bounded queues
+   * of batches, so that e.g. decoding the next rows overlaps with encoding
+   * the previous ones. The output and its batching are unchanged.
+   *
+   * The first exception thrown by any stage stops all stages and is rethrown.
+   *
+   * @note The scanline pool of the processing blocks is used from their
+   * thread, so the generator and the consumer must not use the same pool.
+   *
+   * @param queueCapacity The number of batches each queue can hold.
+   */
+  void pumpAllPipelined(
+      const std::size_t queueCapacity = DefaultQueueCapacity);
 };
 
 } // namespace proc
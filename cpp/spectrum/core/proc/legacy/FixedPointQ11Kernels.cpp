@@ -0,0 +1,272 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+/** ===========================================================================
+ *       @file  FixedPointQ11Kernels.cpp
+ *      @brief  Row kernels for Q11 fixed point arithmetic
+ * ============================================================================
+ */
+
+// ============= include files =============
+#include "FixedPointQ11Kernels.h"
+
+#include <spectrum/core/SpectrumEnforce.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// x86 kernels are compiled for their instruction set and selected at runtime
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SPECTRUM_Q11_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SPECTRUM_Q11_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+namespace legacy {
+namespace kernels {
+
+namespace {
+
+// =========================================
+// scalar
+void addWeightedRowQ11Scalar(
+    int32_t* pAcc,
+    const int32_t* pSrc,
+    const int32_t w,
+    const std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    pAcc[i] += (pSrc[i] * w) >> 11;
+  }
+}
+
+void convertRowQ11ToUint8Scalar(
+    const int32_t* pSrc,
+    std::uint8_t* pDst,
+    const std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    int32_t val = (((int64_t)(pSrc[i]) * (1 << 21)) + ((int64_t)1 << 31)) >> 32;
+    pDst[i] = (val < 0 ? 0 : (val > 255 ? 255 : val));
+  }
+}
+
+// the vector conversions compute round(v / 2^11) as ((v >> 1) + 2^9) >> 10
+// which equals the 64 bit computation above without overflowing 32 bits
+
+#if SPECTRUM_Q11_KERNELS_X86
+// =========================================
+// sse4.1
+__attribute__((target("sse4.1"))) void addWeightedRowQ11Sse41(
+    int32_t* pAcc,
+    const int32_t* pSrc,
+    const int32_t w,
+    const std::size_t n) {
+  const __m128i weight = _mm_set1_epi32(w);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i src = _mm_loadu_si128((const __m128i*)(pSrc + i));
+    const __m128i acc = _mm_loadu_si128((const __m128i*)(pAcc + i));
+    const __m128i weighted = _mm_srai_epi32(_mm_mullo_epi32(src, weight), 11);
+    _mm_storeu_si128((__m128i*)(pAcc + i), _mm_add_epi32(acc, weighted));
+  }
+  addWeightedRowQ11Scalar(pAcc + i, pSrc + i, w, n - i);
+}
+
+__attribute__((target("sse4.1"))) void convertRowQ11ToUint8Sse41(
+    const int32_t* pSrc,
+    std::uint8_t* pDst,
+    const std::size_t n) {
+  const __m128i half = _mm_set1_epi32(1 << 9);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i lo = _mm_loadu_si128((const __m128i*)(pSrc + i));
+    const __m128i hi = _mm_loadu_si128((const __m128i*)(pSrc + i + 4));
+    const __m128i roundedLo =
+        _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(lo, 1), half), 10);
+    const __m128i roundedHi =
+        _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(hi, 1), half), 10);
+    // saturating packs clamp to [0, 255]
+    const __m128i packed16 = _mm_packs_epi32(roundedLo, roundedHi);
+    const __m128i packed8 = _mm_packus_epi16(packed16, packed16);
+    _mm_storel_epi64((__m128i*)(pDst + i), packed8);
+  }
+  convertRowQ11ToUint8Scalar(pSrc + i, pDst + i, n - i);
+}
+
+// =========================================
+// avx2
+__attribute__((target("avx2"))) void addWeightedRowQ11Avx2(
+    int32_t* pAcc,
+    const int32_t* pSrc,
+    const int32_t w,
+    const std::size_t n) {
+  const __m256i weight = _mm256_set1_epi32(w);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i src = _mm256_loadu_si256((const __m256i*)(pSrc + i));
+    const __m256i acc = _mm256_loadu_si256((const __m256i*)(pAcc + i));
+    const __m256i weighted =
+        _mm256_srai_epi32(_mm256_mullo_epi32(src, weight), 11);
+    _mm256_storeu_si256((__m256i*)(pAcc + i), _mm256_add_epi32(acc, weighted));
+  }
+  addWeightedRowQ11Sse41(pAcc + i, pSrc + i, w, n - i);
+}
+
+__attribute__((target("avx2"))) void convertRowQ11ToUint8Avx2(
+    const int32_t* pSrc,
+    std::uint8_t* pDst,
+    const std::size_t n) {
+  const __m256i half = _mm256_set1_epi32(1 << 9);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m256i lo = _mm256_loadu_si256((const __m256i*)(pSrc + i));
+    const __m256i hi = _mm256_loadu_si256((const __m256i*)(pSrc + i + 8));
+    const __m256i roundedLo =
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_srai_epi32(lo, 1), half), 10);
+    const __m256i roundedHi =
+        _mm256_srai_epi32(_mm256_add_epi32(_mm256_srai_epi32(hi, 1), half), 10);
+    // packs operate per 128 bit lane: restore the order afterwards
+    const __m256i packed16 = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(roundedLo, roundedHi), 0xd8);
+    const __m128i packed8 = _mm_packus_epi16(
+        _mm256_castsi256_si128(packed16),
+        _mm256_extracti128_si256(packed16, 1));
+    _mm_storeu_si128((__m128i*)(pDst + i), packed8);
+  }
+  convertRowQ11ToUint8Sse41(pSrc + i, pDst + i, n - i);
+}
+#endif // SPECTRUM_Q11_KERNELS_X86
+
+#if SPECTRUM_Q11_KERNELS_NEON
+// =========================================
+// neon
+void addWeightedRowQ11Neon(
+    int32_t* pAcc,
+    const int32_t* pSrc,
+    const int32_t w,
+    const std::size_t n) {
+  const int32x4_t weight = vdupq_n_s32(w);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const int32x4_t weighted =
+        vshrq_n_s32(vmulq_s32(vld1q_s32(pSrc + i), weight), 11);
+    vst1q_s32(pAcc + i, vaddq_s32(vld1q_s32(pAcc + i), weighted));
+  }
+  addWeightedRowQ11Scalar(pAcc + i, pSrc + i, w, n - i);
+}
+
+void convertRowQ11ToUint8Neon(
+    const int32_t* pSrc,
+    std::uint8_t* pDst,
+    const std::size_t n) {
+  const int32x4_t half = vdupq_n_s32(1 << 9);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const int32x4_t roundedLo = vshrq_n_s32(
+        vaddq_s32(vshrq_n_s32(vld1q_s32(pSrc + i), 1), half), 10);
+    const int32x4_t roundedHi = vshrq_n_s32(
+        vaddq_s32(vshrq_n_s32(vld1q_s32(pSrc + i + 4), 1), half), 10);
+    // saturating narrows clamp to [0, 255]
+    const int16x8_t packed16 =
+        vcombine_s16(vqmovn_s32(roundedLo), vqmovn_s32(roundedHi));
+    vst1_u8(pDst + i, vqmovun_s16(packed16));
+  }
+  convertRowQ11ToUint8Scalar(pSrc + i, pDst + i, n - i);
+}
+#endif // SPECTRUM_Q11_KERNELS_NEON
+
+const Kernels ScalarKernels = {
+    &addWeightedRowQ11Scalar,
+    &convertRowQ11ToUint8Scalar,
+};
+
+#if SPECTRUM_Q11_KERNELS_X86
+const Kernels Sse41Kernels = {
+    &addWeightedRowQ11Sse41,
+    &convertRowQ11ToUint8Sse41,
+};
+
+const Kernels Avx2Kernels = {
+    &addWeightedRowQ11Avx2,
+    &convertRowQ11ToUint8Avx2,
+};
+#endif
+
+#if SPECTRUM_Q11_KERNELS_NEON
+const Kernels NeonKernels = {
+    &addWeightedRowQ11Neon,
+    &convertRowQ11ToUint8Neon,
+};
+#endif
+
+InstructionSet bestInstructionSet() {
+  for (const auto instructionSet :
+       {InstructionSet::Avx2, InstructionSet::Sse41, InstructionSet::Neon}) {
+    if (isSupported(instructionSet)) {
+      return instructionSet;
+    }
+  }
+  return InstructionSet::Scalar;
+}
+
+} // namespace
+
+bool isSupported(const InstructionSet instructionSet) {
+  switch (instructionSet) {
+    case InstructionSet::Scalar:
+      return true;
+#if SPECTRUM_Q11_KERNELS_X86
+    case InstructionSet::Sse41:
+      return __builtin_cpu_supports("sse4.1");
+    case InstructionSet::Avx2:
+      return __builtin_cpu_supports("avx2");
+#endif
+#if SPECTRUM_Q11_KERNELS_NEON
+    case InstructionSet::Neon:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+const Kernels& kernelsFor(const InstructionSet instructionSet) {
+  SPECTRUM_ENFORCE_IF_NOT(isSupported(instructionSet));
+  switch (instructionSet) {
+#if SPECTRUM_Q11_KERNELS_X86
+    case InstructionSet::Sse41:
+      return Sse41Kernels;
+    case InstructionSet::Avx2:
+      return Avx2Kernels;
+#endif
+#if SPECTRUM_Q11_KERNELS_NEON
+    case InstructionSet::Neon:
+      return NeonKernels;
+#endif
+    default:
+      return ScalarKernels;
+  }
+}
+
+const Kernels& kernels() {
+  static const Kernels& best = kernelsFor(bestInstructionSet());
+  return best;
+}
+
+} // namespace kernels
+} // namespace legacy
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
+
+// ================================= EOF ======================================
@@ -0,0 +1,68 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+/** ===========================================================================
+ *       @file  FixedPointQ11Kernels.h
+ *      @brief  Row kernels for Q11 fixed point arithmetic
+ * ============================================================================
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+namespace legacy {
+
+// =========================================
+// the row kernels work on interleaved components as a flat array: the weights
+// of the separable filters only depend on the row, not on the component. all
+// implementations are bit-exact with the scalar Q11 macros
+namespace kernels {
+
+enum class InstructionSet : std::uint8_t {
+  Scalar,
+  Sse41,
+  Avx2,
+  Neon,
+};
+
+struct Kernels {
+  // pAcc[i] += (pSrc[i] * w) >> 11 for i in [0, n)
+  void (*addWeightedRowQ11)(
+      int32_t* pAcc,
+      const int32_t* pSrc,
+      const int32_t w,
+      const std::size_t n);
+
+  // pDst[i] = clamp(round(pSrc[i] / 2^11), 0, 255) for i in [0, n)
+  void (*convertRowQ11ToUint8)(
+      const int32_t* pSrc,
+      std::uint8_t* pDst,
+      const std::size_t n);
+};
+
+// whether the instruction set can be used on the running cpu
+bool isSupported(const InstructionSet instructionSet);
+
+// kernels of the given instruction set. it must be supported
+const Kernels& kernelsFor(const InstructionSet instructionSet);
+
+// kernels of the best instruction set supported on the running cpu
+const Kernels& kernels();
+
+} // namespace kernels
+
+} // namespace legacy
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
+
+// ================================= EOF ======================================
@@ -12,9 +12,11 @@
 // ============= include files =============
 #include "SeparableFiltersResampler.h"
 #include "FixedPointQ11.h"
+#include "FixedPointQ11Kernels.h"
 
 #include <spectrum/core/SpectrumEnforce.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -92,7 +94,7 @@ void SeparableFiltersResampler::putLine(const std::uint8_t* pSrc) {
   // get available row to write into
   mSrcRowInfo[mSrcY].first = mIntermediateTail;
   int32_t* pOutputRow = mIntermediateRows[mIntermediateTail].data();
-  resampleX(pSrc, pOutputRow);
+  resampleRowX(pSrc, pOutputRow);
 
   // manage intermediate buffers ring buffer
   mIntermediateTail = (mIntermediateTail + 1) % mIntermediateRows.size();
@@ -116,49 +118,117 @@ int32_t* SeparableFiltersResampler::getLine() {
 }
 
 // =========================================
-// resample in x dimension
-void SeparableFiltersResampler::resampleX(
+// first and one-past-last src rows contributing to dst rows [begin, end)
+std::pair<std::uint32_t, std::uint32_t> SeparableFiltersResampler::srcRowRange(
+    const std::uint32_t dstBegin,
+    const std::uint32_t dstEnd) const {
+  SPECTRUM_ENFORCE_IF_NOT(dstBegin < dstEnd && dstEnd <= mDstHeight);
+  int first = mYContributors[dstBegin].front().index;
+  int last = mYContributors[dstBegin].back().index;
+  for (std::uint32_t r = dstBegin; r < dstEnd; ++r) {
+    for (const auto& contributor : mYContributors[r]) {
+      first = std::min(first, contributor.index);
+      last = std::max(last, contributor.index);
+    }
+  }
+  return std::make_pair(
+      static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last + 1));
+}
+
+// =========================================
+// resample in x dimension, fixed number of components. the accumulators
+// stay in registers
+template <std::uint8_t Components>
+void SeparableFiltersResampler::resampleRowX(
+    const std::vector<std::vector<Contrib>>& contributorLists,
     const std::uint8_t* pSrc,
     int32_t* pDst) {
-  memset(pDst, 0, mDstPitch * sizeof(int32_t));
-  auto end = mXContributors.cend();
-  for (auto clists = mXContributors.cbegin(); clists != end; ++clists) {
-    auto clists_end = clists->cend();
-    for (auto contributors = clists->cbegin(); contributors != clists_end;
-         ++contributors) {
-      const int32_t w = contributors->wQ;
-      const std::uint8_t* pPixel =
-          pSrc + (contributors->index * mOutputComponents);
+  for (const auto& contributors : contributorLists) {
+    int32_t acc[Components] = {};
+    for (const auto& contributor : contributors) {
+      const int32_t w = contributor.wQ;
+      const std::uint8_t* pPixel = pSrc + (contributor.index * Components);
       // multiply and convert to Q21.11
-      AddWeightedPixel(mOutputComponents, pDst, pPixel, w);
+      for (std::uint8_t c = 0; c < Components; ++c) {
+        acc[c] += pPixel[c] * w;
+      }
+    }
+    for (std::uint8_t c = 0; c < Components; ++c) {
+      pDst[c] = acc[c];
     }
-    pDst += mOutputComponents;
+    pDst += Components;
   }
 }
 
 // =========================================
-// resample in y dimension
+// resample in x dimension
+void SeparableFiltersResampler::resampleRowX(
+    const std::uint8_t* pSrc,
+    int32_t* pDst) const {
+  switch (mOutputComponents) {
+    case 1:
+      resampleRowX<1>(mXContributors, pSrc, pDst);
+      break;
+    case 3:
+      resampleRowX<3>(mXContributors, pSrc, pDst);
+      break;
+    case 4:
+      resampleRowX<4>(mXContributors, pSrc, pDst);
+      break;
+    default:
+      memset(pDst, 0, mDstPitch * sizeof(int32_t));
+      break;
+  }
+}
+
+// =========================================
+// resample in y dimension, online
 void SeparableFiltersResampler::resampleY() {
-  std::fill(mYResamplingBuffer.begin(), mYResamplingBuffer.end(), 0);
-  int32_t* pDst = mYResamplingBuffer.data();
-
-  // for each x in w_dst
-  for (std::uint32_t x = 0; x < mDstWidth; ++x) {
-    auto end = mYContributors[mDstY].cend();
-    for (auto contributors = mYContributors[mDstY].begin(); contributors != end;
-         ++contributors) {
-      const int32_t w = contributors->wQ;
-      const int32_t* pPixel =
-          mIntermediateRows[mSrcRowInfo[contributors->index].first].data() +
-          (x * mOutputComponents);
-      // pPixel is in Q21.11
-      AddWeightedPixelQ11(mOutputComponents, pDst, pPixel, w);
-    }
-    pDst += mOutputComponents;
+  const auto& contributors = mYContributors[mDstY];
+  mYContributorRows.resize(contributors.size());
+  for (std::size_t k = 0; k < contributors.size(); ++k) {
+    mYContributorRows[k] =
+        mIntermediateRows[mSrcRowInfo[contributors[k].index].first].data();
   }
+  resampleY(mDstY, mYContributorRows.data(), mYResamplingBuffer.data());
   ++mDstY;
 }
 
+// =========================================
+// resample in y dimension from x-resampled rows of a stripe
+void SeparableFiltersResampler::resampleRowY(
+    const std::uint32_t dstY,
+    const int32_t* pSrcRows,
+    const std::uint32_t srcBegin,
+    int32_t* pDst) const {
+  const auto& contributors = mYContributors[dstY];
+  std::vector<const int32_t*> contributorRows(contributors.size());
+  for (std::size_t k = 0; k < contributors.size(); ++k) {
+    SPECTRUM_ENFORCE_IF(contributors[k].index < (int)srcBegin);
+    contributorRows[k] =
+        pSrcRows + (contributors[k].index - srcBegin) * mDstPitch;
+  }
+  resampleY(dstY, contributorRows.data(), pDst);
+}
+
+// =========================================
+// resample in y dimension. the weight of a contributor is the same for all
+// components of a row which is processed as a flat array
+void SeparableFiltersResampler::resampleY(
+    const std::uint32_t dstY,
+    const int32_t* const* pContributorRows,
+    int32_t* pDst) const {
+  const auto& rowKernels = kernels::kernels();
+  std::fill(pDst, pDst + mDstPitch, 0);
+
+  const auto& contributors = mYContributors[dstY];
+  for (std::size_t k = 0; k < contributors.size(); ++k) {
+    // pContributorRows[k] is in Q21.11
+    rowKernels.addWeightedRowQ11(
+        pDst, pContributorRows[k], contributors[k].wQ, mDstPitch);
+  }
+}
+
 // =========================================
 // init contributors list
 std::size_t SeparableFiltersResampler::prepareContributorLists() {
@@ -16,6 +16,7 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <utility>
 #include <vector>
 
 namespace facebook {
@@ -41,6 +42,32 @@ class SeparableFiltersResampler {
   void putLine(const std::uint8_t* pSrc);
   int32_t* getLine();
 
+  // =========================================
+  // stateless access to the individual passes. these only read the
+  // contributor lists and can be used from several threads at once to
+  // resample independent stripes of the image
+
+  // number of int32_t values in an intermediate / output row
+  std::uint32_t dstPitch() const {
+    return mDstPitch;
+  }
+
+  // first and one-past-last src rows contributing to dst rows [begin, end)
+  std::pair<std::uint32_t, std::uint32_t> srcRowRange(
+      const std::uint32_t dstBegin,
+      const std::uint32_t dstEnd) const;
+
+  // resample a src row in x dimension into pDst (dstPitch values, Q21.11)
+  void resampleRowX(const std::uint8_t* pSrc, int32_t* pDst) const;
+
+  // resample dst row dstY in y dimension from x-resampled src rows. pSrcRows
+  // points to x-resampled row `srcBegin` and rows are dstPitch apart
+  void resampleRowY(
+      const std::uint32_t dstY,
+      const int32_t* pSrcRows,
+      const std::uint32_t srcBegin,
+      int32_t* pDst) const;
+
  private:
   // consts
   static const std::size_t NUM_SHARPEN_BUFFERS;
@@ -77,6 +104,7 @@ class SeparableFiltersResampler {
   // intermediate storage
   std::vector<std::vector<int32_t>> mIntermediateRows;
   std::vector<int32_t> mYResamplingBuffer;
+  std::vector<const int32_t*> mYContributorRows;
 
   // output buffer
   std::vector<std::uint8_t> mOutBuffer;
@@ -84,8 +112,16 @@ class SeparableFiltersResampler {
   // internal methods
   std::size_t prepareContributorLists();
   float magicKernelWeight(float z);
-  void resampleX(const std::uint8_t* pSrc, int32_t* pDst);
+  template <std::uint8_t Components>
+  static void resampleRowX(
+      const std::vector<std::vector<Contrib>>& contributorLists,
+      const std::uint8_t* pSrc,
+      int32_t* pDst);
   void resampleY();
+  void resampleY(
+      const std::uint32_t dstY,
+      const int32_t* const* pContributorRows,
+      int32_t* pDst) const;
   void start();
 };
 
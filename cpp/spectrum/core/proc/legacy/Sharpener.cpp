@@ -12,6 +12,7 @@
 // ============= include files =============
 #include "Sharpener.h"
 #include "FixedPointQ11.h"
+#include "FixedPointQ11Kernels.h"
 
 #include <cmath>
 #include <cstdint>
@@ -98,14 +99,6 @@ void Sharpener::putLine(const int32_t* pSrc) {
   }
   sharpenY();
 
-  // convert from Q11 to std::uint8_t
-  std::uint8_t* pOut = mOutBufferPtr;
-  const int32_t* pBuf = mYSharpenBuffer.data();
-  for (std::uint32_t x = 0; x < mPitch; ++x) {
-    int32_t val = (((int64_t)(*pBuf++) * (1 << 21)) + ((int64_t)1 << 31)) >> 32;
-    *pOut++ = (val < 0 ? 0 : (val > 255 ? 255 : val));
-  }
-
   if (mRow < mHeight) {
     updateRingBuffer();
   }
@@ -113,12 +106,17 @@ void Sharpener::putLine(const int32_t* pSrc) {
 }
 
 // =========================================
-// sharpen along x dimension
+// sharpen along x dimension, online
 void Sharpener::sharpenX(const int32_t* pSrc) {
   if (!pSrc) {
     return;
   }
-  int32_t* pBuf = mIntermediateRows[mTail].data();
+  sharpenRowX(pSrc, mIntermediateRows[mTail].data());
+}
+
+// =========================================
+// sharpen along x dimension
+void Sharpener::sharpenRowX(const int32_t* pSrc, int32_t* pBuf) const {
   const std::uint8_t ocomp = mOutputComponents;
   memset(pBuf, 0, mPitch * sizeof(int32_t));
   // first pixel
@@ -126,12 +124,15 @@ void Sharpener::sharpenX(const int32_t* pSrc) {
   AddWeightedPixelQ11(ocomp, pBuf, pSrc, KERNEL_Q11[1]);
   AddWeightedPixelQ11(ocomp, pBuf, pSrc + ocomp, KERNEL_Q11[2]);
   pBuf += ocomp;
-  // mid section
-  for (std::uint32_t x = 1; x < mWidth - 1; x++) {
-    AddWeightedPixelQ11(ocomp, pBuf, pSrc + ((x - 1) * ocomp), KERNEL_Q11[0]);
-    AddWeightedPixelQ11(ocomp, pBuf, pSrc + ((x)*ocomp), KERNEL_Q11[1]);
-    AddWeightedPixelQ11(ocomp, pBuf, pSrc + ((x + 1) * ocomp), KERNEL_Q11[2]);
-    pBuf += ocomp;
+  // mid section. each component only depends on the same component of the
+  // neighbouring pixels: the row is processed as a flat array
+  if (mWidth > 2) {
+    const auto& rowKernels = kernels::kernels();
+    const std::size_t n = (mWidth - 2) * ocomp;
+    rowKernels.addWeightedRowQ11(pBuf, pSrc, KERNEL_Q11[0], n);
+    rowKernels.addWeightedRowQ11(pBuf, pSrc + ocomp, KERNEL_Q11[1], n);
+    rowKernels.addWeightedRowQ11(pBuf, pSrc + 2 * ocomp, KERNEL_Q11[2], n);
+    pBuf += n;
   }
   // last pixel
   AddWeightedPixelQ11(
@@ -143,7 +144,7 @@ void Sharpener::sharpenX(const int32_t* pSrc) {
 }
 
 // =========================================
-// sharpen along y dimension
+// sharpen along y dimension, online
 void Sharpener::sharpenY() {
   // assign rows, handle edge cases
   int32_t* pRow0 = nullptr;
@@ -165,19 +166,27 @@ void Sharpener::sharpenY() {
     pRow2 = (mIntermediateRows[mTail].data());
   }
 
+  sharpenRowY(pRow0, pRow1, pRow2, mYSharpenBuffer.data(), mOutBufferPtr);
+}
+
+// =========================================
+// sharpen along y dimension
+void Sharpener::sharpenRowY(
+    const int32_t* pRow0,
+    const int32_t* pRow1,
+    const int32_t* pRow2,
+    int32_t* pAccumulator,
+    std::uint8_t* pOut) const {
+  const auto& rowKernels = kernels::kernels();
+
   // sharpen across y dimension
-  std::fill(mYSharpenBuffer.begin(), mYSharpenBuffer.end(), 0);
-  int32_t* pBuf = mYSharpenBuffer.data();
-
-  for (std::uint32_t x = 0; x < mWidth; ++x) {
-    AddWeightedPixelQ11(mOutputComponents, pBuf, pRow0, KERNEL_Q11[0]);
-    AddWeightedPixelQ11(mOutputComponents, pBuf, pRow1, KERNEL_Q11[1]);
-    AddWeightedPixelQ11(mOutputComponents, pBuf, pRow2, KERNEL_Q11[2]);
-    pBuf += mOutputComponents;
-    pRow0 += mOutputComponents;
-    pRow1 += mOutputComponents;
-    pRow2 += mOutputComponents;
-  }
+  std::fill(pAccumulator, pAccumulator + mPitch, 0);
+  rowKernels.addWeightedRowQ11(pAccumulator, pRow0, KERNEL_Q11[0], mPitch);
+  rowKernels.addWeightedRowQ11(pAccumulator, pRow1, KERNEL_Q11[1], mPitch);
+  rowKernels.addWeightedRowQ11(pAccumulator, pRow2, KERNEL_Q11[2], mPitch);
+
+  // convert from Q11 to std::uint8_t
+  rowKernels.convertRowQ11ToUint8(pAccumulator, pOut, mPitch);
 }
 
 // =========================================
@@ -39,6 +39,23 @@ class Sharpener {
   void putLine(const int32_t* pSrc);
   std::uint8_t* getLine(std::uint8_t* pOutBuffer = nullptr);
 
+  // =========================================
+  // stateless access to the individual passes. these can be used from several
+  // threads at once to sharpen independent stripes of the image
+
+  // sharpen a Q21.11 row in x dimension into pDst
+  void sharpenRowX(const int32_t* pSrc, int32_t* pDst) const;
+
+  // sharpen the x-sharpened rows above, at and below the current row in y
+  // dimension and convert the result to std::uint8_t. pAccumulator is scratch
+  // space of one row
+  void sharpenRowY(
+      const int32_t* pRow0,
+      const int32_t* pRow1,
+      const int32_t* pRow2,
+      int32_t* pAccumulator,
+      std::uint8_t* pOut) const;
+
  private:
   // consts
   static const std::size_t KERNEL_WIDTH = 3;
@@ -8,68 +8,165 @@
 #include <spectrum/Configuration.h>
 #include <spectrum/codecs/IDecompressor.h>
 #include <spectrum/core/Constants.h>
+#include <spectrum/core/Executor.h>
 #include <spectrum/core/SpectrumEnforce.h>
 #include <spectrum/core/decisions/BaseDecision.h>
 #include <spectrum/core/proc/CroppingScanlineProcessingBlock.h>
 #include <spectrum/core/proc/RotationScanlineProcessingBlock.h>
 #include <spectrum/core/proc/ScalingScanlineProcessingBlock.h>
+#include <spectrum/core/proc/ScanlineFanOut.h>
 #include <spectrum/core/proc/ScanlineConversion.h>
 #include <spectrum/core/proc/ScanlinePump.h>
+#include <spectrum/image/ScanlinePool.h>
 
 #include <folly/Optional.h>
 
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <vector>
 
 namespace facebook {
 namespace spectrum {
 namespace core {
 namespace recipes {
 
-image::Specification BaseRecipe::perform(const Operation& operation) const {
-  const auto& parameters = operation.parameters;
-  const auto decisions = decisions::BaseDecision::calculate(operation);
+namespace {
+/**
+ * The area of the sampled image that is kept by the crop decision.
+ */
+image::Rect cropRect(const decisions::BaseDecision& decisions) {
+  return decisions.resize.cropRequirement()->apply(
+      decisions.resize.sizeAfterSampling());
+}
 
-  // processing blocks
+/**
+ * Creates the crop, scale and rotate blocks (as needed) that turn the decoded
+ * scanlines into the scanlines to compress.
+ *
+ * @param decodedRegion The region of the sampled image the decompressor
+ * produces if it has been restricted to one.
+ */
+std::vector<std::unique_ptr<proc::ScanlineProcessingBlock>>
+makeProcessingBlocks(
+    const Operation& operation,
+    const decisions::BaseDecision& decisions,
+    const folly::Optional<image::Rect>& decodedRegion,
+    IExecutor* scalingExecutor) {
+  const auto& pixelSpecification =
+      operation.parameters.inputImageSpecification.pixelSpecification;
   std::vector<std::unique_ptr<proc::ScanlineProcessingBlock>> processingBlocks;
 
-  auto decompressor =
-      operation.makeDecompressor(decisions.resize.getSamplingRatio());
-
-  const auto scanlineGenerator = [&decompressor] {
-    return decompressor->readScanline();
-  };
-
-  // (1) cropping
+  // (1) cropping (relative to the decoded region)
   if (decisions.resize.shouldCrop()) {
-    const auto cropRequirement = decisions.resize.cropRequirement();
-    const auto croppingInput = decisions.resize.sizeAfterSampling();
-    processingBlocks.push_back(
-        std::make_unique<proc::CroppingScanlineProcessingBlock>(
-            parameters.inputImageSpecification.pixelSpecification,
-            croppingInput,
-            cropRequirement->apply(croppingInput)));
+    auto croppingInput = decisions.resize.sizeAfterSampling();
+    auto croppingRect = cropRect(decisions);
+    if (decodedRegion.hasValue()) {
+      croppingInput = decodedRegion->size;
+      croppingRect.topLeft.x -= decodedRegion->topLeft.x;
+      croppingRect.topLeft.y -= decodedRegion->topLeft.y;
+    }
+
+    if (croppingRect != image::Rect{image::pointZero, croppingInput}) {
+      processingBlocks.push_back(
+          std::make_unique<proc::CroppingScanlineProcessingBlock>(
+              pixelSpecification, croppingInput, croppingRect));
+    }
   }
 
   // (2) scaling
   if (decisions.resize.shouldScale()) {
     processingBlocks.push_back(
         std::make_unique<proc::ScalingScanlineProcessingBlock>(
-            parameters.inputImageSpecification.pixelSpecification,
+            pixelSpecification,
             decisions.resize.sizeAfterCropping(),
             decisions.resize.sizeAfterScaling(),
-            operation.configuration.general.samplingMethod()));
+            operation.configuration.general.samplingMethod(),
+            scalingExecutor,
+            operation.configuration.general.numberOfScalingThreads()));
   }
 
   // (3) rotation
   if (decisions.orientation.shouldRotatePixels()) {
     processingBlocks.push_back(
         std::make_unique<proc::RotationScanlineProcessingBlock>(
-            parameters.inputImageSpecification.pixelSpecification,
+            pixelSpecification,
             decisions.resize.sizeAfterScaling(),
             decisions.orientation.orientation));
   }
 
+  return processingBlocks;
+}
+
+/**
+ * Returns the consumer that converts the processed scanlines to the output
+ * pixel specification and writes them to the compressor.
+ */
+proc::ScanlinePump::ScanlineBatchConsumer makeScanlineConsumer(
+    const proc::ScanlineConverter& scanlineConverter,
+    codecs::ICompressor& compressor) {
+  return [&scanlineConverter,
+          &compressor](proc::ScanlinePump::Scanlines scanlines) {
+    for (auto& scanline : scanlines) {
+      scanline = scanlineConverter.convertScanline(std::move(scanline));
+    }
+    compressor.writeScanlines(std::move(scanlines));
+  };
+}
+
+/**
+ * Whether scaling the operation's image needs an executor for its stripes
+ * that the configuration doesn't provide.
+ */
+bool needsScalingExecutor(
+    const Operation& operation,
+    const decisions::BaseDecision& decisions) {
+  return operation.configuration.general.numberOfScalingThreads() > 1 &&
+      decisions.resize.shouldScale() &&
+      operation.configuration.general.scalingExecutor() == nullptr;
+}
+} // namespace
+
+image::Specification BaseRecipe::perform(const Operation& operation) const {
+  const auto& parameters = operation.parameters;
+  const auto decisions = decisions::BaseDecision::calculate(operation);
+  const auto usePipelining = operation.configuration.general.usePipelining();
+
+  // scanlines are recycled between all stages of the chain. pipelined stages
+  // run on different threads and thus cannot share a pool
+  image::ScanlinePool ownScanlinePool;
+  auto& scanlinePool = operation.scanlinePool != nullptr
+      ? *operation.scanlinePool
+      : ownScanlinePool;
+  image::ScanlinePool processingScanlinePool;
+
+  // executor for the scaling stripes. outlives the processing blocks which
+  // wait for their pending stripes
+  auto scalingExecutor = operation.configuration.general.scalingExecutor();
+  if (needsScalingExecutor(operation, decisions)) {
+    scalingExecutor = std::make_shared<ThreadPoolExecutor>(
+        operation.configuration.general.numberOfScalingThreads());
+  }
+
+  auto decompressor =
+      operation.makeDecompressor(decisions.resize.getSamplingRatio());
+  decompressor->setScanlinePool(usePipelining ? nullptr : &scanlinePool);
+
+  // rows and columns that are cropped away need not be decoded
+  folly::Optional<image::Rect> decodedRegion;
+  if (decisions.resize.shouldCrop()) {
+    decodedRegion = decompressor->setRegionOfInterest(cropRect(decisions));
+  }
+
+  // processing blocks
+  auto processingBlocks = makeProcessingBlocks(
+      operation, decisions, decodedRegion, scalingExecutor.get());
+
+  const auto scanlineGenerator =
+      [&decompressor](const std::size_t numberOfScanlines) {
+        return decompressor->readScanlines(numberOfScanlines);
+      };
+
   auto compressor =
       operation.makeCompressor(decisions.outputImageSpecification);
 
@@ -77,25 +174,140 @@ image::Specification BaseRecipe::perform(const Operation& operation) const {
       parameters.inputImageSpecification.pixelSpecification,
       decisions.outputImageSpecification.pixelSpecification,
       operation.configuration.general.defaultBackgroundColor());
-
-  // scanline consumer
-  const auto scanlineConsumer = [scanlineConverter = scanlineConverter.get(),
-                                 &compressor = *compressor](auto scanline) {
-    compressor.writeScanline(
-        scanlineConverter->convertScanline(std::move(scanline)));
-  };
+  scanlineConverter->setScanlinePool(&scanlinePool);
 
   // run chain
   proc::ScanlinePump scanlinePump(
       scanlineGenerator,
       std::move(processingBlocks),
-      scanlineConsumer,
-      decompressor->outputImageSpecification().size.height);
-  scanlinePump.pumpAll();
+      makeScanlineConsumer(*scanlineConverter, *compressor),
+      decompressor->outputImageSpecification().size.height,
+      proc::ScanlinePump::DefaultBatchSize,
+      usePipelining ? &processingScanlinePool : &scanlinePool);
+  if (usePipelining) {
+    scanlinePump.pumpAllPipelined();
+  } else {
+    scanlinePump.pumpAll();
+  }
 
   return decisions.outputImageSpecification;
 }
 
+std::vector<image::Specification> BaseRecipe::performMultiple(
+    const std::vector<Operation>& operations) const {
+  SPECTRUM_ENFORCE_IF(operations.empty());
+  const auto& operation = operations.front();
+
+  // decode once with the sampling ratio all outputs can be derived from
+  const auto samplingRatio =
+      decisions::BaseDecision::calculateCommonSamplingRatio(operations);
+  std::vector<decisions::BaseDecision> branchDecisions;
+  branchDecisions.reserve(operations.size());
+  for (const auto& branchOperation : operations) {
+    branchDecisions.push_back(
+        decisions::BaseDecision::calculate(branchOperation, samplingRatio));
+  }
+
+  image::ScanlinePool scanlinePool;
+
+  // a single executor is shared by all branches that need one
+  std::shared_ptr<IExecutor> ownedScalingExecutor;
+  for (std::size_t i = 0; i < operations.size(); ++i) {
+    if (ownedScalingExecutor == nullptr &&
+        needsScalingExecutor(operations[i], branchDecisions[i])) {
+      ownedScalingExecutor = std::make_shared<ThreadPoolExecutor>(
+          operations[i].configuration.general.numberOfScalingThreads());
+    }
+  }
+
+  auto decompressor = operation.makeDecompressor(samplingRatio);
+  decompressor->setScanlinePool(&scanlinePool);
+
+  // only decode the area that's kept by any of the crops, if all outputs crop
+  folly::Optional<image::Rect> regionOfInterest;
+  for (const auto& decisions : branchDecisions) {
+    if (!decisions.resize.shouldCrop()) {
+      regionOfInterest = folly::none;
+      break;
+    }
+
+    const auto rect = cropRect(decisions);
+    if (!regionOfInterest.hasValue()) {
+      regionOfInterest = rect;
+    } else {
+      const auto minX = std::min(regionOfInterest->minX(), rect.minX());
+      const auto minY = std::min(regionOfInterest->minY(), rect.minY());
+      const auto maxX = std::max(regionOfInterest->maxX(), rect.maxX());
+      const auto maxY = std::max(regionOfInterest->maxY(), rect.maxY());
+      regionOfInterest = image::Rect{
+          .topLeft = {.x = minX, .y = minY},
+          .size = {.width = maxX - minX, .height = maxY - minY},
+      };
+    }
+  }
+
+  folly::Optional<image::Rect> decodedRegion;
+  if (regionOfInterest.hasValue()) {
+    decodedRegion = decompressor->setRegionOfInterest(*regionOfInterest);
+  }
+
+  // one branch of blocks, converter and compressor per output
+  std::vector<std::unique_ptr<codecs::ICompressor>> compressors;
+  std::vector<std::unique_ptr<proc::ScanlineConverter>> scanlineConverters;
+  std::vector<proc::ScanlineFanOut::Branch> branches;
+  for (std::size_t i = 0; i < operations.size(); ++i) {
+    const auto& branchOperation = operations[i];
+    const auto& decisions = branchDecisions[i];
+
+    auto scalingExecutor =
+        branchOperation.configuration.general.scalingExecutor();
+    auto blocks = makeProcessingBlocks(
+        branchOperation,
+        decisions,
+        decodedRegion,
+        scalingExecutor != nullptr ? scalingExecutor.get()
+                                   : ownedScalingExecutor.get());
+
+    compressors.push_back(
+        branchOperation.makeCompressor(decisions.outputImageSpecification));
+    scanlineConverters.push_back(proc::makeScanlineConverter(
+        branchOperation.parameters.inputImageSpecification.pixelSpecification,
+        decisions.outputImageSpecification.pixelSpecification,
+        branchOperation.configuration.general.defaultBackgroundColor()));
+    scanlineConverters.back()->setScanlinePool(&scanlinePool);
+
+    branches.push_back(proc::ScanlineFanOut::Branch{
+        std::move(blocks),
+        makeScanlineConsumer(*scanlineConverters.back(), *compressors.back()),
+    });
+  }
+
+  proc::ScanlineFanOut fanOut(
+      std::move(branches), proc::ScanlinePump::DefaultBatchSize, &scanlinePool);
+
+  // run chain
+  proc::ScanlinePump scanlinePump(
+      [&decompressor](const std::size_t numberOfScanlines) {
+        return decompressor->readScanlines(numberOfScanlines);
+      },
+      {},
+      [&fanOut](proc::ScanlinePump::Scanlines scanlines) {
+        fanOut.consume(std::move(scanlines));
+      },
+      decompressor->outputImageSpecification().size.height,
+      proc::ScanlinePump::DefaultBatchSize,
+      &scanlinePool);
+  scanlinePump.pumpAll();
+  fanOut.finish();
+
+  std::vector<image::Specification> outputImageSpecifications;
+  outputImageSpecifications.reserve(branchDecisions.size());
+  for (const auto& decisions : branchDecisions) {
+    outputImageSpecifications.push_back(decisions.outputImageSpecification);
+  }
+  return outputImageSpecifications;
+}
+
 Rule BaseRecipe::makeRule() {
   return Rule{
       .name = "base",
@@ -8,6 +8,8 @@
 #include <spectrum/Recipe.h>
 #include <spectrum/Rule.h>
 
+#include <vector>
+
 namespace facebook {
 namespace spectrum {
 namespace core {
@@ -17,6 +19,17 @@ class BaseRecipe : public Recipe {
  public:
   image::Specification perform(const core::Operation& operation) const override;
 
+  /**
+   * Performs operations that share the same encoded source by decoding it
+   * only once. The decoded scanlines are handed to one branch of processing
+   * blocks and compressor per operation. The source is decoded with the
+   * first operation's decompressor and configuration.
+   *
+   * @return The output image specification of each operation, in order.
+   */
+  std::vector<image::Specification> performMultiple(
+      const std::vector<core::Operation>& operations) const;
+
   static Rule makeRule();
 };
 
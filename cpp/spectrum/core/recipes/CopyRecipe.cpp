@@ -16,6 +16,8 @@ namespace recipes {
 
 image::Specification CopyRecipe::perform(
     const core::Operation& operation) const {
+  operation.rewindSource();
+
   std::array<char, core::DefaultBufferSize> buffer;
 
   std::size_t numReadBytes = 0;
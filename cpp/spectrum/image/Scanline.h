@@ -9,6 +9,7 @@
 #include <spectrum/image/Pixel.h>
 
 #include <algorithm>
+#include <memory>
 #include <vector>
 
 namespace facebook {
@@ -18,25 +19,101 @@ namespace image {
 /**
  * A scanline represents a _horizontal_ line of the image. This wrapper allows
  * to exchange the underlying representation if needed.
+ *
+ * A scanline either owns its bytes or is a view that borrows them from memory
+ * owned by someone else (e.g. a decoder's frame buffer or a parent scanline).
+ * Views allow stages to hand rows on without copying them.
  */
 class Scanline {
  private:
-  const pixel::Specification _specification;
+  pixel::Specification _specification;
   std::vector<std::uint8_t> _bytes;
   std::size_t _width;
+  std::uint8_t* _data;
+
+  // keeps borrowed memory alive for views
+  std::unique_ptr<Scanline> _parent;
+  std::shared_ptr<const void> _owner;
+  bool _isView{false};
 
  public:
   Scanline(const pixel::Specification& specification, const std::size_t width)
       : _specification(specification),
         _bytes(specification.bytesPerPixel * width),
-        _width(width){};
+        _width(width),
+        _data(_bytes.data()){};
+
+  /**
+   * Creates a view of `width` pixels starting at `data`. The caller must
+   * ensure that `owner` keeps the memory alive.
+   */
+  Scanline(
+      const pixel::Specification& specification,
+      std::uint8_t* data,
+      const std::size_t width,
+      std::shared_ptr<const void> owner)
+      : _specification(specification),
+        _width(width),
+        _data(data),
+        _owner(std::move(owner)),
+        _isView(true){};
+
+  /**
+   * Creates a view of `width` pixels of `parent` starting at pixel `offset`.
+   * The view takes ownership of its parent.
+   */
+  Scanline(
+      std::unique_ptr<Scanline> parent,
+      const std::size_t offset,
+      const std::size_t width)
+      : _specification(parent->specification()),
+        _width(width),
+        _data(parent->dataAtPixel(offset)),
+        _parent(std::move(parent)),
+        _isView(true) {
+    SPECTRUM_ENFORCE_IF_NOT(offset + width <= _parent->width());
+  };
+
+  Scanline(Scanline&&) = default;
+  Scanline& operator=(Scanline&&) = default;
+
+  /**
+   * Copies always own their bytes.
+   */
+  Scanline(const Scanline& rhs)
+      : _specification(rhs._specification),
+        _bytes(rhs.data(), rhs.data() + rhs.sizeBytes()),
+        _width(rhs._width),
+        _data(_bytes.data()) {}
+
+  Scanline& operator=(const Scanline& rhs) {
+    if (this != &rhs) {
+      *this = Scanline(rhs);
+    }
+    return *this;
+  }
+
+  /**
+   * Whether the scanline borrows its bytes instead of owning them.
+   */
+  inline bool isView() const noexcept {
+    return _isView;
+  }
+
+  /**
+   * Releases the scanline a view was created from, if any. The view must not
+   * be used afterwards.
+   */
+  std::unique_ptr<Scanline> takeParent() noexcept {
+    return std::move(_parent);
+  }
 
   /**
    * The size of the scanline in bytes in memory. It is safe to use this as the
    * limit when accessing the raw bytes using `data()`.
    */
   inline std::size_t sizeBytes() const noexcept {
-    return _bytes.size();
+    return _width * _specification.bytesPerPixel;
   }
 
   /**
@@ -46,12 +123,23 @@ class Scanline {
     return _specification;
   }
 
+  /**
+   * Changes the specification the scanline's bytes are interpreted with. The
+   * bytes are left untouched, hence the new specification must have the same
+   * number of bytes per pixel.
+   */
+  void reinterpretAs(const pixel::Specification& specification) {
+    SPECTRUM_ENFORCE_IF_NOT(
+        specification.bytesPerPixel == _specification.bytesPerPixel);
+    _specification = specification;
+  }
+
   /**
    * Provides a raw pointer to the bytes in the scanline. The scanline's data is
    * guranteed to be consecutive and there are exactly `sizeBytes` available.
    */
   inline const std::uint8_t* data() const noexcept {
-    return _bytes.data();
+    return _data;
   }
 
   /**
@@ -59,7 +147,7 @@ class Scanline {
    * guranteed to be consecutive and there are exactly `sizeBytes` available.
    */
   inline std::uint8_t* data() noexcept {
-    return _bytes.data();
+    return _data;
   }
 
   /**
@@ -67,7 +155,7 @@ class Scanline {
    * safe to read `_specification.bytesPerPixel` bytes from there.
    */
   inline std::uint8_t* dataAtPixel(const std::size_t index) noexcept {
-    return _bytes.data() + (index * _specification.bytesPerPixel);
+    return _data + (index * _specification.bytesPerPixel);
   }
 
   /**
@@ -76,7 +164,7 @@ class Scanline {
    */
   inline const std::uint8_t* dataAtPixel(
       const std::size_t index) const noexcept {
-    return _bytes.data() + (index * _specification.bytesPerPixel);
+    return _data + (index * _specification.bytesPerPixel);
   }
 
   /**
@@ -0,0 +1,83 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "ScanlinePool.h"
+
+#include <spectrum/core/SpectrumEnforce.h>
+
+namespace facebook {
+namespace spectrum {
+namespace image {
+
+ScanlinePool::ScanlinePool(const std::size_t maximumNumberOfScanlines)
+    : _maximumNumberOfScanlines(maximumNumberOfScanlines) {}
+
+std::unique_ptr<Scanline> ScanlinePool::acquire(
+    const pixel::Specification& specification,
+    const std::size_t width) {
+  auto bucket = _bucketFor(specification, width);
+
+  if (bucket == nullptr || bucket->scanlines.empty()) {
+    return std::make_unique<Scanline>(specification, width);
+  }
+
+  auto scanline = std::move(bucket->scanlines.back());
+  bucket->scanlines.pop_back();
+  _size--;
+
+  return scanline;
+}
+
+void ScanlinePool::release(std::unique_ptr<Scanline> scanline) {
+  SPECTRUM_ENFORCE_IF_NOT(scanline);
+
+  // views don't own their bytes: recycle the scanline they were created from
+  // instead, if any
+  if (scanline->isView()) {
+    auto parent = scanline->takeParent();
+    if (parent != nullptr) {
+      release(std::move(parent));
+    }
+    return;
+  }
+
+  if (_size >= _maximumNumberOfScanlines) {
+    return;
+  }
+
+  const auto specification = scanline->specification();
+  const auto width = scanline->width();
+  auto bucket = _bucketFor(specification, width);
+
+  if (bucket == nullptr) {
+    _buckets.push_back(Bucket{specification, width, {}});
+    bucket = &_buckets.back();
+  }
+
+  bucket->scanlines.push_back(std::move(scanline));
+  _size++;
+}
+
+std::size_t ScanlinePool::size() const noexcept {
+  return _size;
+}
+
+ScanlinePool::Bucket* ScanlinePool::_bucketFor(
+    const pixel::Specification& specification,
+    const std::size_t width) {
+  // pipelines only deal with a handful of distinct scanline shapes, hence a
+  // linear search is cheaper than any associative container
+  for (auto& bucket : _buckets) {
+    if (bucket.width == width && bucket.specification == specification) {
+      return &bucket;
+    }
+  }
+
+  return nullptr;
+}
+
+} // namespace image
+} // namespace spectrum
+} // namespace facebook
@@ -0,0 +1,108 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <spectrum/image/Pixel.h>
+#include <spectrum/image/Scanline.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace facebook {
+namespace spectrum {
+namespace image {
+
+/**
+ * A scanline pool recycles scanlines so that the stages of a pipeline don't
+ * have to allocate a new scanline for each row they emit. Scanlines are only
+ * handed out again for the exact same pixel specification and width.
+ *
+ * @note The pool is not thread-safe and is meant to be shared by the stages of
+ * a single operation.
+ */
+class ScanlinePool {
+ public:
+  static constexpr std::size_t DefaultMaximumNumberOfScanlines = 64;
+
+  /**
+   * Creates a new empty pool.
+   *
+   * @param maximumNumberOfScanlines The maximum number of unused scanlines the
+   * pool retains. Scanlines released beyond that are freed.
+   */
+  explicit ScanlinePool(
+      const std::size_t maximumNumberOfScanlines =
+          DefaultMaximumNumberOfScanlines);
+
+  ScanlinePool(const ScanlinePool&) = delete;
+  ScanlinePool& operator=(const ScanlinePool&) = delete;
+
+  /**
+   * Returns a scanline of the given specification and width. A previously
+   * released scanline is reused if possible, in which case its content is
+   * unspecified.
+   */
+  std::unique_ptr<Scanline> acquire(
+      const pixel::Specification& specification,
+      const std::size_t width);
+
+  /**
+   * Hands a scanline that is not needed anymore back to the pool. Views are
+   * never retained but the scanline they were created from is.
+   */
+  void release(std::unique_ptr<Scanline> scanline);
+
+  /**
+   * The number of unused scanlines currently retained by the pool.
+   */
+  std::size_t size() const noexcept;
+
+ private:
+  struct Bucket {
+    pixel::Specification specification;
+    std::size_t width;
+    std::vector<std::unique_ptr<Scanline>> scanlines;
+  };
+
+  Bucket* _bucketFor(
+      const pixel::Specification& specification,
+      const std::size_t width);
+
+  const std::size_t _maximumNumberOfScanlines;
+  std::vector<Bucket> _buckets;
+  std::size_t _size{0};
+};
+
+/**
+ * Returns a scanline from the pool if there is one or a newly allocated
+ * scanline otherwise.
+ */
+inline std::unique_ptr<Scanline> makeScanline(
+    ScanlinePool* scanlinePool,
+    const pixel::Specification& specification,
+    const std::size_t width) {
+  if (scanlinePool != nullptr) {
+    return scanlinePool->acquire(specification, width);
+  } else {
+    return std::make_unique<Scanline>(specification, width);
+  }
+}
+
+/**
+ * Hands the scanline back to the pool if there is one or frees it otherwise.
+ */
+inline void releaseScanline(
+    ScanlinePool* scanlinePool,
+    std::unique_ptr<Scanline> scanline) {
+  if (scanlinePool != nullptr && scanline != nullptr) {
+    scanlinePool->release(std::move(scanline));
+  }
+}
+
+} // namespace image
+} // namespace spectrum
+} // namespace facebook
@@ -263,6 +263,75 @@ void Entries::setOrientation(
   }
 }
 
+//
+// Thumbnail
+//
+
+folly::Optional<core::DataRange> Entries::findThumbnail(
+    const void* const address,
+    const std::size_t dataLength) {
+  if (address == nullptr || dataLength < sizeof(MemoryLayout) ||
+      dataLength > MAX_DATA_LENGTH) {
+    return folly::none;
+  }
+
+  try {
+    const auto& layout = *reinterpret_cast<const MemoryLayout*>(address);
+    layout.ensureExpectedLayout(dataLength);
+
+    const ReadContext context(
+        reinterpret_cast<const std::uint8_t*>(&layout),
+        dataLength,
+        layout.tiffHeaderBegin(),
+        layout.littleEndianEncoded());
+
+    // the offset of the 1st IFD follows the entries of the 0th IFD
+    const auto ifd0Begin = context.tiffHeaderBegin + layout.firstIfdOffset();
+    SPECTRUM_ERROR_IF(
+        ifd0Begin + sizeof(std::uint16_t) > context.dataEnd,
+        error::DataNotLargeEnough);
+    const auto countOfEntries = core::utils::convertValueToNativeByteOrder(
+        *reinterpret_cast<const std::uint16_t*>(ifd0Begin),
+        context.isLittleEndianEncoded);
+
+    const auto nextIfdOffsetAddress = ifd0Begin + sizeof(std::uint16_t) +
+        countOfEntries * sizeof(Entry::MemoryLayout);
+    SPECTRUM_ERROR_IF(
+        nextIfdOffsetAddress + sizeof(std::uint32_t) > context.dataEnd,
+        error::DataNotLargeEnough);
+    const auto ifd1Offset = core::utils::convertValueToNativeByteOrder(
+        *reinterpret_cast<const std::uint32_t*>(nextIfdOffsetAddress),
+        context.isLittleEndianEncoded);
+    if (ifd1Offset == 0) {
+      return folly::none;
+    }
+
+    Entry::TagMap ifd1;
+    Entry::parseFromAddressIntoTagMap(
+        context, context.tiffHeaderBegin + ifd1Offset, ifd1);
+
+    const auto offsetIterator = ifd1.find(Entry::JPEG_INTERCHANGE_FORMAT);
+    const auto lengthIterator =
+        ifd1.find(Entry::JPEG_INTERCHANGE_FORMAT_LENGTH);
+    if (offsetIterator == ifd1.end() || lengthIterator == ifd1.end()) {
+      return folly::none;
+    }
+
+    const std::size_t offset = offsetIterator->second.valueAsShortOrLong();
+    const std::size_t length = lengthIterator->second.valueAsShortOrLong();
+    const auto availableLength =
+        static_cast<std::size_t>(context.dataEnd - context.tiffHeaderBegin);
+    if (length == 0 || offset > availableLength ||
+        length > availableLength - offset) {
+      return folly::none;
+    }
+
+    return core::DataRange{context.tiffHeaderBegin + offset, length};
+  } catch (const SpectrumException&) {
+    return folly::none;
+  }
+}
+
 //
 // Writing
 //
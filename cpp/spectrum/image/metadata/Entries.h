@@ -93,6 +93,20 @@ class Entries {
   folly::Optional<image::Orientation> orientation() const;
   void setOrientation(const folly::Optional<image::Orientation>& orientation);
 
+  /**
+   * Locates the JPEG thumbnail embedded in the 1st IFD of EXIF data. The
+   * thumbnail isn't part of the parsed entries and is dropped when writing
+   * them.
+   *
+   * @param address The start of the EXIF data.
+   * @param dataLength The length of the EXIF data.
+   * @return The thumbnail's encoded bytes within the EXIF data, or folly::none
+   * if the data isn't valid EXIF or doesn't contain a thumbnail.
+   */
+  static folly::Optional<core::DataRange> findThumbnail(
+      const void* const address,
+      const std::size_t dataLength);
+
   /**
    * Merges other with this. Values in `other` will override values in self if
    * both are present.
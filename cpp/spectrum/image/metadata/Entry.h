@@ -50,6 +50,10 @@ struct Entry {
     EXIF_IFD_POINTER = 0x8769,
     GPS_INFO_IFD_POINTER = 0x8825,
 
+    // Thumbnail (1st IFD)
+    JPEG_INTERCHANGE_FORMAT = 0x201,
+    JPEG_INTERCHANGE_FORMAT_LENGTH = 0x202,
+
     // Support 2
     EXPOSURE_TIME = 0x829A,
     F_NUMBER = 0x829D,
@@ -9,22 +9,147 @@
 #include <spectrum/core/SpectrumEnforce.h>
 #include <spectrum/io/IImageSink.h>
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <cstddef>
-#include <fstream>
-#include <stdexcept>
 #include <string>
 
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 namespace facebook {
 namespace spectrum {
 namespace io {
 
-FileImageSink::FileImageSink(const std::string& path)
-    : IEncodedImageSink(), ofs(path, std::fstream::binary) {
-  SPECTRUM_ERROR_IF_NOT(ofs, error::ImageSinkFailure);
+namespace {
+void reserveSpace(const int fileDescriptor, const std::size_t size) {
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+  // only a hint: failing (e.g. on file systems without support) is fine
+  ::fallocate(fileDescriptor, FALLOC_FL_KEEP_SIZE, 0, size);
+#else
+  (void)fileDescriptor;
+  (void)size;
+#endif
+}
+} // namespace
+
+FileImageSink::FileImageSink(
+    const std::string& path,
+    const FileImageSinkOptions& options)
+    : IEncodedImageSink(),
+      ownsFileDescriptor(true),
+      bufferSize(options.bufferSize) {
+  fileDescriptor =
+      ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  SPECTRUM_ERROR_IF(fileDescriptor < 0, error::ImageSinkFailure);
+
+  if (options.expectedSize.hasValue()) {
+    reserveSpace(fileDescriptor, *options.expectedSize);
+  }
+  buffer.reserve(bufferSize);
+}
+
+FileImageSink::FileImageSink(
+    const int fileDescriptor,
+    const FileImageSinkOptions& options)
+    : IEncodedImageSink(),
+      fileDescriptor(fileDescriptor),
+      bufferSize(options.bufferSize) {
+  SPECTRUM_ERROR_IF(fileDescriptor < 0, error::ImageSinkFailure);
+
+  if (options.expectedSize.hasValue()) {
+    reserveSpace(fileDescriptor, *options.expectedSize);
+  }
+  buffer.reserve(bufferSize);
+}
+
+FileImageSink::FileImageSink(FileImageSink&& other) noexcept
+    : IEncodedImageSink(std::move(other)),
+      fileDescriptor(other.fileDescriptor),
+      ownsFileDescriptor(other.ownsFileDescriptor),
+      bufferSize(other.bufferSize),
+      buffer(std::move(other.buffer)) {
+  other.fileDescriptor = -1;
+  other.ownsFileDescriptor = false;
+  other.buffer.clear();
+}
+
+FileImageSink::~FileImageSink() {
+  if (fileDescriptor < 0) {
+    return;
+  }
+
+  try {
+    flush();
+  } catch (...) {
+    // destructors cannot report errors: call flush() to observe them
+  }
+
+  if (ownsFileDescriptor) {
+    ::close(fileDescriptor);
+  }
 }
 
 void FileImageSink::_write(const char* const source, const std::size_t length) {
-  ofs.write(source, length);
+  if (buffer.size() + length <= bufferSize) {
+    buffer.insert(buffer.end(), source, source + length);
+    return;
+  }
+
+  // the pending bytes and the new ones go out with a single system call
+  writeToFile(buffer.data(), buffer.size(), source, length);
+  buffer.clear();
+}
+
+void FileImageSink::flush() {
+  writeToFile(buffer.data(), buffer.size());
+  buffer.clear();
+}
+
+void FileImageSink::writeToFile(
+    const char* const source,
+    const std::size_t length,
+    const char* const extraSource,
+    const std::size_t extraLength) {
+  std::array<struct iovec, 2> vectors{{
+      {const_cast<char*>(source), length},
+      {const_cast<char*>(extraSource), extraLength},
+  }};
+  auto* vector = vectors.data();
+  auto numberOfVectors = static_cast<int>(vectors.size());
+
+  while (numberOfVectors > 0) {
+    if (vector->iov_len == 0) {
+      ++vector;
+      --numberOfVectors;
+      continue;
+    }
+
+    const auto result = ::writev(fileDescriptor, vector, numberOfVectors);
+
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+
+    SPECTRUM_ERROR_IF(result <= 0, error::ImageSinkFailure);
+
+    // skip what has been written, which might end within a vector
+    auto bytesWritten = static_cast<std::size_t>(result);
+    while (bytesWritten > 0) {
+      const auto bytesWrittenFromVector =
+          std::min(bytesWritten, vector->iov_len);
+      vector->iov_base =
+          static_cast<char*>(vector->iov_base) + bytesWrittenFromVector;
+      vector->iov_len -= bytesWrittenFromVector;
+      bytesWritten -= bytesWrittenFromVector;
+      if (vector->iov_len == 0) {
+        ++vector;
+        --numberOfVectors;
+      }
+    }
+  }
 }
 
 void FileImageSink::setConfiguration(
@@ -5,22 +5,52 @@
 
 #pragma once
 
+#include <spectrum/core/Constants.h>
 #include <spectrum/io/IEncodedImageSink.h>
 
+#include <folly/Optional.h>
+
 #include <cstddef>
-#include <fstream>
 #include <string>
+#include <vector>
 
 namespace facebook {
 namespace spectrum {
 namespace io {
 
+struct FileImageSinkOptions {
+  /**
+   * Writes are coalesced until this many bytes are pending. A value of 0
+   * writes every chunk straight to the file.
+   */
+  std::size_t bufferSize = 16 * core::DefaultBufferSize;
+
+  /**
+   * If set, this much space is reserved for the file upfront (where supported)
+   * to avoid fragmentation. The file's size is not changed by this.
+   */
+  folly::Optional<std::size_t> expectedSize;
+};
+
 /**
- * An encoded image sink that writes into a file at the specific path.
+ * An encoded image sink that writes into a file at the specific path or to an
+ * open file descriptor.
+ *
+ * Pending bytes are written when the buffer is full, on flush() and on
+ * destruction. Errors can only be observed through write() and flush().
  */
 class FileImageSink : public IEncodedImageSink {
  private:
-  std::ofstream ofs;
+  int fileDescriptor = -1;
+  bool ownsFileDescriptor = false;
+  std::size_t bufferSize = 0;
+  std::vector<char> buffer;
+
+  void writeToFile(
+      const char* const source,
+      const std::size_t length,
+      const char* const extraSource = nullptr,
+      const std::size_t extraLength = 0);
 
  public:
   /**
@@ -30,21 +60,34 @@ class FileImageSink : public IEncodedImageSink {
    * @throws SpectrumException if the output stream cannot be initialized
    * (e.g. insufficient permissions, ...).
    */
-  explicit FileImageSink(const std::string& path);
+  explicit FileImageSink(
+      const std::string& path,
+      const FileImageSinkOptions& options = FileImageSinkOptions());
+
+  /**
+   * Creates a file image sink that writes to the given file descriptor at its
+   * current offset. The file descriptor is not closed by the sink.
+   */
+  explicit FileImageSink(
+      const int fileDescriptor,
+      const FileImageSinkOptions& options = FileImageSinkOptions());
+
   FileImageSink(const FileImageSink&) = delete;
-#if !defined(__ANDROID__) || defined(_LIBCPP_VERSION)
-  // gnustl doesn't mark std::ofstream as movable, and since we have a
-  // std::ofstream member variable we can't then use the default move
-  // constructor. We can remove the conditional after we've switched to libc++.
-  FileImageSink(FileImageSink&&) = default;
-#endif
+  FileImageSink(FileImageSink&& other) noexcept;
 
-  ~FileImageSink() override = default;
+  ~FileImageSink() override;
 
   void setConfiguration(
       const image::Size& imageSize,
       const image::pixel::Specification& pixelSpecification) override;
 
+  /**
+   * Writes all pending bytes to the file.
+   *
+   * @throws SpectrumException if writing fails.
+   */
+  void flush();
+
  protected:
   void _write(const char* const source, const std::size_t length) override;
 };
@@ -9,41 +9,120 @@
 #include <spectrum/core/SpectrumEnforce.h>
 #include <spectrum/io/IImageSource.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
-#include <fstream>
-#include <stdexcept>
+#include <cstring>
 #include <string>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace facebook {
 namespace spectrum {
 namespace io {
 
-FileImageSource::FileImageSource(const std::string& path)
-    : IEncodedImageSource(), ifs(path, std::fstream::binary) {
-  SPECTRUM_ERROR_IF_NOT(ifs, error::ImageSourceFailure);
+FileImageSource::FileImageSource(
+    const std::string& path,
+    const bool memoryMap)
+    : IEncodedImageSource() {
+  fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  SPECTRUM_ERROR_IF(fileDescriptor < 0, error::ImageSourceFailure);
+
+  struct stat fileStatus;
+  if (::fstat(fileDescriptor, &fileStatus) != 0 ||
+      !S_ISREG(fileStatus.st_mode)) {
+    ::close(fileDescriptor);
+    SPECTRUM_ERROR(error::ImageSourceFailure);
+  }
+  fileSize = static_cast<std::size_t>(fileStatus.st_size);
+
+  // empty files cannot be mapped and are served by pread as well
+  if (memoryMap && fileSize > 0) {
+    void* const address =
+        ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (address != MAP_FAILED) {
+      mapping = static_cast<const std::uint8_t*>(address);
+      ::madvise(address, fileSize, MADV_SEQUENTIAL);
+    }
+  }
+}
+
+FileImageSource::FileImageSource(FileImageSource&& other) noexcept
+    : IEncodedImageSource(std::move(other)),
+      fileDescriptor(other.fileDescriptor),
+      fileSize(other.fileSize),
+      mapping(other.mapping),
+      totalBytesRead(other.totalBytesRead) {
+  other.fileDescriptor = -1;
+  other.mapping = nullptr;
+}
+
+FileImageSource::~FileImageSource() {
+  if (mapping != nullptr) {
+    ::munmap(const_cast<std::uint8_t*>(mapping), fileSize);
+  }
+
+  if (fileDescriptor >= 0) {
+    ::close(fileDescriptor);
+  }
 }
 
 std::size_t FileImageSource::read(
     char* const destination,
     const std::size_t length) {
-  this->ifs.read(destination, length);
+  const auto bytesToRead = std::min(length, available());
 
-  const std::size_t bytesRead = this->ifs.gcount();
-  this->totalBytesRead += bytesRead;
+  if (mapping != nullptr) {
+    std::memcpy(destination, mapping + totalBytesRead, bytesToRead);
+    totalBytesRead += bytesToRead;
+    return bytesToRead;
+  }
 
+  std::size_t bytesRead = 0;
+  while (bytesRead < bytesToRead) {
+    const auto result = ::pread(
+        fileDescriptor,
+        destination + bytesRead,
+        bytesToRead - bytesRead,
+        totalBytesRead + bytesRead);
+
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+
+    SPECTRUM_ERROR_IF(result < 0, error::ImageSourceFailure);
+
+    if (result == 0) {
+      // the file has been truncated since it was opened
+      break;
+    }
+
+    bytesRead += static_cast<std::size_t>(result);
+  }
+
+  totalBytesRead += bytesRead;
   return bytesRead;
 }
 
 std::size_t FileImageSource::available() {
-  const auto originalPosition = ifs.tellg();
-  SPECTRUM_ENFORCE_IF_NOT(originalPosition >= 0);
+  return fileSize - std::min(totalBytesRead, fileSize);
+}
 
-  // seek to end position of input file stream
-  ifs.seekg(0, ifs.end);
-  const auto endPosition = ifs.tellg();
+folly::Optional<folly::ByteRange> FileImageSource::contiguousBytes() {
+  if (mapping == nullptr) {
+    return folly::none;
+  }
+
+  return folly::ByteRange{mapping + totalBytesRead, mapping + fileSize};
+}
 
-  ifs.seekg(originalPosition, ifs.beg);
-  return endPosition - originalPosition;
+std::size_t FileImageSource::skip(const std::size_t length) {
+  const auto bytesToSkip = std::min(length, available());
+  totalBytesRead += bytesToSkip;
+  return bytesToSkip;
 }
 
 std::size_t FileImageSource::getTotalBytesRead() const {
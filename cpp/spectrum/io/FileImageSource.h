@@ -8,7 +8,7 @@
 #include <spectrum/io/IEncodedImageSource.h>
 
 #include <cstddef>
-#include <fstream>
+#include <cstdint>
 #include <string>
 
 namespace facebook {
@@ -17,33 +17,45 @@ namespace io {
 
 /**
  * An encoded image source that reads from a file at the specific path.
+ *
+ * The file is read with pread by default. When memory mapping is requested
+ * and possible, consumers can access its content without copying (see
+ * contiguousBytes()).
+ *
+ * Memory mapping is only safe for files that are not modified while they are
+ * being read: if a mapped file is truncated, accessing its former content
+ * raises SIGBUS instead of failing with error::ImageSourceFailure.
  */
 class FileImageSource : public IEncodedImageSource {
  private:
-  std::ifstream ifs;
+  int fileDescriptor = -1;
+  std::size_t fileSize = 0;
+  const std::uint8_t* mapping = nullptr;
   std::size_t totalBytesRead = 0;
 
  public:
   /**
    * Creates a file image source for the given path.
    *
+   * @param memoryMap Whether to map the file into memory. Only set this for
+   * files that cannot be truncated while they are read (see above).
+   *
    * @throws SpectrumException if the input stream cannot be initialized
    * (e.g. insufficient permissions, ...).
    */
-  explicit FileImageSource(const std::string& path);
+  explicit FileImageSource(
+      const std::string& path,
+      const bool memoryMap = false);
   FileImageSource(const FileImageSource&) = delete;
-#if !defined(__ANDROID__) || defined(_LIBCPP_VERSION)
-  // gnustl doesn't mark std::ifstream as movable, and since we have a
-  // std::ifstream member variable we can't then use the default move
-  // constructor. We can remove the conditional after we've switched to libc++.
-  FileImageSource(FileImageSource&&) = default;
-#endif
+  FileImageSource(FileImageSource&& other) noexcept;
 
-  ~FileImageSource() override = default;
+  ~FileImageSource() override;
 
   std::size_t read(char* const destination, const std::size_t length) override;
   std::size_t getTotalBytesRead() const override;
   std::size_t available() override;
+  folly::Optional<folly::ByteRange> contiguousBytes() override;
+  std::size_t skip(const std::size_t length) override;
 };
 
 } // namespace io
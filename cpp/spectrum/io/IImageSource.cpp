@@ -5,12 +5,34 @@
 
 #include "IImageSource.h"
 
+#include <spectrum/core/Constants.h>
+
+#include <algorithm>
+#include <array>
+
 namespace facebook {
 namespace spectrum {
 namespace io {
 namespace error {
 const folly::StringPiece ImageSourceFailure{"image_source_failure"};
 }
+
+std::size_t IImageSource::skip(const std::size_t length) {
+  std::array<char, core::DefaultBufferSize> buffer;
+  std::size_t bytesSkipped = 0;
+
+  while (bytesSkipped < length) {
+    const auto bytesRead =
+        read(buffer.data(), std::min(buffer.size(), length - bytesSkipped));
+    if (bytesRead == 0) {
+      break;
+    }
+    bytesSkipped += bytesRead;
+  }
+
+  return bytesSkipped;
+}
+
 } // namespace io
 } // namespace spectrum
 } // namespace facebook
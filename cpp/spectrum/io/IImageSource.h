@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <folly/Optional.h>
 #include <folly/Range.h>
 
 #include <cstddef>
@@ -56,6 +57,27 @@ class IImageSource {
    */
   virtual std::size_t available() = 0;
 
+  /**
+   * Returns the bytes that are left to be read if the source holds them in
+   * contiguous memory, and folly::none otherwise. This allows consumers to
+   * access them without copying. The read head is not advanced: use skip()
+   * for the bytes consumed that way.
+   *
+   * The memory stays valid for the lifetime of the source and the bytes that
+   * have already been read directly precede the returned range.
+   */
+  virtual folly::Optional<folly::ByteRange> contiguousBytes() {
+    return folly::none;
+  }
+
+  /**
+   * Advances the read head by up to `length` bytes without handing them out.
+   *
+   * @return The number of bytes skipped. This is only smaller than `length`
+   * when the end of the stream is reached.
+   */
+  virtual std::size_t skip(const std::size_t length);
+
  protected:
   IImageSource() = default;
   IImageSource(IImageSource&&) = default;
@@ -10,100 +10,242 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
-#include <exception>
 #include <memory>
-#include <vector>
 
 namespace facebook {
 namespace spectrum {
 namespace io {
 
-RewindableImageSource::RewindableImageSource(IImageSource& imageSource)
-    : IEncodedImageSource(), imageSource(imageSource) {}
+namespace {
+// spare chunks are kept for subsequent marks, but only a few as the source
+// usually lives on for the whole transcode
+constexpr std::size_t MaximumNumberOfSpareChunks = 4;
+} // namespace
+
+RewindableImageSource::RewindableImageSource(
+    IImageSource& imageSource,
+    const std::size_t maximumBufferSize)
+    : IEncodedImageSource(),
+      imageSource(imageSource),
+      maximumBufferSize(maximumBufferSize),
+      memory(imageSource.contiguousBytes()) {}
 
 std::size_t RewindableImageSource::read(
     char* const destination,
     const std::size_t length) {
-  std::size_t bytesLeftToCopy = length;
-  std::size_t bytesCopied = 0;
+  if (memory.hasValue()) {
+    const auto bytesToRead = std::min(length, available());
+    std::copy_n(memory->begin() + position, bytesToRead, destination);
+    position += bytesToRead;
+    skipImageSourceToPosition();
+    return bytesToRead;
+  }
 
-  if (offset > 0) {
-    // buffer >> destination
-    const std::size_t elementsLeftInBuffer = offset;
-    const std::size_t elementsToCopyFromBuffer =
-        std::min(length, elementsLeftInBuffer);
+  const auto bytesReadFromBuffer = readFromBuffer(destination, length);
+  if (bytesReadFromBuffer == length) {
+    return length;
+  }
 
-    SPECTRUM_ENFORCE_IF_NOT(buffer.size() >= offset);
-    std::copy_n(buffer.end() - offset, elementsToCopyFromBuffer, destination);
+  if (isMarkActive) {
+    return bytesReadFromBuffer +
+        readIntoBuffer(
+               destination + bytesReadFromBuffer, length - bytesReadFromBuffer);
+  }
+
+  // we are past the buffer and cannot jump back
+  clearBuffer();
+  return bytesReadFromBuffer +
+      imageSource.read(
+          destination + bytesReadFromBuffer, length - bytesReadFromBuffer);
+}
 
-    SPECTRUM_ENFORCE_IF_NOT(offset >= elementsToCopyFromBuffer);
-    SPECTRUM_ENFORCE_IF_NOT(bytesLeftToCopy >= elementsToCopyFromBuffer);
-    offset -= elementsToCopyFromBuffer;
-    bytesCopied += elementsToCopyFromBuffer;
-    bytesLeftToCopy -= elementsToCopyFromBuffer;
+std::size_t RewindableImageSource::readFromBuffer(
+    char* const destination,
+    const std::size_t length) {
+  const auto bytesToRead = std::min(length, bufferEnd - bufferPosition);
+
+  std::size_t bytesRead = 0;
+  while (bytesRead < bytesToRead) {
+    const auto& chunk = *chunks[bufferPosition / core::DefaultBufferSize];
+    const auto chunkOffset = bufferPosition % core::DefaultBufferSize;
+    const auto bytesToCopy =
+        std::min(bytesToRead - bytesRead, chunk.size() - chunkOffset);
+
+    if (destination != nullptr) {
+      std::copy_n(
+          chunk.data() + chunkOffset, bytesToCopy, destination + bytesRead);
+    }
+    bufferPosition += bytesToCopy;
+    bytesRead += bytesToCopy;
   }
 
-  if (bytesLeftToCopy == 0) {
-    SPECTRUM_ENFORCE_IF_NOT(bytesCopied == length);
-    return bytesCopied;
+  if (!isMarkActive) {
+    // bytes before the read head cannot be reached anymore
+    bufferBegin = bufferPosition;
+    releaseUnreachableChunks();
   }
 
-  SPECTRUM_ENFORCE_IF_NOT(offset == 0);
-  SPECTRUM_ENFORCE_IF_NOT(bytesLeftToCopy + bytesCopied == length);
+  return bytesRead;
+}
 
-  if (isMarkActive) {
-    // imageSource >> tmp
-    auto tempDst = std::unique_ptr<char[]>{new char[bytesLeftToCopy]};
-    const char* tempDstPtr = tempDst.get();
+std::size_t RewindableImageSource::readIntoBuffer(
+    char* const destination,
+    const std::size_t length) {
+  SPECTRUM_ENFORCE_IF_NOT(bufferPosition == bufferEnd);
+
+  std::size_t bytesRead = 0;
+  while (bytesRead < length) {
+    const auto bufferSize = bufferEnd - bufferBegin;
+    SPECTRUM_ERROR_CSTR_IF(
+        bufferSize >= maximumBufferSize,
+        error::ImageSourceFailure,
+        "rewindable_image_source_buffer_exceeded");
+
+    // the end of the buffer always lies within the last chunk
+    if (bufferEnd == chunks.size() * core::DefaultBufferSize) {
+      if (spareChunks.empty()) {
+        chunks.push_back(std::make_unique<Chunk>());
+      } else {
+        chunks.push_back(std::move(spareChunks.back()));
+        spareChunks.pop_back();
+      }
+    }
 
-    const std::size_t innerRead =
-        imageSource.read(tempDst.get(), bytesLeftToCopy);
-    SPECTRUM_ENFORCE_IF_NOT(innerRead <= bytesLeftToCopy);
+    auto& chunk = *chunks.back();
+    const auto chunkOffset = bufferEnd % core::DefaultBufferSize;
+    const auto bytesToRead = std::min(
+        {length - bytesRead,
+         chunk.size() - chunkOffset,
+         maximumBufferSize - bufferSize});
+
+    const auto bytesReadFromImageSource =
+        imageSource.read(chunk.data() + chunkOffset, bytesToRead);
+    if (bytesReadFromImageSource == 0) {
+      break;
+    }
 
-    buffer.reserve(buffer.size() + innerRead);
-    for (std::size_t i = 0; i < innerRead; i++) {
-      const char c = tempDstPtr[i];
+    if (destination != nullptr) {
+      std::copy_n(
+          chunk.data() + chunkOffset,
+          bytesReadFromImageSource,
+          destination + bytesRead);
+    }
+    bufferEnd += bytesReadFromImageSource;
+    bytesRead += bytesReadFromImageSource;
+  }
 
-      // tmp >> buffer
-      buffer.push_back(c);
+  bufferPosition = bufferEnd;
+  return bytesRead;
+}
 
-      // tmp >> destination
-      destination[bytesCopied + i] = c;
+void RewindableImageSource::releaseUnreachableChunks() {
+  while (bufferBegin >= core::DefaultBufferSize) {
+    if (spareChunks.size() < MaximumNumberOfSpareChunks) {
+      spareChunks.push_back(std::move(chunks.front()));
     }
-    SPECTRUM_ENFORCE_IF_NOT(buffer.size() >= innerRead);
+    chunks.pop_front();
 
-    bytesCopied += innerRead;
-  } else {
-    // // imageSource >> destination
-    bytesCopied += imageSource.read(destination + bytesCopied, bytesLeftToCopy);
+    bufferBegin -= core::DefaultBufferSize;
+    bufferPosition -= core::DefaultBufferSize;
+    bufferEnd -= core::DefaultBufferSize;
+  }
+
+  if (!isMarkActive && bufferBegin == bufferEnd) {
+    clearBuffer();
+  }
+}
 
-    if (!buffer.empty()) {
-      // we are past the buffer and cannot jump back
-      buffer.clear();
+void RewindableImageSource::clearBuffer() {
+  while (!chunks.empty()) {
+    if (spareChunks.size() < MaximumNumberOfSpareChunks) {
+      spareChunks.push_back(std::move(chunks.back()));
     }
+    chunks.pop_back();
   }
-  SPECTRUM_ENFORCE_IF_NOT(bytesCopied <= length);
-  return bytesCopied;
+
+  bufferBegin = 0;
+  bufferPosition = 0;
+  bufferEnd = 0;
 }
 
-void RewindableImageSource::mark() {
+folly::Optional<folly::ByteRange> RewindableImageSource::contiguousBytes() {
+  if (memory.hasValue()) {
+    return folly::ByteRange{memory->begin() + position, memory->end()};
+  }
+
+  const auto bytes = imageSource.contiguousBytes();
+  if (!bytes.hasValue()) {
+    return folly::none;
+  }
+
+  // the bytes left in the buffer were read from the same memory and directly
+  // precede what is left in the image source
+  return folly::ByteRange{
+      bytes->begin() - (bufferEnd - bufferPosition), bytes->end()};
+}
+
+std::size_t RewindableImageSource::skip(const std::size_t length) {
+  if (memory.hasValue()) {
+    const auto bytesToSkip = std::min(length, available());
+    position += bytesToSkip;
+    skipImageSourceToPosition();
+    return bytesToSkip;
+  }
+
+  const auto bytesSkippedInBuffer = readFromBuffer(nullptr, length);
+  if (bytesSkippedInBuffer == length) {
+    return length;
+  }
+
   if (isMarkActive) {
-    // erase un-reachable buffer portion (valid since we cannot move the logical
-    // read-head to before the new mark)
-    buffer.erase(buffer.begin(), buffer.end() - offset);
-    SPECTRUM_ENFORCE_IF_NOT(buffer.size() == offset);
+    // skipped bytes must be buffered to be read again after reset()
+    return bytesSkippedInBuffer +
+        readIntoBuffer(nullptr, length - bytesSkippedInBuffer);
   }
+
+  // we are past the buffer and cannot jump back
+  clearBuffer();
+  return bytesSkippedInBuffer + imageSource.skip(length - bytesSkippedInBuffer);
+}
+
+void RewindableImageSource::skipImageSourceToPosition() {
+  if (position > imageSourcePosition) {
+    imageSourcePosition += imageSource.skip(position - imageSourcePosition);
+  }
+}
+
+void RewindableImageSource::mark() {
+  markPosition = position;
+
+  // un-reachable since we cannot move the logical read-head to before the new
+  // mark
   isMarkActive = true;
+  bufferBegin = bufferPosition;
+  releaseUnreachableChunks();
+}
+
+void RewindableImageSource::unmark() {
+  SPECTRUM_ENFORCE_IF_NOT(isMarkActive);
+  isMarkActive = false;
+
+  // only the part of the buffer that has not been re-read yet is reachable
+  bufferBegin = bufferPosition;
+  releaseUnreachableChunks();
 }
 
 void RewindableImageSource::reset() {
   SPECTRUM_ENFORCE_IF_NOT(isMarkActive);
   isMarkActive = false;
-  offset = buffer.size();
+  bufferPosition = bufferBegin;
+  position = markPosition;
 }
 
 std::size_t RewindableImageSource::available() {
-  return imageSource.available() + offset;
+  if (memory.hasValue()) {
+    return memory->size() - position;
+  }
+
+  return imageSource.available() + (bufferEnd - bufferPosition);
 }
 
 } // namespace io
@@ -5,10 +5,13 @@
 
 #pragma once
 
+#include <spectrum/core/Constants.h>
 #include <spectrum/io/IEncodedImageSource.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -25,30 +28,84 @@ namespace io {
  * and "reset" will be read again.
  */
 class RewindableImageSource : public IEncodedImageSource {
+ public:
+  /**
+   * Reading more bytes than this while marked fails instead of buffering them.
+   */
+  static constexpr std::size_t DefaultMaximumBufferSize = 64 * 1024 * 1024;
+
  private:
   IImageSource& imageSource;
-  std::vector<char> buffer;
+  const std::size_t maximumBufferSize;
 
   /**
-   * The offset is '0' exactly when we are reading the next byte from the
-   * original input stream. It is larger than 0, if the read head is within the
-   * buffer.
-   *
-   * E.g.: If the offset is 3 and the buffer has 10 elements, we would read the
-   * element buffer[10 - 3 - 1] (i.e. the 7th element);
+   * Bytes read from the wrapped image source that may have to be read again.
+   * They are kept in fixed-size chunks so that buffering more never moves
+   * buffered bytes and chunks that become unreachable are recycled.
+   */
+  using Chunk = std::array<char, core::DefaultBufferSize>;
+  std::deque<std::unique_ptr<Chunk>> chunks;
+  std::vector<std::unique_ptr<Chunk>> spareChunks;
+
+  /**
+   * Positions relative to the start of the first chunk: the first reachable
+   * byte, the read head and the end of the buffered bytes. The read head is
+   * within the buffer if bufferPosition < bufferEnd. Otherwise the next byte
+   * is read from the wrapped image source.
    */
-  std::size_t offset = 0;
+  std::size_t bufferBegin = 0;
+  std::size_t bufferPosition = 0;
+  std::size_t bufferEnd = 0;
 
   /**
-   * When true, all subsequent reads will fill the buffer and offset must be 0.
+   * When true, all bytes read from the wrapped image source are buffered and
+   * bufferBegin will not advance.
    */
   bool isMarkActive = false;
 
+  /**
+   * Reads the buffered bytes after the read head into destination, unless it
+   * is null.
+   */
+  std::size_t readFromBuffer(char* const destination, const std::size_t length);
+
+  /**
+   * Reads from the wrapped image source into the buffer and, unless it is
+   * null, into destination as well.
+   */
+  std::size_t readIntoBuffer(char* const destination, const std::size_t length);
+
+  /**
+   * Recycles the chunks in front of bufferBegin.
+   */
+  void releaseUnreachableChunks();
+  void clearBuffer();
+
+  /**
+   * Set if the wrapped image source holds its bytes in contiguous memory. The
+   * buffer is not used then: the read head is a position in that memory and
+   * rewinding just moves it back.
+   */
+  folly::Optional<folly::ByteRange> memory;
+  std::size_t position = 0;
+  std::size_t markPosition = 0;
+  std::size_t imageSourcePosition = 0;
+
+  /**
+   * Advances the wrapped image source to the furthest position read so far.
+   */
+  void skipImageSourceToPosition();
+
  public:
   /**
-   * Creates a RewindableImageSource which wraps the
+   * Creates a RewindableImageSource which wraps the given image source.
+   *
+   * @param maximumBufferSize The number of bytes that may be buffered to be
+   * read again. Sources in contiguous memory are never buffered.
    */
-  explicit RewindableImageSource(IImageSource& imageSource);
+  explicit RewindableImageSource(
+      IImageSource& imageSource,
+      const std::size_t maximumBufferSize = DefaultMaximumBufferSize);
   RewindableImageSource(const RewindableImageSource&) = delete;
   RewindableImageSource(RewindableImageSource&&) = default;
 
@@ -61,6 +118,8 @@ class RewindableImageSource : public IEncodedImageSource {
   }
 
   std::size_t available() override;
+  folly::Optional<folly::ByteRange> contiguousBytes() override;
+  std::size_t skip(const std::size_t length) override;
 
   /**
    * Marks the current position as the start of the buffer. A call to reset()
@@ -69,6 +128,15 @@ class RewindableImageSource : public IEncodedImageSource {
    */
   void mark();
 
+  /**
+   * Leaves the marked state without moving the read head: the bytes read since
+   * mark() will not be read again and their buffer is released.
+   *
+   * If unmark() is called without a matching mark(), a runtime_error will be
+   * thrown.
+   */
+  void unmark();
+
   /**
    * Will logically reset the read head to the position when mark() was called.
    * Everything that has been read between that call of mark() and now, will be
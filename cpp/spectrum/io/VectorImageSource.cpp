@@ -44,6 +44,20 @@ std::size_t VectorImageSource<Interface, T>::available() {
   return _data.size() - _offset;
 }
 
+template <class Interface, typename T>
+folly::Optional<folly::ByteRange>
+VectorImageSource<Interface, T>::contiguousBytes() {
+  const auto begin = reinterpret_cast<const unsigned char*>(_data.data());
+  return folly::ByteRange{begin + _offset, begin + _data.size()};
+}
+
+template <class Interface, typename T>
+std::size_t VectorImageSource<Interface, T>::skip(const std::size_t length) {
+  const auto bytesToSkip = std::min(length, _data.size() - _offset);
+  _offset += bytesToSkip;
+  return bytesToSkip;
+}
+
 template class VectorImageSource<IBitmapImageSource, char>;
 template class VectorImageSource<IBitmapImageSource, uint8_t>;
 template class VectorImageSource<IEncodedImageSource, char>;
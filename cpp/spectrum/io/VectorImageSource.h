@@ -28,6 +28,8 @@ class VectorImageSource : public Interface {
   std::size_t read(char* const destination, const std::size_t length) override;
   std::size_t getTotalBytesRead() const override;
   std::size_t available() override;
+  folly::Optional<folly::ByteRange> contiguousBytes() override;
+  std::size_t skip(const std::size_t length) override;
 
  private:
   const std::vector<T> _data;
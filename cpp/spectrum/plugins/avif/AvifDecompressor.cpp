@@ -11,8 +11,12 @@
 #include <spectrum/io/IImageSource.h>
 #include <spectrum/plugins/avif/LibAvifTranscodingPlugin.h>
 
+#include <folly/Optional.h>
+#include <folly/Range.h>
+
+#include <algorithm>
+
 #include <avif/avif.h>
-#include <folly/ScopeGuard.h>
 
 namespace facebook {
 namespace spectrum {
@@ -21,25 +25,101 @@ namespace avif {
 
 namespace {
 
-std::vector<std::uint8_t> readEntireImageSource(io::IImageSource& source) {
-  std::vector<std::uint8_t> out{};
-  out.reserve(source.available());
+/**
+ * An avifIO that reads from an image source on demand. Image sources can only
+ * be read forward, so the bytes read so far are retained to serve libavif's
+ * random access reads. Sources in contiguous memory are served from there
+ * instead.
+ */
+struct ImageSourceIO {
+  explicit ImageSourceIO(io::IImageSource& source)
+      : source(source), memory(source.contiguousBytes()) {}
+
+  avifIO io{};
+  io::IImageSource& source;
+  folly::Optional<folly::ByteRange> memory;
+  std::uint64_t bytesSkipped = 0;
+  std::vector<std::uint8_t> bytes;
+};
+
+void destroyImageSourceIO(avifIO* io) {
+  delete static_cast<ImageSourceIO*>(io->data);
+}
+
+avifResult readImageSourceIO(
+    avifIO* io,
+    std::uint32_t readFlags,
+    std::uint64_t offset,
+    std::size_t size,
+    avifROData* out) {
+  if (readFlags != 0) {
+    return AVIF_RESULT_IO_ERROR;
+  }
+
+  auto& sourceIO = *static_cast<ImageSourceIO*>(io->data);
+  const auto end = offset + size;
+
+  if (sourceIO.memory.hasValue()) {
+    const auto& memory = *sourceIO.memory;
+    if (offset > memory.size()) {
+      return AVIF_RESULT_IO_ERROR;
+    }
+
+    // keep the source's read head in line with what libavif consumed
+    if (end > sourceIO.bytesSkipped) {
+      sourceIO.bytesSkipped +=
+          sourceIO.source.skip(end - sourceIO.bytesSkipped);
+    }
+
+    out->data = memory.data() + offset;
+    out->size = std::min<std::uint64_t>(size, memory.size() - offset);
+    return AVIF_RESULT_OK;
+  }
+
+  auto& bytes = sourceIO.bytes;
+
+  // grow chunk by chunk so that bogus box sizes don't trigger huge allocations
+  while (bytes.size() < end) {
+    const auto previousSize = bytes.size();
+    bytes.resize(previousSize + core::DefaultBufferSize);
+
+    const auto bytesRead = sourceIO.source.read(
+        reinterpret_cast<char*>(bytes.data() + previousSize),
+        core::DefaultBufferSize);
+    bytes.resize(previousSize + bytesRead);
+
+    if (bytesRead == 0) {
+      break;
+    }
+  }
 
-  std::vector<std::uint8_t> buffer(core::DefaultBufferSize);
-  std::size_t bytesRead;
-  while ((bytesRead = source.read(
-              reinterpret_cast<char* const>(buffer.data()), buffer.size())) >
-         0) {
-    out.insert(out.end(), buffer.begin(), buffer.begin() + bytesRead);
+  if (offset > bytes.size()) {
+    return AVIF_RESULT_IO_ERROR;
   }
 
-  return out;
+  out->data = bytes.data() + offset;
+  out->size = std::min<std::uint64_t>(size, bytes.size() - offset);
+  return AVIF_RESULT_OK;
+}
+
+avifIO* makeImageSourceIO(io::IImageSource& source) {
+  auto sourceIO = new ImageSourceIO(source);
+  sourceIO->io.destroy = &destroyImageSourceIO;
+  sourceIO->io.read = &readImageSourceIO;
+  sourceIO->io.sizeHint = source.available();
+  // the source's memory outlives the decoder
+  sourceIO->io.persistent =
+      sourceIO->memory.hasValue() ? AVIF_TRUE : AVIF_FALSE;
+  sourceIO->io.data = sourceIO;
+  return &sourceIO->io;
 }
 
 } // namespace
 
-AvifDecompressor::AvifDecompressor(io::IImageSource& source)
-    : _source(source) {}
+AvifDecompressor::AvifDecompressor(
+    io::IImageSource& source,
+    const Configuration& configuration)
+    : _source(source), _configuration(configuration) {}
 
 AvifDecompressor::~AvifDecompressor() {
   if (_decoder) {
@@ -56,16 +136,11 @@ void AvifDecompressor::_parseContainer() {
     return;
   }
 
-  _sourceData = readEntireImageSource(_source);
-
   _decoder = avifDecoderCreate();
+  _decoder->maxThreads = _configuration.avif.maxThreads();
 
-  SPECTRUM_ERROR_CSTR_IF_NOT(
-      AVIF_RESULT_OK ==
-          avifDecoderSetIOMemory(
-              _decoder, _sourceData.data(), _sourceData.size()),
-      codecs::error::DecompressorFailure,
-      "failed avifDecoderSetIOMemory");
+  // the decoder takes ownership of the io
+  avifDecoderSetIO(_decoder, makeImageSourceIO(_source));
 
   SPECTRUM_ERROR_CSTR_IF_NOT(
       AVIF_RESULT_OK == avifDecoderParse(_decoder) &&
@@ -92,13 +167,12 @@ void AvifDecompressor::_ensureEntireImageIsRead() {
   }
   _entireImageHasBeenRead = true;
 
-  _parseContainer();
+  _computeSpecifications();
 
   SPECTRUM_ERROR_CSTR_IF_NOT(
       AVIF_RESULT_OK == avifDecoderNextImage(_decoder) && _decoder->image,
       codecs::error::DecompressorFailure,
       "failed avifDecoderNextImage");
-  _sourceData.clear();
 
   const auto image = _decoder->image;
 
@@ -107,38 +181,19 @@ void AvifDecompressor::_ensureEntireImageIsRead() {
   rgb.depth = 8;
   rgb.format = AVIF_RGB_FORMAT_RGB;
 
-  avifRGBImageAllocatePixels(&rgb);
-  SCOPE_EXIT {
-    avifRGBImageFreePixels(&rgb);
-  };
+  // convert straight into the buffer scanlines are served from
+  _entireImageRowBytes = image->width *
+      image::pixel::specifications::RGB.bytesPerPixel;
+  _entireImage = std::make_shared<std::vector<std::uint8_t>>(
+      _entireImageRowBytes * image->height);
+  rgb.pixels = _entireImage->data();
+  rgb.rowBytes = _entireImageRowBytes;
 
   SPECTRUM_ERROR_CSTR_IF_NOT(
       AVIF_RESULT_OK == avifImageYUVToRGB(image, &rgb),
       codecs::error::DecompressorFailure,
       "failed avifImageYUVToRGB");
 
-  _entireImage.reserve(image->height);
-  for (auto row = 0; row < image->height; ++row) {
-    auto scanline = std::make_unique<image::Scanline>(
-        image::pixel::specifications::RGB, image->width);
-
-    SPECTRUM_ERROR_FORMAT_IF_NOT(
-        scanline->sizeBytes() == rgb.rowBytes,
-        codecs::error::DecompressorFailure,
-        "scanline size (%d) does not match decoded row bytes (%d)",
-        scanline->sizeBytes(),
-        rgb.rowBytes);
-
-    std::memcpy(
-        scanline->data(), rgb.pixels + row * rgb.rowBytes, rgb.rowBytes);
-    _entireImage.push_back(std::move(scanline));
-  }
-
-  _imageSpecification = image::Specification{
-      .size = image::Size{image->width, image->height},
-      .format = image::formats::Avif,
-      .pixelSpecification = image::pixel::specifications::RGB};
-
   // We are done with the decoder, free it now to save memory
   avifDecoderDestroy(_decoder);
   _decoder = nullptr;
@@ -159,19 +214,24 @@ image::Specification AvifDecompressor::outputImageSpecification() {
 
 std::unique_ptr<image::Scanline> AvifDecompressor::readScanline() {
   _ensureEntireImageIsRead();
-  std::unique_ptr<image::Scanline> result;
 
-  if (_currentOutputScanline < _imageSpecification->size.height) {
-    result = std::move(_entireImage[_currentOutputScanline]);
-    _currentOutputScanline++;
+  if (_currentOutputScanline >= _imageSpecification->size.height) {
+    return nullptr;
   }
 
-  // free memory early
+  auto scanline = std::make_unique<image::Scanline>(
+      image::pixel::specifications::RGB,
+      _entireImage->data() + _currentOutputScanline * _entireImageRowBytes,
+      _imageSpecification->size.width,
+      _entireImage);
+  _currentOutputScanline++;
+
+  // the image lives on until the last scanline is released
   if (_currentOutputScanline == _imageSpecification->size.height) {
-    _entireImage.clear();
+    _entireImage = nullptr;
   }
 
-  return result;
+  return scanline;
 }
 
 } // namespace avif
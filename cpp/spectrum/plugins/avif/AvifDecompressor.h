@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <spectrum/Configuration.h>
 #include <spectrum/codecs/IDecompressor.h>
 #include <spectrum/image/Scanline.h>
 #include <spectrum/io/IImageSource.h>
@@ -12,6 +13,7 @@
 #include <folly/Optional.h>
 
 #include <memory>
+#include <vector>
 
 extern "C" {
 struct avifDecoder;
@@ -27,14 +29,16 @@ namespace avif {
  */
 class AvifDecompressor final : public codecs::IDecompressor {
  public:
-  explicit AvifDecompressor(io::IImageSource& source);
+  explicit AvifDecompressor(
+      io::IImageSource& source,
+      const Configuration& configuration = Configuration());
   AvifDecompressor(AvifDecompressor&&) = default;
 
   virtual ~AvifDecompressor();
 
  private:
   io::IImageSource& _source;
-  std::vector<std::uint8_t> _sourceData;
+  const Configuration _configuration;
 
   avifDecoder* _decoder = nullptr;
   void _parseContainer();
@@ -43,7 +47,11 @@ class AvifDecompressor final : public codecs::IDecompressor {
   void _computeSpecifications();
 
   bool _entireImageHasBeenRead = false;
-  std::vector<std::unique_ptr<image::Scanline>> _entireImage;
+
+  // RGB pixels of the decoded image. Scanlines handed out are views into it
+  // and share its ownership
+  std::shared_ptr<std::vector<std::uint8_t>> _entireImage;
+  std::size_t _entireImageRowBytes = 0;
   std::uint32_t _currentOutputScanline = 0;
   void _ensureEntireImageIsRead();
 
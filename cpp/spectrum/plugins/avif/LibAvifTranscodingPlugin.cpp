@@ -23,8 +23,8 @@ namespace {
 inline codecs::DecompressorProvider::Factory makeAvifDecompressorFactory() {
   return [](io::IImageSource& source,
             const folly::Optional<image::Ratio>& /* unused */,
-            const Configuration& /* unused */) {
-    return std::make_unique<AvifDecompressor>(source);
+            const Configuration& configuration) {
+    return std::make_unique<AvifDecompressor>(source, configuration);
   };
 }
 
@@ -173,8 +173,9 @@ void LibJpegCompressor::finishIfLastScanlineWritten() {
   }
 }
 
-void LibJpegCompressor::internalWriteScanline(
-    JSAMPROW scanlineData,
+void LibJpegCompressor::internalWriteScanlines(
+    JSAMPARRAY scanlinesData,
+    const std::size_t numberOfScanlines,
     const std::size_t scanlineSize,
     const image::pixel::Specification& pixelSpecification) {
   SPECTRUM_ENFORCE_IF_NOT(
@@ -184,11 +185,20 @@ void LibJpegCompressor::internalWriteScanline(
 
   ensureReadyForWriteScanline();
 
-  jpeg_write_scanlines(
-      &libJpegCompressInfo,
-      reinterpret_cast<JSAMPARRAY>(
-          &scanlineData), /* pointer to array of pointers */
-      1 /* number of scanlines to read */);
+  SPECTRUM_ENFORCE_IF_NOT(
+      numberOfScanlines <= libJpegCompressInfo.image_height -
+          libJpegCompressInfo.next_scanline);
+
+  std::size_t numberOfScanlinesWritten = 0;
+  while (numberOfScanlinesWritten < numberOfScanlines) {
+    const auto numberOfScanlinesWrittenInCall = jpeg_write_scanlines(
+        &libJpegCompressInfo,
+        scanlinesData + numberOfScanlinesWritten,
+        numberOfScanlines - numberOfScanlinesWritten);
+    SPECTRUM_ENFORCE_IF(numberOfScanlinesWrittenInCall == 0);
+
+    numberOfScanlinesWritten += numberOfScanlinesWrittenInCall;
+  }
 
   finishIfLastScanlineWritten();
 }
@@ -202,10 +212,9 @@ void LibJpegCompressor::writeScanline(
   const auto pixelSpecification = scanline->specification();
   if (pixelSpecification == image::pixel::specifications::Gray ||
       pixelSpecification == image::pixel::specifications::RGB) {
-    internalWriteScanline(
-        reinterpret_cast<JSAMPROW>(scanline->data()),
-        scanline->width(),
-        pixelSpecification);
+    JSAMPROW scanlineData = reinterpret_cast<JSAMPROW>(scanline->data());
+    internalWriteScanlines(
+        &scanlineData, 1, scanline->width(), pixelSpecification);
   } else {
     SPECTRUM_ERROR_STRING(
         codecs::error::CompressorCannotWritePixelSpecification,
@@ -213,6 +222,33 @@ void LibJpegCompressor::writeScanline(
   }
 }
 
+void LibJpegCompressor::writeScanlines(
+    std::vector<std::unique_ptr<image::Scanline>> scanlines) {
+  if (scanlines.empty()) {
+    return;
+  }
+
+  const auto pixelSpecification = scanlines.front()->specification();
+  const auto width = scanlines.front()->width();
+  if (pixelSpecification != image::pixel::specifications::Gray &&
+      pixelSpecification != image::pixel::specifications::RGB) {
+    SPECTRUM_ERROR_STRING(
+        codecs::error::CompressorCannotWritePixelSpecification,
+        pixelSpecification.string());
+  }
+
+  std::vector<JSAMPROW> scanlinesData;
+  scanlinesData.reserve(scanlines.size());
+  for (const auto& scanline : scanlines) {
+    SPECTRUM_ENFORCE_IF_NOT(scanline->specification() == pixelSpecification);
+    SPECTRUM_ENFORCE_IF_NOT(scanline->width() == width);
+    scanlinesData.push_back(reinterpret_cast<JSAMPROW>(scanline->data()));
+  }
+
+  internalWriteScanlines(
+      scanlinesData.data(), scanlinesData.size(), width, pixelSpecification);
+}
+
 } // namespace jpeg
 } // namespace plugins
 } // namespace spectrum
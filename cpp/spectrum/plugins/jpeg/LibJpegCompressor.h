@@ -16,6 +16,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include <mozjpeg/jerror.h>
 #include <mozjpeg/jinclude.h>
@@ -57,8 +58,9 @@ class LibJpegCompressor final : public codecs::ICompressor {
   void ensureBeforeCompressionStarted();
   void ensureReadyForWriteScanline();
   void finishIfLastScanlineWritten();
-  void internalWriteScanline(
-      JSAMPROW scanlineData,
+  void internalWriteScanlines(
+      JSAMPARRAY scanlinesData,
+      const std::size_t numberOfScanlines,
       const std::size_t scanlineSize,
       const image::pixel::Specification& expectedPixelSpecification);
 
@@ -67,6 +69,8 @@ class LibJpegCompressor final : public codecs::ICompressor {
   //
  public:
   void writeScanline(std::unique_ptr<image::Scanline> scanline) override;
+  void writeScanlines(
+      std::vector<std::unique_ptr<image::Scanline>> scanlines) override;
 };
 
 } // namespace jpeg
@@ -16,6 +16,7 @@
 
 #include <mozjpeg/jpegint.h>
 
+#include <algorithm>
 #include <exception>
 #include <memory>
 
@@ -127,6 +128,13 @@ void LibJpegDecompressor::ensureHeaderIsRead() {
         JPEG_HEADER_OK == result,
         codecs::error::DecompressorFailure,
         "jpeg_read_header_failed");
+
+#if defined(SPECTRUM_LIBJPEG_SCAN_LIMIT)
+    // buffered-image mode allows to output the image after any scan
+    libJpegDecompressInfo.buffered_image =
+        _configuration.jpeg.maxProgressiveScans() > 0 &&
+        jpeg_has_multiple_scans(&libJpegDecompressInfo);
+#endif
   }
 
   // must be executed between reading the header and starting the
@@ -156,6 +164,10 @@ void LibJpegDecompressor::ensureReadyForReadScanline() {
 
   if (libJpegDecompressInfo.global_state < DSTATE_SCANNING) {
     jpeg_start_decompress(&libJpegDecompressInfo);
+    if (libJpegDecompressInfo.buffered_image) {
+      startOutputAfterScanLimit();
+    }
+
     SPECTRUM_ERROR_CSTR_IF_NOT(
         libJpegDecompressInfo.global_state >= DSTATE_SCANNING,
         codecs::error::DecompressorFailure,
@@ -163,8 +175,37 @@ void LibJpegDecompressor::ensureReadyForReadScanline() {
   }
 
   SPECTRUM_ENFORCE_IF_NOT(
-      libJpegDecompressInfo.output_scanline <
-      libJpegDecompressInfo.output_height);
+      libJpegDecompressInfo.output_scanline < _endScanline());
+}
+
+void LibJpegDecompressor::startOutputAfterScanLimit() {
+  const auto maxProgressiveScans = _configuration.jpeg.maxProgressiveScans();
+
+  // read input until the scan after the limit starts (or the image ends).
+  // the source never suspends as it ends the data with a fake EOI marker
+  int status;
+  do {
+    status = jpeg_consume_input(&libJpegDecompressInfo);
+    SPECTRUM_ERROR_CSTR_IF(
+        status == JPEG_SUSPENDED,
+        codecs::error::DecompressorFailure,
+        "jpeg_consume_input_suspended");
+  } while (status != JPEG_REACHED_EOI &&
+           !(status == JPEG_REACHED_SOS &&
+             libJpegDecompressInfo.input_scan_number > maxProgressiveScans));
+
+  // the output is created from the scans read so far. no further input is
+  // consumed as the output scan precedes the input scan
+  jpeg_start_output(
+      &libJpegDecompressInfo,
+      std::min(libJpegDecompressInfo.input_scan_number, maxProgressiveScans));
+}
+
+JDIMENSION LibJpegDecompressor::_endScanline() const {
+  if (_regionOfInterest.hasValue()) {
+    return _regionOfInterest->maxY();
+  }
+  return libJpegDecompressInfo.output_height;
 }
 
 image::Specification LibJpegDecompressor::_imageSpecification(
@@ -186,14 +227,28 @@ image::Specification LibJpegDecompressor::_imageSpecification(
   };
 }
 
+void LibJpegDecompressor::finishIfLastScanlineRead() {
+  // free memory after last line has been read. rows below a region of
+  // interest are never decoded
+  if (libJpegDecompressInfo.output_scanline >= _endScanline()) {
+    // T29725613: for malformed images without EOI, the jpeg_finish_decompress()
+    // method might fail with an error. We don't care about markers or anything
+    // after the image has already been read. Therefore, we do the deallocation
+    // and terminate the source ourselves. See jdapimin.c
+    (libJpegDecompressInfo.src->term_source)(&libJpegDecompressInfo);
+    jpeg_abort((j_common_ptr)&libJpegDecompressInfo);
+    _isFinished = true;
+  }
+}
+
 std::unique_ptr<image::Scanline> LibJpegDecompressor::readScanline() {
   ensureHeaderIsRead();
   ensureReadyForReadScanline();
 
   const auto pixelSpecification = outputImageSpecification().pixelSpecification;
 
-  auto result = std::make_unique<image::Scanline>(
-      pixelSpecification, libJpegDecompressInfo.output_width);
+  auto result = image::makeScanline(
+      _scanlinePool, pixelSpecification, libJpegDecompressInfo.output_width);
   JSAMPROW scanlineDest = reinterpret_cast<JSAMPROW>(result->data());
 
   jpeg_read_scanlines(
@@ -202,18 +257,54 @@ std::unique_ptr<image::Scanline> LibJpegDecompressor::readScanline() {
           &scanlineDest), /* pointer to array of pointers */
       1 /* number of scanlines to read */);
 
-  // free memory after last line has been read
-  if (libJpegDecompressInfo.output_scanline >=
-      libJpegDecompressInfo.output_height) {
-    // T29725613: for malformed images without EOI, the jpeg_finish_decompress()
-    // method might fail with an error. We don't care about markers or anything
-    // after the image has already been read. Therefore, we do the deallocation
-    // and terminate the source ourselves. See jdapimin.c
-    (libJpegDecompressInfo.src->term_source)(&libJpegDecompressInfo);
-    jpeg_abort((j_common_ptr)&libJpegDecompressInfo);
-    _isFinished = true;
+  finishIfLastScanlineRead();
+
+  return result;
+}
+
+std::vector<std::unique_ptr<image::Scanline>>
+LibJpegDecompressor::readScanlines(const std::size_t numberOfScanlines) {
+  ensureHeaderIsRead();
+  ensureReadyForReadScanline();
+
+  SPECTRUM_ERROR_CSTR_IF_NOT(
+      numberOfScanlines <=
+          _endScanline() - libJpegDecompressInfo.output_scanline,
+      codecs::error::DecompressorFailure,
+      "requested_more_scanlines_than_remaining");
+
+  const auto pixelSpecification = outputImageSpecification().pixelSpecification;
+
+  std::vector<std::unique_ptr<image::Scanline>> result;
+  std::vector<JSAMPROW> scanlineDests;
+  result.reserve(numberOfScanlines);
+  scanlineDests.reserve(numberOfScanlines);
+
+  for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+    result.push_back(image::makeScanline(
+        _scanlinePool, pixelSpecification, libJpegDecompressInfo.output_width));
+    scanlineDests.push_back(reinterpret_cast<JSAMPROW>(result.back()->data()));
+  }
+
+  // libjpeg returns at most one iMCU row per call, so keep asking until all the
+  // requested rows have been produced
+  std::size_t numberOfScanlinesRead = 0;
+  while (numberOfScanlinesRead < numberOfScanlines) {
+    const auto numberOfScanlinesReadInCall = jpeg_read_scanlines(
+        &libJpegDecompressInfo,
+        scanlineDests.data() + numberOfScanlinesRead,
+        numberOfScanlines - numberOfScanlinesRead);
+
+    SPECTRUM_ERROR_CSTR_IF(
+        numberOfScanlinesReadInCall == 0,
+        codecs::error::DecompressorFailure,
+        "jpeg_read_scanlines_returned_no_scanlines");
+
+    numberOfScanlinesRead += numberOfScanlinesReadInCall;
   }
 
+  finishIfLastScanlineRead();
+
   return result;
 }
 
@@ -221,6 +312,67 @@ std::unique_ptr<image::Scanline> LibJpegDecompressor::readScanline() {
 // Decompressor
 //
 
+folly::Optional<image::Rect> LibJpegDecompressor::setRegionOfInterest(
+    const image::Rect& region) {
+  ensureReadyForReadScanline();
+  SPECTRUM_ENFORCE_IF(_regionOfInterest.hasValue());
+  SPECTRUM_ENFORCE_IF_NOT(libJpegDecompressInfo.output_scanline == 0);
+  SPECTRUM_ENFORCE_IF(region.size.empty());
+  SPECTRUM_ENFORCE_IF_NOT(
+      region.maxX() <= libJpegDecompressInfo.output_width &&
+      region.maxY() <= libJpegDecompressInfo.output_height);
+
+#if !defined(SPECTRUM_LIBJPEG_REGION_OF_INTEREST)
+  return IDecompressor::setRegionOfInterest(region);
+#else
+  // libjpeg moves the left edge to an iMCU boundary and widens the columns
+  // accordingly. the upsampling of the outermost columns uses the chroma
+  // samples next to them, hence the columns are extended on both sides. the
+  // block smoothing of partially decoded progressive images looks two blocks
+  // further
+  const JDIMENSION iMcuWidth = libJpegDecompressInfo.max_h_samp_factor *
+      libJpegDecompressInfo.min_DCT_scaled_size;
+  const JDIMENSION contextWidth =
+      libJpegDecompressInfo.buffered_image ? 2 * iMcuWidth + 1 : 1;
+  JDIMENSION xOffset = region.topLeft.x > contextWidth
+      ? region.topLeft.x - contextWidth
+      : 0;
+  JDIMENSION width = std::min<JDIMENSION>(
+      region.maxX() + contextWidth + iMcuWidth - xOffset,
+      libJpegDecompressInfo.output_width - xOffset);
+  if (width < libJpegDecompressInfo.output_width) {
+    jpeg_crop_scanline(&libJpegDecompressInfo, &xOffset, &width);
+  }
+
+  if (region.topLeft.y > 0) {
+    const auto numberOfSkippedScanlines =
+        jpeg_skip_scanlines(&libJpegDecompressInfo, region.topLeft.y);
+    SPECTRUM_ERROR_CSTR_IF_NOT(
+        numberOfSkippedScanlines == region.topLeft.y,
+        codecs::error::DecompressorFailure,
+        "jpeg_skip_scanlines_failed");
+  }
+
+  _regionOfInterest = image::Rect{
+      .topLeft = {.x = xOffset, .y = region.topLeft.y},
+      .size = {.width = width, .height = region.size.height},
+  };
+  _outputImageSpecification = folly::none;
+  return _regionOfInterest;
+#endif
+}
+
+folly::Optional<std::vector<std::uint8_t>>
+LibJpegDecompressor::embeddedThumbnail() {
+  // the saved markers are freed once the image has been read
+  if (_isFinished) {
+    return folly::none;
+  }
+
+  ensureHeaderIsRead();
+  return readEmbeddedThumbnail(libJpegDecompressInfo);
+}
+
 image::Specification LibJpegDecompressor::sourceImageSpecification() {
   if (_sourceImageSpecification.hasValue()) {
     return *_sourceImageSpecification;
@@ -252,12 +404,14 @@ image::Specification LibJpegDecompressor::outputImageSpecification() {
   // Needed for output_width / output_height after setting the sampling ratio
   ensureReadyForReadScanline();
 
-  const auto outputSize = image::Size{
-      .width = SPECTRUM_CONVERT_OR_THROW(
-          libJpegDecompressInfo.output_width, std::uint32_t),
-      .height = SPECTRUM_CONVERT_OR_THROW(
-          libJpegDecompressInfo.output_height, std::uint32_t),
-  };
+  const auto outputSize = _regionOfInterest.hasValue()
+      ? _regionOfInterest->size
+      : image::Size{
+            .width = SPECTRUM_CONVERT_OR_THROW(
+                libJpegDecompressInfo.output_width, std::uint32_t),
+            .height = SPECTRUM_CONVERT_OR_THROW(
+                libJpegDecompressInfo.output_height, std::uint32_t),
+        };
   const auto outputPixelSpecification = _pixelSpecificationFromColorSpace(
       libJpegDecompressInfo.out_color_space,
       libJpegDecompressInfo.out_color_components);
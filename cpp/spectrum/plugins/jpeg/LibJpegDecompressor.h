@@ -18,11 +18,29 @@
 #include <array>
 #include <memory>
 #include <tuple>
+#include <vector>
 
 #include <mozjpeg/jerror.h>
 #include <mozjpeg/jinclude.h>
 #include <mozjpeg/jpeglib.h>
 
+// libjpeg-turbo's partial decoding (`jpeg_crop_scanline`,
+// `jpeg_skip_scanlines`) received correctness fixes after 1.5.x, which the
+// shipped mozjpeg 3.3.1 is based on. It is only used with the versions it has
+// been verified against.
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && \
+    LIBJPEG_TURBO_VERSION_NUMBER >= 2001005
+#define SPECTRUM_LIBJPEG_REGION_OF_INTEREST 1
+#endif
+
+// Stopping after a number of scans relies on buffered-image mode and on the
+// block smoothing of partially decoded images, which changed after 1.5.x as
+// well. The scan limit is ignored by versions it has not been verified with.
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && \
+    LIBJPEG_TURBO_VERSION_NUMBER >= 2001005
+#define SPECTRUM_LIBJPEG_SCAN_LIMIT 1
+#endif
+
 namespace facebook {
 namespace spectrum {
 namespace plugins {
@@ -76,9 +94,21 @@ class LibJpegDecompressor final : public codecs::IDecompressor {
   const image::Ratio _samplingRatio;
   bool _isFinished{false};
 
+  /** set once the output is restricted to a region of the image */
+  folly::Optional<image::Rect> _regionOfInterest;
+
+  JDIMENSION _endScanline() const;
+
   void ensureHeaderIsRead();
   void ensureReadyForReadScanline();
 
+  /**
+   * In buffered-image mode, consumes the scans up to the configured limit and
+   * starts the output from them.
+   */
+  void startOutputAfterScanLimit();
+  void finishIfLastScanlineRead();
+
   image::Specification _imageSpecification(
       const image::Size& size,
       const image::pixel::Specification& pixelSpecification);
@@ -93,6 +123,23 @@ class LibJpegDecompressor final : public codecs::IDecompressor {
   image::Specification outputImageSpecification() override;
 
   std::unique_ptr<image::Scanline> readScanline() override;
+  std::vector<std::unique_ptr<image::Scanline>> readScanlines(
+      const std::size_t numberOfScanlines) override;
+
+  /**
+   * Crops the decoded columns to whole iMCUs with `jpeg_crop_scanline` and
+   * skips the rows above the region with `jpeg_skip_scanlines`. Reading stops
+   * after the region's last row. Without SPECTRUM_LIBJPEG_REGION_OF_INTEREST,
+   * the whole image is decoded instead.
+   */
+  folly::Optional<image::Rect> setRegionOfInterest(
+      const image::Rect& region) override;
+
+  /**
+   * Extracts the JPEG thumbnail from the APP1 EXIF marker. Requires metadata
+   * to be interpreted as the markers aren't saved otherwise.
+   */
+  folly::Optional<std::vector<std::uint8_t>> embeddedThumbnail() override;
 };
 
 } // namespace jpeg
@@ -0,0 +1,159 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "LibJpegEmbeddedThumbnailRecipe.h"
+
+#include <spectrum/core/SpectrumEnforce.h>
+#include <spectrum/core/decisions/BaseDecision.h>
+#include <spectrum/core/recipes/BaseRecipe.h>
+#include <spectrum/io/VectorImageSource.h>
+#include <spectrum/plugins/jpeg/LibJpegDecompressor.h>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <folly/Optional.h>
+
+namespace facebook {
+namespace spectrum {
+namespace plugins {
+namespace jpeg {
+
+namespace {
+bool mayUseThumbnail(const core::Operation& operation) {
+  const auto& transformations = operation.parameters.transformations;
+  return operation.configuration.jpeg.useEmbeddedThumbnail() &&
+      operation.probedDecompressor != nullptr &&
+      transformations.resizeRequirement.hasValue() &&
+      !transformations.cropRequirement.hasValue();
+}
+
+std::uint32_t absoluteDifference(const std::uint32_t a, const std::uint32_t b) {
+  return a > b ? a - b : b - a;
+}
+
+/**
+ * The thumbnail must not be letterboxed (i.e. have the aspect ratio of the
+ * image, up to rounding) and must not need to be upscaled for the output.
+ */
+bool thumbnailFits(
+    const image::Size& imageSize,
+    const image::Size& thumbnailSize,
+    const image::Size& outputSize) {
+  if (!thumbnailSize.containedIn(imageSize)) {
+    return false;
+  }
+
+  const auto fittedSize = imageSize.downscaledToFit(thumbnailSize);
+  return absoluteDifference(fittedSize.width, thumbnailSize.width) <= 1 &&
+      absoluteDifference(fittedSize.height, thumbnailSize.height) <= 1 &&
+      outputSize.containedIn(thumbnailSize);
+}
+
+/**
+ * The input image specification of the thumbnail. Orientation and metadata
+ * apply to the thumbnail as well and are taken from the image.
+ */
+folly::Optional<image::Specification> makeThumbnailImageSpecification(
+    const image::Specification& imageSpecification,
+    const std::vector<std::uint8_t>& thumbnail,
+    const Configuration& configuration) {
+  try {
+    io::IntVectorEncodedImageSource source{thumbnail};
+    LibJpegDecompressor decompressor{source, configuration};
+    const auto thumbnailSpecification =
+        decompressor.sourceImageSpecification();
+
+    auto specification = imageSpecification;
+    specification.size = thumbnailSpecification.size;
+    specification.pixelSpecification =
+        thumbnailSpecification.pixelSpecification;
+    return specification;
+  } catch (const SpectrumException&) {
+    // not a JPEG image we can decode
+    return folly::none;
+  }
+}
+
+/**
+ * The embedded thumbnail and the parameters to transcode it with instead of
+ * the image.
+ */
+struct UsableThumbnail {
+  std::vector<std::uint8_t> data;
+  core::Operation::Parameters parameters;
+};
+
+std::shared_ptr<const UsableThumbnail> findUsableThumbnail(
+    const core::Operation& operation) {
+  if (!mayUseThumbnail(operation)) {
+    return nullptr;
+  }
+
+  auto embeddedThumbnail = operation.probedDecompressor->embeddedThumbnail();
+  if (!embeddedThumbnail.hasValue()) {
+    return nullptr;
+  }
+
+  const auto& inputImageSpecification =
+      operation.parameters.inputImageSpecification;
+  const auto thumbnailImageSpecification = makeThumbnailImageSpecification(
+      inputImageSpecification, *embeddedThumbnail, operation.configuration);
+
+  // both sizes are before applying the orientation
+  const auto outputSize = core::decisions::BaseDecision::calculate(operation)
+                              .resize.sizeAfterScaling();
+  if (!thumbnailImageSpecification.hasValue() ||
+      !thumbnailFits(
+          inputImageSpecification.size,
+          thumbnailImageSpecification->size,
+          outputSize)) {
+    return nullptr;
+  }
+
+  // resize the thumbnail to the size the image would have been resized to
+  auto thumbnailParameters = operation.parameters;
+  thumbnailParameters.inputImageSpecification = *thumbnailImageSpecification;
+  thumbnailParameters.transformations.resizeRequirement = requirements::Resize{
+      .mode = requirements::Resize::Mode::Exact,
+      .targetSize = outputSize,
+  };
+
+  return std::make_shared<const UsableThumbnail>(UsableThumbnail{
+      .data = std::move(*embeddedThumbnail),
+      .parameters = thumbnailParameters,
+  });
+}
+} // namespace
+
+bool LibJpegEmbeddedThumbnailRecipe::shouldUseThumbnail(
+    const core::Operation& operation) {
+  operation.ruleState = findUsableThumbnail(operation);
+  return operation.ruleState != nullptr;
+}
+
+image::Specification LibJpegEmbeddedThumbnailRecipe::perform(
+    const core::Operation& operation) const {
+  const auto thumbnail =
+      std::static_pointer_cast<const UsableThumbnail>(operation.ruleState);
+  SPECTRUM_ENFORCE_IF(thumbnail == nullptr);
+
+  io::IntVectorEncodedImageSource thumbnailSource{thumbnail->data};
+  const auto thumbnailOperation = core::Operation{
+      .io = {.source = thumbnailSource, .sink = operation.io.sink},
+      .codecs = operation.codecs,
+      .parameters = thumbnail->parameters,
+      .configuration = operation.configuration,
+  };
+
+  return core::recipes::BaseRecipe{}.perform(thumbnailOperation);
+}
+
+} // namespace jpeg
+} // namespace plugins
+} // namespace spectrum
+} // namespace facebook
@@ -0,0 +1,39 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include <spectrum/Recipe.h>
+
+namespace facebook {
+namespace spectrum {
+namespace plugins {
+namespace jpeg {
+
+/**
+ * Decodes the thumbnail embedded in the EXIF metadata of the input JPEG
+ * instead of the image itself if it shows the whole image and the resized
+ * output wouldn't be larger than it. The output has the size and orientation
+ * it would have if the image was decoded.
+ *
+ * Only used if enabled by `Configuration::Jpeg::useEmbeddedThumbnail`. Only
+ * performs operations that `shouldUseThumbnail` has accepted.
+ */
+class LibJpegEmbeddedThumbnailRecipe : public Recipe {
+ public:
+  image::Specification perform(const core::Operation& operation) const override;
+
+  /**
+   * True if the thumbnail is enabled, embedded in the input and fits the
+   * operation. The thumbnail is then kept in the operation's rule state for
+   * `perform`.
+   */
+  static bool shouldUseThumbnail(const core::Operation& operation);
+};
+
+} // namespace jpeg
+} // namespace plugins
+} // namespace spectrum
+} // namespace facebook
@@ -16,6 +16,8 @@ namespace jpeg {
 
 image::Specification LibJpegLosslessRotateAndCropRecipe::perform(
     const core::Operation& operation) const {
+  operation.rewindSource();
+
   LibJpegDctTransformer dctTransformer{operation.io.source, operation.io.sink};
 
   dctTransformer.setRotateRequirement(
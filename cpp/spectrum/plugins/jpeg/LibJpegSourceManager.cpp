@@ -59,6 +59,17 @@ int LibJpegSourceManager::imageSourceFillInputBuffer(j_decompress_ptr dinfo) {
 
   static_assert(
       sizeof(JOCTET) == sizeof(char), "JOCTET and char have different size");
+
+  // let libjpeg read straight from the source's memory if it has any
+  const auto contiguousBytes = src->source.contiguousBytes();
+  if (contiguousBytes.hasValue() && !contiguousBytes->empty()) {
+    src->startOfFile = false;
+    src->libJpegSourceManager.next_input_byte = contiguousBytes->data();
+    src->libJpegSourceManager.bytes_in_buffer =
+        src->source.skip(contiguousBytes->size());
+    return true;
+  }
+
   std::size_t bytesRead = src->source.read(
       reinterpret_cast<char*>(src->buffer.data()), src->buffer.size());
 
@@ -99,19 +110,7 @@ void LibJpegSourceManager::imageSourceSkipInputData(
       bytesToSkip = bytesToSkip - src->libJpegSourceManager.bytes_in_buffer;
 
       // and skipping the source
-      while (bytesToSkip > 0) {
-        const std::size_t bytesToRead =
-            std::min(bytesToSkip, src->buffer.size());
-
-        static_assert(
-            sizeof(JOCTET) == sizeof(char),
-            "JOCTET and char have different size");
-        std::size_t bytesSkipped = src->source.read(
-            reinterpret_cast<char*>(src->buffer.data()), bytesToRead);
-        bytesToSkip -= bytesSkipped;
-
-        SPECTRUM_ENFORCE_IF_NOT(bytesSkipped > 0);
-      }
+      SPECTRUM_ENFORCE_IF_NOT(src->source.skip(bytesToSkip) == bytesToSkip);
 
       src->libJpegSourceManager.next_input_byte = nullptr;
       src->libJpegSourceManager.bytes_in_buffer = 0;
@@ -9,6 +9,7 @@
 #include <spectrum/codecs/Repository.h>
 #include <spectrum/plugins/jpeg/LibJpegCompressor.h>
 #include <spectrum/plugins/jpeg/LibJpegDecompressor.h>
+#include <spectrum/plugins/jpeg/LibJpegEmbeddedThumbnailRecipe.h>
 #include <spectrum/plugins/jpeg/LibJpegLosslessRotateAndCropRecipe.h>
 
 #include <memory>
@@ -101,11 +102,27 @@ Rule makeLibJpegLosslessRotateCropTranscodeRule() {
       .rotateSupport = Rule::RotateSupport::MultipleOf90,
   };
 }
+
+Rule makeLibJpegEmbeddedThumbnailRule() {
+  return Rule{
+      .name = "libjpeg_embedded_thumbnail",
+      .recipeFactory =
+          []() { return std::make_unique<LibJpegEmbeddedThumbnailRecipe>(); },
+      .allowedInputFormats = {image::formats::Jpeg},
+      .requiresEqualInputOutputFormat = false,
+      .isPassthrough = false,
+      .cropSupport = Rule::CropSupport::None,
+      .resizeSupport = Rule::ResizeSupport::Exact,
+      .rotateSupport = Rule::RotateSupport::MultipleOf90Flip,
+      .operationPredicate = &LibJpegEmbeddedThumbnailRecipe::shouldUseThumbnail,
+  };
+}
 } // namespace
 
 Plugin makeTranscodingPlugin() {
   auto plugin = Plugin{};
   plugin.rules.push_back(makeLibJpegLosslessRotateCropTranscodeRule());
+  plugin.rules.push_back(makeLibJpegEmbeddedThumbnailRule());
   plugin.decompressorProviders.push_back(makeLibJpegDecompressorProvider());
   plugin.compressorProviders.push_back(makeLibJpegCompressorProvider());
   return plugin;
@@ -5,6 +5,7 @@
 
 #include "LibJpegUtilities.h"
 
+#include <spectrum/image/metadata/Entries.h>
 #include <spectrum/plugins/jpeg/LibJpegConstants.h>
 #include <string>
 
@@ -69,6 +70,20 @@ image::Metadata readMetadata(jpeg_decompress_struct& libJpegDecompressInfo) {
       extractXmp(libJpegDecompressInfo)};
 }
 
+folly::Optional<std::vector<std::uint8_t>> readEmbeddedThumbnail(
+    jpeg_decompress_struct& libJpegDecompressInfo) {
+  for (const auto& dataRange :
+       extractDataRangesForMarker(libJpegDecompressInfo, JPEG_APP1)) {
+    const auto thumbnail = image::metadata::Entries::findThumbnail(
+        dataRange.begin, dataRange.length);
+    if (thumbnail.hasValue()) {
+      return std::vector<std::uint8_t>(thumbnail->begin, thumbnail->end());
+    }
+  }
+
+  return folly::none;
+}
+
 void writeMetadata(
     jpeg_compress_struct& libJpegCompressInfo,
     const image::Metadata& metadata) {
@@ -10,8 +10,11 @@
 
 #include <mozjpeg/jpeglib.h>
 
+#include <cstdint>
 #include <vector>
 
+#include <folly/Optional.h>
+
 namespace facebook {
 namespace spectrum {
 namespace plugins {
@@ -33,6 +36,17 @@ void saveMetadataMarkers(jpeg_decompress_struct& libJpegDecompressInfo);
  */
 image::Metadata readMetadata(jpeg_decompress_struct& libJpegDecompressInfo);
 
+/**
+ * Reads the JPEG thumbnail embedded in the EXIF data of the jpeg decompress
+ * structure.
+ *
+ * @param libJpegDecompressInfo The structure to extract the thumbnail from.
+ * @return The thumbnail's encoded bytes. Will be none if the image has no
+ * thumbnail or the corresponding markers haven't been saved.
+ */
+folly::Optional<std::vector<std::uint8_t>> readEmbeddedThumbnail(
+    jpeg_decompress_struct& libJpegDecompressInfo);
+
 /**
  * Writes metadata into the jpeg compress structure.
  *
@@ -163,6 +163,29 @@ void LibPngCompressor::ensureHeaderIsWritten(
   png_write_info(libPngWriteStruct, libPngInfoStruct);
 }
 
+void LibPngCompressor::ensureReadyToWriteScanline(
+    const image::Scanline& scanline) {
+  const auto pixelSpecification = scanline.specification();
+  if (pixelSpecification == image::pixel::specifications::Gray ||
+      pixelSpecification == image::pixel::specifications::RGB ||
+      pixelSpecification == image::pixel::specifications::RGBA ||
+      pixelSpecification == image::pixel::specifications::ARGB) {
+    ensureHeaderIsWritten(
+        colorTypeFromPixelSpecification(pixelSpecification),
+        swapAlphaFromPixelSpecification(pixelSpecification));
+
+    SPECTRUM_ENFORCE_IF_NOT(
+        pixelSpecification == _options.imageSpecification.pixelSpecification);
+    SPECTRUM_ENFORCE_IF_NOT(
+        scanline.width() == _options.imageSpecification.size.width);
+    SPECTRUM_ENFORCE_IF(writtenLastScanline);
+  } else {
+    SPECTRUM_ERROR_STRING(
+        codecs::error::CompressorCannotWritePixelSpecification,
+        pixelSpecification.string());
+  }
+}
+
 void LibPngCompressor::finishIfLastScanlineWritten() {
   if (!writtenLastScanline &&
       inputScanline == _options.imageSpecification.size.height) {
@@ -187,6 +210,30 @@ void LibPngCompressor::internalWriteScanlineBaseline(
   finishIfLastScanlineWritten();
 }
 
+void LibPngCompressor::internalWriteScanlinesBaseline(
+    std::vector<std::unique_ptr<image::Scanline>> scanlines) {
+  SPECTRUM_ENFORCE_IF_NOT(
+      scanlines.size() <=
+      _options.imageSpecification.size.height - inputScanline);
+
+  std::vector<png_bytep> rows;
+  rows.reserve(scanlines.size());
+  for (const auto& scanline : scanlines) {
+    rows.push_back(reinterpret_cast<png_bytep>(scanline->data()));
+  }
+
+  if (setjmp(png_jmpbuf(libPngWriteStruct))) {
+    throwError(__PRETTY_FUNCTION__, __LINE__, "png_write_rows");
+  }
+  png_write_rows(
+      libPngWriteStruct,
+      rows.data(),
+      static_cast<png_uint_32>(rows.size()));
+
+  inputScanline += scanlines.size();
+  finishIfLastScanlineWritten();
+}
+
 void LibPngCompressor::internalWriteScanlineInterlaced(
     std::unique_ptr<image::Scanline> scanline) {
   // buffer incoming scanlines
@@ -241,30 +288,27 @@ void LibPngCompressor::throwError(
 
 void LibPngCompressor::writeScanline(
     std::unique_ptr<image::Scanline> scanline) {
-  const auto pixelSpecification = scanline->specification();
-  if (pixelSpecification == image::pixel::specifications::Gray ||
-      pixelSpecification == image::pixel::specifications::RGB ||
-      pixelSpecification == image::pixel::specifications::RGBA ||
-      pixelSpecification == image::pixel::specifications::ARGB) {
-    ensureHeaderIsWritten(
-        colorTypeFromPixelSpecification(pixelSpecification),
-        swapAlphaFromPixelSpecification(pixelSpecification));
+  ensureReadyToWriteScanline(*scanline);
 
-    SPECTRUM_ENFORCE_IF_NOT(
-        pixelSpecification == _options.imageSpecification.pixelSpecification);
-    SPECTRUM_ENFORCE_IF_NOT(
-        scanline->width() == _options.imageSpecification.size.width);
-    SPECTRUM_ENFORCE_IF(writtenLastScanline);
+  if (_options.configuration.png.useInterlacing()) {
+    return internalWriteScanlineInterlaced(std::move(scanline));
+  } else {
+    return internalWriteScanlineBaseline(std::move(scanline));
+  }
+}
+
+void LibPngCompressor::writeScanlines(
+    std::vector<std::unique_ptr<image::Scanline>> scanlines) {
+  for (const auto& scanline : scanlines) {
+    ensureReadyToWriteScanline(*scanline);
+  }
 
-    if (_options.configuration.png.useInterlacing()) {
-      return internalWriteScanlineInterlaced(std::move(scanline));
-    } else {
-      return internalWriteScanlineBaseline(std::move(scanline));
+  if (_options.configuration.png.useInterlacing()) {
+    for (auto& scanline : scanlines) {
+      internalWriteScanlineInterlaced(std::move(scanline));
     }
   } else {
-    SPECTRUM_ERROR_STRING(
-        codecs::error::CompressorCannotWritePixelSpecification,
-        pixelSpecification.string());
+    internalWriteScanlinesBaseline(std::move(scanlines));
   }
 }
 
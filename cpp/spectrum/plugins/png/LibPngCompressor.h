@@ -62,9 +62,12 @@ class LibPngCompressor final : public codecs::ICompressor {
   void ensureHeaderIsWritten(
       const std::uint16_t colorType,
       const bool swapAlpha);
+  void ensureReadyToWriteScanline(const image::Scanline& scanline);
   void finishIfLastScanlineWritten();
 
   void internalWriteScanlineBaseline(std::unique_ptr<image::Scanline> scanline);
+  void internalWriteScanlinesBaseline(
+      std::vector<std::unique_ptr<image::Scanline>> scanlines);
   void internalWriteScanlineInterlaced(
       std::unique_ptr<image::Scanline> scanline);
 
@@ -79,6 +82,8 @@ class LibPngCompressor final : public codecs::ICompressor {
   //
  public:
   void writeScanline(std::unique_ptr<image::Scanline> scanline) override;
+  void writeScanlines(
+      std::vector<std::unique_ptr<image::Scanline>> scanlines) override;
 };
 
 } // namespace png
@@ -181,8 +181,10 @@ void LibPngDecompressor::ensureReadyToReadScanline() {
 
 std::unique_ptr<image::Scanline> LibPngDecompressor::readOneLine() {
   const auto imageSpecification = sourceImageSpecification();
-  auto scanline = std::make_unique<image::Scanline>(
-      imageSpecification.pixelSpecification, imageSpecification.size.width);
+  auto scanline = image::makeScanline(
+      _scanlinePool,
+      imageSpecification.pixelSpecification,
+      imageSpecification.size.width);
 
   if (setjmp(png_jmpbuf(libPngReadStruct))) {
     throwError(__PRETTY_FUNCTION__, __LINE__, "png_read_row");
@@ -194,6 +196,35 @@ std::unique_ptr<image::Scanline> LibPngDecompressor::readOneLine() {
   return scanline;
 }
 
+std::vector<std::unique_ptr<image::Scanline>> LibPngDecompressor::readLines(
+    const std::size_t numberOfLines) {
+  const auto imageSpecification = sourceImageSpecification();
+  std::vector<std::unique_ptr<image::Scanline>> scanlines;
+  std::vector<png_bytep> rows;
+  scanlines.reserve(numberOfLines);
+  rows.reserve(numberOfLines);
+
+  for (std::size_t i = 0; i < numberOfLines; ++i) {
+    scanlines.push_back(image::makeScanline(
+        _scanlinePool,
+        imageSpecification.pixelSpecification,
+        imageSpecification.size.width));
+    rows.push_back(reinterpret_cast<png_bytep>(scanlines.back()->data()));
+  }
+
+  if (setjmp(png_jmpbuf(libPngReadStruct))) {
+    throwError(__PRETTY_FUNCTION__, __LINE__, "png_read_rows");
+  }
+  png_read_rows(
+      libPngReadStruct,
+      rows.data(),
+      nullptr,
+      static_cast<png_uint_32>(numberOfLines));
+
+  outputScanline += numberOfLines;
+  return scanlines;
+}
+
 void LibPngDecompressor::ensureEntireImageIsRead(
     std::vector<std::unique_ptr<image::Scanline>>* imageVector) {
   const auto imageSpecification = sourceImageSpecification();
@@ -316,6 +347,28 @@ std::unique_ptr<image::Scanline> LibPngDecompressor::readScanline() {
   }
 }
 
+std::vector<std::unique_ptr<image::Scanline>> LibPngDecompressor::readScanlines(
+    const std::size_t numberOfScanlines) {
+  ensureReadyToReadScanline();
+
+  SPECTRUM_ENFORCE_IF_NOT(
+      numberOfScanlines <=
+      sourceImageSpecification().size.height - outputScanline);
+
+  if (isInterlaced) {
+    ensureEntireImageIsRead(&entireImage);
+
+    std::vector<std::unique_ptr<image::Scanline>> scanlines;
+    scanlines.reserve(numberOfScanlines);
+    for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+      scanlines.push_back(std::move(entireImage[outputScanline++]));
+    }
+    return scanlines;
+  } else {
+    return readLines(numberOfScanlines);
+  }
+}
+
 } // namespace png
 } // namespace plugins
 } // namespace spectrum
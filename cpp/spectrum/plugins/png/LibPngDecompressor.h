@@ -72,6 +72,8 @@ class LibPngDecompressor final : public codecs::IDecompressor {
       const char* const culprit);
 
   std::unique_ptr<image::Scanline> readOneLine();
+  std::vector<std::unique_ptr<image::Scanline>> readLines(
+      const std::size_t numberOfLines);
 
   void ensureEntireImageIsRead(
       std::vector<std::unique_ptr<image::Scanline>>* imageVector);
@@ -85,6 +87,8 @@ class LibPngDecompressor final : public codecs::IDecompressor {
   image::Specification outputImageSpecification() override;
 
   std::unique_ptr<image::Scanline> readScanline() override;
+  std::vector<std::unique_ptr<image::Scanline>> readScanlines(
+      const std::size_t numberOfScanlines) override;
 };
 
 } // namespace png
@@ -50,11 +50,6 @@ LibWebpCompressor::LibWebpCompressor(const codecs::CompressorOptions& options)
   ICompressor::enforceSizeBelowMaximumSideDimension(
       options.imageSpecification.size, maximumSizeDimension);
 
-  // This is less than ideal, but I don't believe there's a straightforward way
-  // to incrementally encode with webp. Will review this at a later stage.
-  _pixels.reserve(
-      options.imageSpecification.size.width *
-      options.imageSpecification.size.height);
   _initialiseConfiguration();
   _initialisePicture();
 }
@@ -72,15 +67,29 @@ void LibWebpCompressor::writeScanline(
       pixelSpecification.string());
 
   _ensureHeaderWritten();
-
-  _pixels.insert(
-      _pixels.cend(),
-      scanline->data(),
-      scanline->data() + scanline->sizeBytes());
+  _importScanline(*scanline);
 
   scanline = nullptr;
 
-  ++_currentScanline;
+  _encodeIfFinished();
+}
+
+void LibWebpCompressor::writeScanlines(
+    std::vector<std::unique_ptr<image::Scanline>> scanlines) {
+  for (const auto& scanline : scanlines) {
+    const auto pixelSpecification = scanline->specification();
+    SPECTRUM_ERROR_STRING_IF_NOT(
+        pixelSpecification == image::pixel::specifications::RGBA,
+        codecs::error::CompressorCannotWritePixelSpecification,
+        pixelSpecification.string());
+  }
+
+  _ensureHeaderWritten();
+
+  for (auto& scanline : scanlines) {
+    _importScanline(*scanline);
+    scanline = nullptr;
+  }
 
   _encodeIfFinished();
 }
@@ -96,6 +105,10 @@ void LibWebpCompressor::_initialiseConfiguration() {
   _webp.configuration.method = _options.configuration.webp.method();
   _webp.configuration.image_hint =
       convertToWebPImageHint(_options.configuration.webp.imageHint());
+  _webp.configuration.thread_level =
+      _options.configuration.webp.useThreads() ? 1 : 0;
+  _webp.configuration.low_memory =
+      _options.configuration.webp.useLowMemory() ? 1 : 0;
 
   const auto didValidateConfig = WebPValidateConfig(&_webp.configuration);
 
@@ -121,6 +134,26 @@ void LibWebpCompressor::_initialisePicture() {
   _webp.picture.custom_ptr = &_options.sink;
 }
 
+void LibWebpCompressor::_importScanline(const image::Scanline& scanline) {
+  const auto width = _options.imageSpecification.size.width;
+  SPECTRUM_ENFORCE_IF_NOT(
+      _currentScanline < _options.imageSpecification.size.height);
+  SPECTRUM_ENFORCE_IF_NOT(scanline.width() == width);
+
+  // same packing as WebPPictureImportRGBA
+  const auto* rgba = scanline.data();
+  auto* const argb =
+      _webp.picture.argb + _currentScanline * _webp.picture.argb_stride;
+  for (std::size_t x = 0; x < width; ++x, rgba += 4) {
+    argb[x] = (static_cast<std::uint32_t>(rgba[3]) << 24) |
+        (static_cast<std::uint32_t>(rgba[0]) << 16) |
+        (static_cast<std::uint32_t>(rgba[1]) << 8) |
+        static_cast<std::uint32_t>(rgba[2]);
+  }
+
+  ++_currentScanline;
+}
+
 int LibWebpCompressor::_writeHandler(
     const std::uint8_t* data,
     std::size_t dataSize,
@@ -136,19 +169,6 @@ void LibWebpCompressor::_encodeIfFinished() {
     return;
   }
 
-  const auto didImportPicture = WebPPictureImportRGBA(
-      &_webp.picture,
-      _pixels.data(),
-      _options.imageSpecification.size.width *
-          image::pixel::specifications::RGBA.bytesPerPixel);
-
-  _pixels.clear();
-
-  SPECTRUM_ERROR_CSTR_IF_NOT(
-      didImportPicture,
-      codecs::error::CompressorFailure,
-      "webp_picture_import_failed");
-
   const auto didEncodePicture =
       WebPEncode(&_webp.configuration, &_webp.picture);
 
@@ -179,6 +199,16 @@ void LibWebpCompressor::_ensureHeaderWritten() {
     }
   }
 
+  // scanlines are imported straight into the picture's ARGB buffer. lossy
+  // encoding converts it to YUV when encoding the whole picture. allocating
+  // here rather than in the constructor keeps unused compressors movable
+  const auto didAllocatePicture = WebPPictureAlloc(&_webp.picture);
+
+  SPECTRUM_ERROR_CSTR_IF_NOT(
+      didAllocatePicture,
+      codecs::error::CompressorFailure,
+      "webp_picture_alloc_failed");
+
   _wasHeaderWritten = true;
 }
 
@@ -36,8 +36,6 @@ class LibWebpCompressor final : public codecs::ICompressor {
   const codecs::CompressorOptions _options;
   const requirements::Encode::Quality _quality;
 
-  std::vector<std::uint8_t> _pixels;
-
   WebP _webp;
   std::size_t _currentScanline{0};
   bool _wasHeaderWritten{false};
@@ -45,6 +43,7 @@ class LibWebpCompressor final : public codecs::ICompressor {
   void _initialiseConfiguration();
   void _initialisePicture();
   void _ensureHeaderWritten();
+  void _importScanline(const image::Scanline& scanline);
   void _encodeIfFinished();
 
   static int _writeHandler(
@@ -64,6 +63,8 @@ class LibWebpCompressor final : public codecs::ICompressor {
   //
  public:
   void writeScanline(std::unique_ptr<image::Scanline> scanline) override;
+  void writeScanlines(
+      std::vector<std::unique_ptr<image::Scanline>> scanlines) override;
 };
 } // namespace webp
 } // namespace plugins
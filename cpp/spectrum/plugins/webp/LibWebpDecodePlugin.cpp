@@ -30,7 +30,16 @@ inline codecs::DecompressorProvider::Factory makeLibWebpDecompressorFactory() {
 codecs::DecompressorProvider makeLibWebpDecompressorProvider() {
   return {
       .format = image::formats::Webp,
-      .supportedSamplingRatios = {},
+      .supportedSamplingRatios =
+          {
+              {1, 8},
+              {2, 8},
+              {3, 8},
+              {4, 8},
+              {5, 8},
+              {6, 8},
+              {7, 8},
+          },
       .decompressorFactory = makeLibWebpDecompressorFactory(),
   };
 }
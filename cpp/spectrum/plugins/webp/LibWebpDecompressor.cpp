@@ -19,6 +19,7 @@
 
 #include <folly/Optional.h>
 
+#include <algorithm>
 #include <array>
 #include <csetjmp>
 #include <memory>
@@ -47,20 +48,37 @@ WEBP_CSP_MODE pixelSpecificationToCspMode(
 }
 } // namespace
 
+struct LibWebpDecompressor::Decoder {
+  // the incremental decoder keeps pointers to the configuration's options and
+  // output buffer
+  WebPDecoderConfig config{};
+
+  // libwebp's struct to maintain state
+  WebPIDecoder* webpDecoder = nullptr;
+
+  ~Decoder() {
+    if (webpDecoder != nullptr) {
+      WebPIDelete(webpDecoder);
+    }
+    WebPFreeDecBuffer(&config.output);
+  }
+};
+
 LibWebpDecompressor::LibWebpDecompressor(
     io::IImageSource& source,
     const folly::Optional<image::Ratio>& samplingRatio,
     const folly::Optional<image::pixel::Specification>&
         overridePixelSpecification)
-    : _source(source), _overridePixelSpecification(overridePixelSpecification) {
-  IDecompressor::_ensureNoSamplingRatio(samplingRatio);
+    : _source(source),
+      _samplingRatio(samplingRatio.value_or(LIBWEBP_SCALE_DEFAULT)),
+      _overridePixelSpecification(overridePixelSpecification) {
+  SPECTRUM_ENFORCE_IF(_samplingRatio.numerator < LIBWEBP_SCALE_NUMERATOR_MIN);
+  SPECTRUM_ENFORCE_IF(_samplingRatio.numerator > LIBWEBP_SCALE_NUMERATOR_MAX);
+  SPECTRUM_ENFORCE_IF_NOT(
+      _samplingRatio.denominator == LIBWEBP_SCALE_DENOMINATOR);
 }
 
-LibWebpDecompressor::~LibWebpDecompressor() {
-  if (_webpDecoder != nullptr) {
-    WebPIDelete(_webpDecoder);
-  }
-}
+LibWebpDecompressor::~LibWebpDecompressor() = default;
 
 //
 // Private
@@ -108,22 +126,18 @@ void LibWebpDecompressor::_ensureHeaderIsRead() {
   _isHeaderRead = true;
 }
 
-void LibWebpDecompressor::_ensureImageIsRead() {
-  if (_isImageRead) {
+void LibWebpDecompressor::_ensureDecoderIsCreated() {
+  if (_decoder != nullptr) {
     return;
   }
 
   _ensureHeaderIsRead();
 
-  // init buffer
-  const auto pixelSpecification = outputImageSpecification().pixelSpecification;
-  const auto bytesPerPixel = pixelSpecification.bytesPerPixel;
-  const auto stride = _webpFeatures.width * bytesPerPixel;
-
-  _rawImage.resize(_webpFeatures.height * stride);
+  const auto outputImageSpecification = this->outputImageSpecification();
 
   // init config
-  WebPDecoderConfig config;
+  auto decoder = std::make_shared<Decoder>();
+  auto& config = decoder->config;
   const auto webpConfigInitSuccess = WebPInitDecoderConfig(&config);
 
   SPECTRUM_ERROR_CSTR_IF_NOT(
@@ -131,83 +145,159 @@ void LibWebpDecompressor::_ensureImageIsRead() {
       codecs::error::DecompressorFailure,
       "webp_init_decoder_config_failed");
 
+  // set options
+  config.options.no_fancy_upsampling = 1;
+  config.options.use_threads = 0;
+
+  // libwebp's rescaler downsamples rows while decoding them
+  if (!_samplingRatio.one()) {
+    config.options.use_scaling = 1;
+    config.options.scaled_width = outputImageSpecification.size.width;
+    config.options.scaled_height = outputImageSpecification.size.height;
+  }
+
+  // libwebp allocates the output buffer and fills it as input is appended
+  config.output.colorspace =
+      pixelSpecificationToCspMode(outputImageSpecification.pixelSpecification);
+
   // init decoder
-  _webpDecoder = WebPINewDecoder(&config.output);
+  decoder->webpDecoder = WebPIDecode(nullptr, 0, &config);
 
   SPECTRUM_ERROR_CSTR_IF(
-      _webpDecoder == nullptr,
+      decoder->webpDecoder == nullptr,
       codecs::error::DecompressorFailure,
-      "webp_i_new_decoder_failed");
+      "webp_i_decode_failed");
 
-  // collect rest of input
-  std::size_t bytesRead;
-  do {
-    std::array<char, core::DefaultBufferSize> chunk{};
-    bytesRead = _source.read(chunk.data(), core::DefaultBufferSize);
-    std::copy_n(chunk.begin(), bytesRead, std::back_inserter(_webpPayload));
-  } while (bytesRead > 0);
+  _decoder = std::move(decoder);
 
-  // read image information
-  const auto getFeaturesStatus = WebPGetFeatures(
-      reinterpret_cast<std::uint8_t*>(_webpPayload.data()),
-      _webpPayload.size(),
-      &config.input);
+  // sources in contiguous memory are not copied into the decoder; the header
+  // bytes read so far directly precede the remaining ones
+  const auto contiguousBytes = _source.contiguousBytes();
+  if (contiguousBytes.hasValue()) {
+    _sharedInput = contiguousBytes->data() - _webpPayload.size();
+  }
 
-  SPECTRUM_ERROR_CSTR_IF_NOT(
-      getFeaturesStatus == VP8_STATUS_OK,
-      codecs::error::DecompressorFailure,
-      "webp_get_features_failed");
+  // replay the bytes consumed while parsing the header
+  _appendToDecoder(
+      reinterpret_cast<const std::uint8_t*>(_webpPayload.data()),
+      _webpPayload.size());
+  _webpPayload.clear();
+  _webpPayload.shrink_to_fit();
+}
 
-  // set options
-  config.options.no_fancy_upsampling = 1;
-  config.options.use_threads = 0;
+void LibWebpDecompressor::_ensureScanlinesAreDecoded(
+    const std::size_t numberOfScanlines) {
+  _ensureDecoderIsCreated();
+
+  std::array<char, core::DefaultBufferSize> chunk{};
+  while (_decodedScanlines < numberOfScanlines) {
+    // a complete image that lacks scanlines or a truncated input are both
+    // unrecoverable
+    SPECTRUM_ERROR_CSTR_IF(
+        _isImageDecoded,
+        codecs::error::DecompressorFailure,
+        "webp_decode_failed");
+
+    const std::uint8_t* bytes = nullptr;
+    std::size_t bytesRead = 0;
+    if (_sharedInput != nullptr) {
+      bytes = _sharedInput + _sharedInputLength;
+      bytesRead = _source.skip(chunk.size());
+    } else {
+      bytes = reinterpret_cast<const std::uint8_t*>(chunk.data());
+      bytesRead = _source.read(chunk.data(), chunk.size());
+    }
 
-  config.output.colorspace = pixelSpecificationToCspMode(pixelSpecification);
-  config.output.is_external_memory = 1;
-  config.output.u.RGBA.rgba = _rawImage.data();
-  config.output.u.RGBA.size = _rawImage.size();
-  config.output.u.RGBA.stride = stride;
+    SPECTRUM_ERROR_CSTR_IF(
+        bytesRead == 0,
+        codecs::error::DecompressorFailure,
+        "webp_decode_failed");
 
-  // decode image
-  const auto decodeStatus = WebPDecode(
-      reinterpret_cast<std::uint8_t*>(_webpPayload.data()),
-      _webpPayload.size(),
-      &config);
-  _webpPayload.clear(); // payload bytes are no longer needed
+    _appendToDecoder(bytes, bytesRead);
+  }
+}
+
+void LibWebpDecompressor::_appendToDecoder(
+    const std::uint8_t* data,
+    const std::size_t length) {
+  if (length == 0) {
+    return;
+  }
+
+  auto appendStatus = VP8_STATUS_OK;
+  if (_sharedInput != nullptr) {
+    // the bytes directly follow the ones libwebp has already been handed, so
+    // it only needs to be told that more of the stream is available
+    _sharedInputLength += length;
+    appendStatus = WebPIUpdate(
+        _decoder->webpDecoder, _sharedInput, _sharedInputLength);
+  } else {
+    appendStatus = WebPIAppend(_decoder->webpDecoder, data, length);
+  }
 
   SPECTRUM_ERROR_CSTR_IF_NOT(
-      decodeStatus == VP8_STATUS_OK,
+      appendStatus == VP8_STATUS_OK || appendStatus == VP8_STATUS_SUSPENDED,
       codecs::error::DecompressorFailure,
       "webp_decode_failed");
 
-  _isImageRead = true;
+  _isImageDecoded = appendStatus == VP8_STATUS_OK;
+
+  // rows above lastY are final and won't be touched by further appends
+  int lastY = 0;
+  WebPIDecGetRGB(_decoder->webpDecoder, &lastY, nullptr, nullptr, nullptr);
+  if (lastY > 0) {
+    _decodedScanlines =
+        std::max(_decodedScanlines, static_cast<std::size_t>(lastY));
+  }
 }
 
 std::unique_ptr<image::Scanline> LibWebpDecompressor::readScanline() {
-  _ensureImageIsRead();
-  SPECTRUM_ENFORCE_IF_NOT(_outputScanline < _webpFeatures.height);
+  auto scanlines = readScanlines(1);
+  return std::move(scanlines.front());
+}
+
+std::vector<std::unique_ptr<image::Scanline>>
+LibWebpDecompressor::readScanlines(const std::size_t numberOfScanlines) {
+  const auto outputImageSpecification = this->outputImageSpecification();
+  const auto height = outputImageSpecification.size.height;
+  SPECTRUM_ENFORCE_IF_NOT(numberOfScanlines <= height - _outputScanline);
 
-  const auto pixelSpecification = outputImageSpecification().pixelSpecification;
+  if (numberOfScanlines == 0) {
+    return {};
+  }
 
-  const auto width = _webpFeatures.width;
-  auto scanline = std::make_unique<image::Scanline>(pixelSpecification, width);
+  const auto pixelSpecification = outputImageSpecification.pixelSpecification;
+  const auto width = outputImageSpecification.size.width;
 
-  const std::size_t bytesPerPixel = pixelSpecification.bytesPerPixel;
-  const auto stride = width * bytesPerPixel;
-  const auto offset = _outputScanline * stride;
+  _ensureScanlinesAreDecoded(_outputScanline + numberOfScanlines);
 
-  SPECTRUM_ENFORCE_IF_NOT(offset + stride <= _rawImage.size());
+  int stride = 0;
+  auto* const decodedImage = WebPIDecGetRGB(
+      _decoder->webpDecoder, nullptr, nullptr, nullptr, &stride);
 
-  std::memcpy(scanline->data(), _rawImage.data() + offset, stride);
+  SPECTRUM_ERROR_CSTR_IF(
+      decodedImage == nullptr,
+      codecs::error::DecompressorFailure,
+      "webp_i_dec_get_rgb_failed");
 
-  ++_outputScanline;
+  std::vector<std::unique_ptr<image::Scanline>> scanlines;
+  scanlines.reserve(numberOfScanlines);
 
-  // free memory early
-  if (_outputScanline == _webpFeatures.height) {
-    _rawImage.clear();
+  // rows are final once decoded, hence they can be handed out without copying
+  auto* decodedRow = decodedImage + _outputScanline * stride;
+  for (std::size_t i = 0; i < numberOfScanlines; ++i, decodedRow += stride) {
+    scanlines.push_back(std::make_unique<image::Scanline>(
+        pixelSpecification, decodedRow, width, _decoder));
   }
 
-  return scanline;
+  _outputScanline += numberOfScanlines;
+
+  // the decoder lives on until the last scanline is released
+  if (_outputScanline == height) {
+    _decoder = nullptr;
+  }
+
+  return scanlines;
 }
 
 image::Specification LibWebpDecompressor::sourceImageSpecification() {
@@ -237,6 +327,12 @@ image::Specification LibWebpDecompressor::sourceImageSpecification() {
 image::Specification LibWebpDecompressor::outputImageSpecification() {
   auto outputImageSpecification = sourceImageSpecification();
 
+  // rounded up like the resize decision's size after sampling
+  if (!_samplingRatio.one()) {
+    outputImageSpecification.size = outputImageSpecification.size.scaled(
+        _samplingRatio, core::numeric::RoundingMode::Up);
+  }
+
   if (_overridePixelSpecification.hasValue()) {
     outputImageSpecification.pixelSpecification = *_overridePixelSpecification;
   }
@@ -18,12 +18,19 @@
 #endif
 
 #include <memory>
+#include <vector>
 
 namespace facebook {
 namespace spectrum {
 namespace plugins {
 namespace webp {
 
+constexpr int LIBWEBP_SCALE_DENOMINATOR = 8;
+constexpr int LIBWEBP_SCALE_NUMERATOR_MIN = 1;
+constexpr int LIBWEBP_SCALE_NUMERATOR_MAX = 8;
+constexpr auto LIBWEBP_SCALE_DEFAULT =
+    image::Ratio{LIBWEBP_SCALE_DENOMINATOR, LIBWEBP_SCALE_DENOMINATOR};
+
 /**
  * LibWebpDecompressor is a wrapper around libwebp. It manages the underlying
  * resource, handles the conversion to Spectrum types and helps to prevent
@@ -43,28 +50,38 @@ class LibWebpDecompressor final : public codecs::IDecompressor {
 
  private:
   io::IImageSource& _source;
+  const image::Ratio _samplingRatio;
   folly::Optional<image::pixel::Specification> _overridePixelSpecification;
 
-  // libwebp's struct to maintain state
-  WebPIDecoder* _webpDecoder = nullptr;
+  // libwebp's incremental decoder and its configuration. Scanlines handed out
+  // are views into the decoder's output buffer and share its ownership
+  struct Decoder;
+  std::shared_ptr<Decoder> _decoder;
 
   // contains width, height, has_alpha and similar header fields
   WebPBitstreamFeatures _webpFeatures;
 
-  // buffer with the raw pixel data after decoding
-  std::vector<std::uint8_t> _rawImage;
-
-  // we have to cache read bytes from the header parsing to re-read it when
-  // decoding the entire image; should not exceed a few bytes and gets cleared
-  // once the entire image is read
+  // we have to cache read bytes from the header parsing to feed them to the
+  // incremental decoder; should not exceed a few bytes and gets cleared once
+  // the decoder is created
   std::vector<char> _webpPayload;
   bool _isHeaderRead = false;
 
+  // set when libwebp decodes straight from the source's memory: the start of
+  // the WebP stream and how many of its bytes libwebp has been handed
+  const std::uint8_t* _sharedInput = nullptr;
+  std::size_t _sharedInputLength = 0;
+
   std::size_t _outputScanline = 0;
-  bool _isImageRead = false;
+
+  // number of leading scanlines the incremental decoder has completed
+  std::size_t _decodedScanlines = 0;
+  bool _isImageDecoded = false;
 
   void _ensureHeaderIsRead();
-  void _ensureImageIsRead();
+  void _ensureDecoderIsCreated();
+  void _ensureScanlinesAreDecoded(const std::size_t numberOfScanlines);
+  void _appendToDecoder(const std::uint8_t* data, const std::size_t length);
 
   folly::Optional<image::Specification> _sourceImageSpecification;
 
@@ -77,6 +94,8 @@ class LibWebpDecompressor final : public codecs::IDecompressor {
   image::Specification outputImageSpecification() override;
 
   std::unique_ptr<image::Scanline> readScanline() override;
+  std::vector<std::unique_ptr<image::Scanline>> readScanlines(
+      const std::size_t numberOfScanlines) override;
 };
 
 } // namespace webp
@@ -4,6 +4,10 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <spectrum/Configuration.h>
+#include <spectrum/core/Executor.h>
+
+#include <cstdint>
+#include <memory>
 
 #include <folly/Optional.h>
 #include <gtest/gtest.h>
@@ -60,6 +64,9 @@ TEST(Configuration, whenRequestingDefaultValue_allParametersAreCorrect) {
   ASSERT_EQ(
       Configuration::General::ChromaSamplingModeOverride::None,
       configuration.general.chromaSamplingModeOverride());
+  ASSERT_EQ(1, configuration.general.numberOfScalingThreads());
+  ASSERT_EQ(nullptr, configuration.general.scalingExecutor());
+  ASSERT_FALSE(configuration.general.usePipelining());
 
   // Jpeg
   ASSERT_TRUE(configuration.jpeg.useTrellis());
@@ -71,6 +78,8 @@ TEST(Configuration, whenRequestingDefaultValue_allParametersAreCorrect) {
       configurationCurrentPlatformValue(true, false),
       configuration.jpeg.useCompatibleDcScanOpt());
   ASSERT_EQ(false, configuration.jpeg.usePsnrQuantTable());
+  ASSERT_EQ(0, configuration.jpeg.maxProgressiveScans());
+  ASSERT_FALSE(configuration.jpeg.useEmbeddedThumbnail());
 
   // Png
   ASSERT_EQ(false, configuration.png.useInterlacing());
@@ -82,6 +91,11 @@ TEST(Configuration, whenRequestingDefaultValue_allParametersAreCorrect) {
   ASSERT_EQ(3, configuration.webp.method());
   ASSERT_EQ(
       Configuration::Webp::ImageHint::Default, configuration.webp.imageHint());
+  ASSERT_FALSE(configuration.webp.useThreads());
+  ASSERT_FALSE(configuration.webp.useLowMemory());
+
+  // Avif
+  ASSERT_EQ(1, configuration.avif.maxThreads());
 }
 
 TEST(
@@ -113,6 +127,28 @@ TEST(
       Configuration::General::ChromaSamplingModeOverride::S444);
 }
 
+TEST(
+    Configuration_General,
+    whenMergingOrComparing_thenNumberOfScalingThreadsIsAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(
+      std::uint32_t, general.numberOfScalingThreads, 4);
+}
+
+TEST(
+    Configuration_General,
+    whenMergingOrComparing_thenScalingExecutorIsAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(
+      std::shared_ptr<core::IExecutor>,
+      general.scalingExecutor,
+      std::make_shared<core::ThreadPoolExecutor>(1));
+}
+
+TEST(
+    Configuration_General,
+    whenMergingOrComparing_thenUsePipeliningIsAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(bool, general.usePipelining, true);
+}
+
 TEST(Configuration_Jpeg, whenMergingOrComparing_thenUseTrellisIsAccountedFor) {
   SPECTRUM_CONFIGURATION_TEST_PROPERTY(bool, jpeg.useTrellis, false);
 }
@@ -147,6 +183,18 @@ TEST(
   SPECTRUM_CONFIGURATION_TEST_PROPERTY(bool, jpeg.usePsnrQuantTable, true);
 }
 
+TEST(
+    Configuration_Jpeg,
+    whenMergingOrComparing_thenMaxProgressiveScansIsAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(int, jpeg.maxProgressiveScans, 2);
+}
+
+TEST(
+    Configuration_Jpeg,
+    whenMergingOrComparing_thenUseEmbeddedThumbnailIsAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(bool, jpeg.useEmbeddedThumbnail, true);
+}
+
 TEST(
     Configuration_Png,
     whenMergingOrComparing_thenUseInterlacingIsAccountedFor) {
@@ -173,6 +221,20 @@ TEST(Configuration_WebP, whenMergingOrComparing_thenImageHintAccountedFor) {
       Configuration::Webp::ImageHint::Graph);
 }
 
+TEST(Configuration_WebP, whenMergingOrComparing_thenUseThreadsAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(bool, webp.useThreads, true);
+}
+
+TEST(
+    Configuration_WebP,
+    whenMergingOrComparing_thenUseLowMemoryAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(bool, webp.useLowMemory, true);
+}
+
+TEST(Configuration_Avif, whenMergingOrComparing_thenMaxThreadsAccountedFor) {
+  SPECTRUM_CONFIGURATION_TEST_PROPERTY(int, avif.maxThreads, 4);
+}
+
 } // namespace test
 } // namespace spectrum
 } // namespace facebook
@@ -4,10 +4,15 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <spectrum/Spectrum.h>
+#include <spectrum/io/VectorImageSink.h>
 #include <spectrum/testutils/TestUtils.h>
 
 #include <array>
+#include <cstddef>
+#include <exception>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <folly/FixedString.h>
 #include <gtest/gtest.h>
@@ -29,6 +34,136 @@ TEST(Spectrum, transcode_whenInputSourceEmpty_thenThrowEmptyInputSource) {
       spectrum.decode(source, sink), spectrum::error::EmptyInputSource);
 }
 
+//
+// Batches
+//
+
+TEST(Spectrum, transcodeBatch_whenNoJobs_thenNoResults) {
+  const auto spectrum = Spectrum();
+  ASSERT_TRUE(spectrum.transcodeBatch({}).empty());
+}
+
+TEST(Spectrum, transcodeBatch_whenJobsFail_thenErrorPerJob) {
+  const auto spectrum = Spectrum();
+  auto emptySource = io::testutils::makeVectorImageSource("");
+  auto emptySink = io::CharVectorEncodedImageSink{};
+  auto source = io::testutils::makeVectorImageSource("abc");
+  auto sink = io::CharVectorEncodedImageSink{};
+
+  const auto results = spectrum.transcodeBatch({
+      {emptySource, emptySink, testutils::makeDummyTranscodeOptions()},
+      {source, sink, testutils::makeDummyTranscodeOptions()},
+  });
+
+  ASSERT_EQ(2, results.size());
+  for (const auto& result : results) {
+    ASSERT_FALSE(result.result.hasValue());
+    ASSERT_NE(nullptr, result.error);
+  }
+  ASSERT_SPECTRUM_THROW(
+      std::rethrow_exception(results[0].error),
+      spectrum::error::EmptyInputSource);
+}
+
+namespace {
+/**
+ * Downscales a 128x128 image in a batch of jobs that scale with several
+ * threads and returns the output of each job.
+ */
+std::vector<std::string> transformBatchWithScalingThreads(
+    core::WorkStealingExecutor& executor,
+    const std::shared_ptr<core::IExecutor>& scalingExecutor) {
+  const auto spectrum = Spectrum();
+  auto imageSpecification = image::testutils::makeDummyImageSpecification(
+      image::formats::Bitmap, image::pixel::specifications::RGB);
+  imageSpecification.size = image::Size{128, 128};
+  std::string content(128 * 128 * 3, '\0');
+  for (std::size_t i = 0; i < content.size(); ++i) {
+    content[i] = static_cast<char>(i * 7 % 251);
+  }
+
+  auto transformations = Transformations{};
+  transformations.resizeRequirement = requirements::Resize{
+      .mode = requirements::Resize::Mode::ExactOrSmaller,
+      .targetSize = image::Size{64, 64}};
+  auto configuration = Configuration{};
+  configuration.general.numberOfScalingThreads(4);
+  configuration.general.scalingExecutor(scalingExecutor);
+
+  std::vector<io::CharVectorBitmapImageSource> sources;
+  std::vector<io::testutils::FakeImageSink> sinks(4);
+  std::vector<TransformJob> jobs;
+  sources.reserve(sinks.size());
+  for (std::size_t i = 0; i < sinks.size(); ++i) {
+    sources.push_back(io::testutils::makeVectorBitmapImageSource(
+        content, imageSpecification));
+    jobs.push_back({sources[i],
+                    sinks[i],
+                    TransformOptions(transformations, configuration)});
+  }
+
+  const auto results = spectrum.transformBatch(jobs, &executor);
+
+  std::vector<std::string> outputs;
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(nullptr, results[i].error);
+    outputs.push_back(sinks[i].stringContent());
+  }
+  return outputs;
+}
+} // namespace
+
+TEST(
+    Spectrum,
+    transformBatch_whenScalingWithThreads_thenScaledOnSingleThreadedBatch) {
+  core::WorkStealingExecutor executor(1);
+  const auto outputs = transformBatchWithScalingThreads(executor, nullptr);
+
+  ASSERT_EQ(4, outputs.size());
+  ASSERT_EQ(64 * 64 * 3, outputs.front().size());
+  for (const auto& output : outputs) {
+    ASSERT_EQ(outputs.front(), output);
+  }
+}
+
+TEST(
+    Spectrum,
+    transformBatch_whenBatchExecutorIsScalingExecutor_thenNoDeadlock) {
+  auto executor = std::make_shared<core::WorkStealingExecutor>(2);
+  const auto sharedOutputs =
+      transformBatchWithScalingThreads(*executor, executor);
+
+  core::WorkStealingExecutor otherExecutor(1);
+  ASSERT_EQ(
+      transformBatchWithScalingThreads(otherExecutor, nullptr), sharedOutputs);
+}
+
+TEST(Spectrum, transformBatch_whenJobsSucceed_thenResultPerJob) {
+  const auto spectrum = Spectrum();
+  const auto imageSpecification =
+      image::testutils::makeDummyImageSpecification();
+  std::vector<io::CharVectorBitmapImageSource> sources;
+  std::vector<io::testutils::FakeImageSink> sinks(8);
+  std::vector<TransformJob> jobs;
+  sources.reserve(sinks.size());
+  for (std::size_t i = 0; i < sinks.size(); ++i) {
+    sources.push_back(
+        io::testutils::makeVectorBitmapImageSource("abc", imageSpecification));
+    jobs.push_back({sources[i], sinks[i], TransformOptions()});
+  }
+
+  core::WorkStealingExecutor executor(3);
+  const auto results = spectrum.transformBatch(jobs, &executor);
+
+  ASSERT_EQ(sinks.size(), results.size());
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    ASSERT_EQ(nullptr, results[i].error);
+    ASSERT_TRUE(results[i].result.hasValue());
+    ASSERT_EQ(3, results[i].result->totalBytesWritten);
+    ASSERT_EQ("abc", sinks[i].stringContent());
+  }
+}
+
 } // namespace test
 } // namespace spectrum
 } // namespace facebook
@@ -0,0 +1,106 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <spectrum/codecs/ProbedDecompressor.h>
+
+#include <spectrum/io/RewindableImageSource.h>
+#include <spectrum/testutils/TestUtils.h>
+
+#include <array>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace facebook {
+namespace spectrum {
+namespace codecs {
+namespace test {
+
+namespace {
+
+static constexpr auto ALPHABET = "abcdefghijklmnopqrstuvwxzy";
+
+/**
+ * Marks the source and reads the first bytes like a decompressor would when
+ * parsing the headers.
+ */
+ProbedDecompressor makeProbedDecompressorAfterReadingHeader(
+    io::RewindableImageSource& source) {
+  source.mark();
+  std::array<char, 3> header;
+  source.read(header.data(), header.size());
+
+  return ProbedDecompressor{
+      std::make_unique<testutils::FakeDecompressor>(
+          image::Size{4, 2}, image::pixel::specifications::RGB),
+      source};
+}
+
+} // namespace
+
+TEST(codecs_ProbedDecompressor, whenConstructed_thenImageSpecificationDetected) {
+  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto source = io::RewindableImageSource{fakeSource};
+  auto probedDecompressor = makeProbedDecompressorAfterReadingHeader(source);
+
+  ASSERT_EQ(
+      (image::Size{4, 2}), probedDecompressor.imageSpecification().size);
+  ASSERT_EQ(
+      image::pixel::specifications::RGB,
+      probedDecompressor.imageSpecification().pixelSpecification);
+}
+
+TEST(codecs_ProbedDecompressor, whenTakenWithoutSampling_thenSourceNotRewound) {
+  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto source = io::RewindableImageSource{fakeSource};
+  auto probedDecompressor = makeProbedDecompressorAfterReadingHeader(source);
+
+  ASSERT_NE(nullptr, probedDecompressor.take(folly::none));
+  ASSERT_EQ(nullptr, probedDecompressor.take(folly::none));
+
+  io::testutils::assertRead("defghijklmnopqrstuvw", 20, source);
+
+  // the source is no longer marked
+  ASSERT_THROW(source.reset(), SpectrumException);
+}
+
+TEST(codecs_ProbedDecompressor, whenTakenWithSampling_thenSourceRewound) {
+  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto source = io::RewindableImageSource{fakeSource};
+  auto probedDecompressor = makeProbedDecompressorAfterReadingHeader(source);
+
+  ASSERT_EQ(nullptr, probedDecompressor.take(image::Ratio{1, 2}));
+
+  io::testutils::assertRead("abcdefghijklmnopqrst", 20, source);
+}
+
+TEST(codecs_ProbedDecompressor, whenDiscarded_thenSourceRewoundOnce) {
+  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto source = io::RewindableImageSource{fakeSource};
+  auto probedDecompressor = makeProbedDecompressorAfterReadingHeader(source);
+
+  probedDecompressor.discard();
+  io::testutils::assertRead("abcde", 5, source);
+
+  probedDecompressor.discard();
+  io::testutils::assertRead("fghij", 5, source);
+  ASSERT_EQ(nullptr, probedDecompressor.take(folly::none));
+}
+
+TEST(codecs_ProbedDecompressor, whenDiscardedAfterTaken_thenSourceNotRewound) {
+  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto source = io::RewindableImageSource{fakeSource};
+  auto probedDecompressor = makeProbedDecompressorAfterReadingHeader(source);
+
+  ASSERT_NE(nullptr, probedDecompressor.take(folly::none));
+  probedDecompressor.discard();
+
+  io::testutils::assertRead("defgh", 5, source);
+}
+
+} // namespace test
+} // namespace codecs
+} // namespace spectrum
+} // namespace facebook
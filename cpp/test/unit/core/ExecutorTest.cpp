@@ -0,0 +1,109 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <spectrum/core/Executor.h>
+#include <spectrum/core/SpectrumEnforce.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace test {
+
+TEST(core_ThreadPoolExecutor, whenNoThreads_thenThrow) {
+  ASSERT_THROW(ThreadPoolExecutor(0), SpectrumException);
+}
+
+TEST(core_ThreadPoolExecutor, whenExecutingTask_thenRunOnOtherThread) {
+  ThreadPoolExecutor executor(2);
+  ASSERT_EQ(2, executor.numberOfThreads());
+
+  std::promise<std::thread::id> promise;
+  executor.execute([&promise] { promise.set_value(std::this_thread::get_id()); });
+
+  ASSERT_NE(std::this_thread::get_id(), promise.get_future().get());
+}
+
+TEST(core_ThreadPoolExecutor, whenDestroyed_thenPendingTasksAreRun) {
+  std::atomic<int> counter{0};
+  {
+    ThreadPoolExecutor executor(3);
+    for (int i = 0; i < 100; ++i) {
+      executor.execute([&counter] { ++counter; });
+    }
+  }
+  ASSERT_EQ(100, counter.load());
+}
+
+TEST(core_ThreadPoolExecutor, whenExecutingNullTask_thenThrow) {
+  ThreadPoolExecutor executor(1);
+  ASSERT_THROW(executor.execute(nullptr), SpectrumException);
+}
+
+TEST(core_WorkStealingExecutor, whenNoThreads_thenThrow) {
+  ASSERT_THROW(WorkStealingExecutor(0), SpectrumException);
+}
+
+TEST(core_WorkStealingExecutor, whenExecutingTask_thenRunOnOtherThread) {
+  WorkStealingExecutor executor(2);
+  ASSERT_EQ(2, executor.numberOfThreads());
+
+  std::promise<std::thread::id> promise;
+  executor.execute([&promise] { promise.set_value(std::this_thread::get_id()); });
+
+  ASSERT_NE(std::this_thread::get_id(), promise.get_future().get());
+}
+
+TEST(core_WorkStealingExecutor, whenDestroyed_thenPendingTasksAreRun) {
+  std::atomic<int> counter{0};
+  {
+    WorkStealingExecutor executor(3);
+    for (int i = 0; i < 100; ++i) {
+      executor.execute([&counter] { ++counter; });
+    }
+  }
+  ASSERT_EQ(100, counter.load());
+}
+
+TEST(
+    core_WorkStealingExecutor,
+    whenTasksScheduledFromWorker_thenStolenByOtherThreads) {
+  std::mutex mutex;
+  std::set<std::thread::id> threadIds;
+  std::atomic<int> counter{0};
+  {
+    WorkStealingExecutor executor(4);
+    executor.execute([&] {
+      for (int i = 0; i < 100; ++i) {
+        executor.execute([&] {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          std::lock_guard<std::mutex> lock(mutex);
+          threadIds.insert(std::this_thread::get_id());
+          ++counter;
+        });
+      }
+    });
+  }
+  ASSERT_EQ(100, counter.load());
+  ASSERT_LT(1, threadIds.size());
+}
+
+TEST(core_WorkStealingExecutor, whenExecutingNullTask_thenThrow) {
+  WorkStealingExecutor executor(1);
+  ASSERT_THROW(executor.execute(nullptr), SpectrumException);
+}
+
+} // namespace test
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
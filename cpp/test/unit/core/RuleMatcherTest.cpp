@@ -6,6 +6,8 @@
 #include <spectrum/core/RuleMatcher.h>
 #include <spectrum/testutils/TestUtils.h>
 
+#include <memory>
+
 #include <folly/FixedString.h>
 #include <gtest/gtest.h>
 
@@ -41,11 +43,13 @@ TEST(core_RuleMatcher, whenRuleOnlyMatchesPastSecond_thenSecondReturned) {
   auto functorCallCount = int{0};
   const auto functor =
       makeCharacteristicMatcher(functorCallCount, matchers::Result::ok(), 1);
-  const auto parameters = testutils::makeDummyOperationParameters();
+  auto source = io::testutils::makeVectorImageSource("");
+  auto sink = io::testutils::FakeImageSink{};
+  const auto operation = testutils::makeOperationFromIO(source, sink);
   const auto ruleMatcher = RuleMatcher(
       {{.name = "rule1"}, {.name = "rule2"}, {.name = "rule3"}}, {functor});
 
-  ASSERT_EQ("rule2", ruleMatcher.findFirstMatching(parameters).name);
+  ASSERT_EQ("rule2", ruleMatcher.findFirstMatching(operation).name);
   ASSERT_EQ(2, functorCallCount);
 }
 
@@ -53,16 +57,64 @@ TEST(core_RuleMatcher, whenNoRulesMatches_thenThrows) {
   auto functorCallCount = int{0};
   const auto functor =
       makeCharacteristicMatcher(functorCallCount, makeValidFailureResult());
-  const auto parameters = testutils::makeDummyOperationParameters();
+  auto source = io::testutils::makeVectorImageSource("");
+  auto sink = io::testutils::FakeImageSink{};
+  const auto operation = testutils::makeOperationFromIO(source, sink);
   const auto ruleMatcher =
       RuleMatcher({{.name = "rule1"}, {.name = "rule2"}}, {functor});
 
   ASSERT_SPECTRUM_THROW(
-      ruleMatcher.findFirstMatching(parameters),
+      ruleMatcher.findFirstMatching(operation),
       spectrum::core::error::NoMatchingRule);
   ASSERT_EQ(2, functorCallCount);
 }
 
+TEST(core_RuleMatcher, whenOperationPredicateFalse_thenRuleSkipped) {
+  auto functorCallCount = int{0};
+  const auto functor =
+      makeCharacteristicMatcher(functorCallCount, matchers::Result::ok());
+  auto source = io::testutils::makeVectorImageSource("");
+  auto sink = io::testutils::FakeImageSink{};
+  const auto operation = testutils::makeOperationFromIO(source, sink);
+  const auto ruleMatcher = RuleMatcher(
+      {{.name = "rule1",
+        .operationPredicate = [](const Operation&) { return false; }},
+       {.name = "rule2",
+        .operationPredicate = [](const Operation&) { return true; }}},
+      {functor});
+
+  ASSERT_EQ("rule2", ruleMatcher.findFirstMatching(operation).name);
+  ASSERT_EQ(2, functorCallCount);
+}
+
+TEST(core_RuleMatcher, whenPredicateSetsRuleState_thenOnlyKeptIfMatching) {
+  auto source = io::testutils::makeVectorImageSource("");
+  auto sink = io::testutils::FakeImageSink{};
+  const auto operation = testutils::makeOperationFromIO(source, sink);
+  const auto setRuleState = [](const int value, const bool matches) {
+    return [value, matches](const Operation& operation) {
+      operation.ruleState = std::make_shared<const int>(value);
+      return matches;
+    };
+  };
+  const auto ruleMatcher = RuleMatcher(
+      {{.name = "rule1", .operationPredicate = setRuleState(1, false)},
+       {.name = "rule2"},
+       {.name = "rule3", .operationPredicate = setRuleState(3, true)}},
+      {});
+
+  ASSERT_EQ("rule2", ruleMatcher.findFirstMatching(operation).name);
+  ASSERT_EQ(nullptr, operation.ruleState);
+
+  const auto lastRuleMatcher = RuleMatcher(
+      {{.name = "rule1", .operationPredicate = setRuleState(1, false)},
+       {.name = "rule3", .operationPredicate = setRuleState(3, true)}},
+      {});
+
+  ASSERT_EQ("rule3", lastRuleMatcher.findFirstMatching(operation).name);
+  ASSERT_EQ(3, *std::static_pointer_cast<const int>(operation.ruleState));
+}
+
 } // namespace test
 } // namespace core
 } // namespace spectrum
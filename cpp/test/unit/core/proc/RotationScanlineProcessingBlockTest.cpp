@@ -7,7 +7,9 @@
 #include <spectrum/testutils/TestUtils.h>
 
 #include <array>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -17,6 +19,93 @@ namespace core {
 namespace proc {
 namespace test {
 
+namespace {
+/**
+ * Rotates a generated image both through the block and pixel by pixel and
+ * compares the results.
+ */
+void assertRotationEqualsReference(
+    const image::pixel::Specification& pixelSpecification,
+    const image::Size& inputSize) {
+  const std::size_t bytesPerPixel = pixelSpecification.bytesPerPixel;
+  const auto pixelAt = [&](const std::uint32_t x,
+                           const std::uint32_t y,
+                           const std::size_t component) {
+    return static_cast<std::uint8_t>(
+        (x * 7 + y * 131 + component * 59 + (x * y) / 3) % 251);
+  };
+
+  for (const auto orientation :
+       {image::Orientation::UpMirrored,
+        image::Orientation::Bottom,
+        image::Orientation::BottomMirrored,
+        image::Orientation::Left,
+        image::Orientation::LeftMirrored,
+        image::Orientation::Right,
+        image::Orientation::RightMirrored}) {
+    RotationScanlineProcessingBlock block(
+        pixelSpecification, inputSize, orientation);
+
+    for (std::uint32_t y = 0; y < inputSize.height; ++y) {
+      auto scanline = std::make_unique<image::Scanline>(
+          pixelSpecification, inputSize.width);
+      for (std::uint32_t x = 0; x < inputSize.width; ++x) {
+        for (std::size_t c = 0; c < bytesPerPixel; ++c) {
+          scanline->data()[x * bytesPerPixel + c] = pixelAt(x, y, c);
+        }
+      }
+      block.consume(std::move(scanline));
+    }
+
+    const auto outputSize = inputSize.oriented(orientation);
+    const auto w = inputSize.width;
+    const auto h = inputSize.height;
+    for (std::uint32_t y = 0; y < outputSize.height; ++y) {
+      const auto scanline = block.produce();
+      ASSERT_NE(nullptr, scanline);
+      ASSERT_EQ(outputSize.width, scanline->width());
+
+      for (std::uint32_t x = 0; x < outputSize.width; ++x) {
+        std::uint32_t inputX = 0;
+        std::uint32_t inputY = 0;
+        switch (orientation) {
+          case image::Orientation::UpMirrored:
+            inputX = w - x - 1, inputY = y;
+            break;
+          case image::Orientation::Bottom:
+            inputX = w - x - 1, inputY = h - y - 1;
+            break;
+          case image::Orientation::BottomMirrored:
+            inputX = x, inputY = h - y - 1;
+            break;
+          case image::Orientation::Left:
+            inputX = w - y - 1, inputY = x;
+            break;
+          case image::Orientation::LeftMirrored:
+            inputX = y, inputY = x;
+            break;
+          case image::Orientation::Right:
+            inputX = y, inputY = h - x - 1;
+            break;
+          case image::Orientation::RightMirrored:
+            inputX = w - y - 1, inputY = h - x - 1;
+            break;
+          default:
+            FAIL();
+        }
+
+        for (std::size_t c = 0; c < bytesPerPixel; ++c) {
+          ASSERT_EQ(
+              pixelAt(inputX, inputY, c),
+              scanline->data()[x * bytesPerPixel + c]);
+        }
+      }
+    }
+    ASSERT_EQ(nullptr, block.produce());
+  }
+}
+} // namespace
+
 TEST(RotationScanlineProcessingBlock, whenRotateUp_thenThrow) {
   ASSERT_ANY_THROW(RotationScanlineProcessingBlock block(
       image::pixel::specifications::Gray, {3, 2}, image::Orientation::Up));
@@ -191,6 +280,19 @@ TEST(
   ASSERT_EQ(nullptr, block.produce());
 }
 
+TEST(
+    RotationScanlineProcessingBlock,
+    whenRotatingLargerImages_thenEqualsPixelByPixelRotation) {
+  for (const auto& pixelSpecification :
+       {image::pixel::specifications::Gray,
+        image::pixel::specifications::RGB,
+        image::pixel::specifications::RGBA}) {
+    assertRotationEqualsReference(pixelSpecification, {64, 48});
+    assertRotationEqualsReference(pixelSpecification, {37, 23});
+    assertRotationEqualsReference(pixelSpecification, {1, 19});
+  }
+}
+
 } // namespace test
 } // namespace proc
 } // namespace core
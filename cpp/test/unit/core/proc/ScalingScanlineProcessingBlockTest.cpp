@@ -3,11 +3,15 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <spectrum/core/Executor.h>
 #include <spectrum/core/proc/ScalingScanlineProcessingBlock.h>
 #include <spectrum/testutils/TestUtils.h>
 
 #include <array>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -17,6 +21,74 @@ namespace core {
 namespace proc {
 namespace test {
 
+namespace {
+std::vector<std::uint8_t> scaleMagicKernel(
+    const image::pixel::Specification& pixelSpecification,
+    const image::Size& inputSize,
+    const image::Size& outputSize,
+    IExecutor* executor,
+    const std::uint32_t numberOfThreads) {
+  ScalingScanlineProcessingBlock block(
+      pixelSpecification,
+      inputSize,
+      outputSize,
+      Configuration::General::SamplingMethod::MagicKernel,
+      executor,
+      numberOfThreads);
+
+  std::vector<std::uint8_t> result;
+  const auto drainOutput = [&] {
+    while (auto scanline = block.produce()) {
+      EXPECT_EQ(outputSize.width, scanline->width());
+      result.insert(
+          result.end(),
+          scanline->data(),
+          scanline->data() + scanline->sizeBytes());
+    }
+  };
+
+  for (std::uint32_t y = 0; y < inputSize.height; ++y) {
+    auto scanline = std::make_unique<image::Scanline>(
+        pixelSpecification, inputSize.width);
+    for (std::size_t i = 0; i < scanline->sizeBytes(); ++i) {
+      scanline->data()[i] = static_cast<std::uint8_t>((i * 7 + y * 13) ^ y);
+    }
+    block.consume(std::move(scanline));
+    drainOutput();
+  }
+  drainOutput();
+
+  EXPECT_EQ(
+      outputSize.width * outputSize.height * pixelSpecification.bytesPerPixel,
+      result.size());
+  return result;
+}
+
+/**
+ * Executor that never runs the tasks it is given, as if its threads were all
+ * busy with other work.
+ */
+class StalledExecutor : public IExecutor {
+ public:
+  void execute(std::function<void()> task) override {
+    tasks.push_back(std::move(task));
+  }
+
+  std::vector<std::function<void()>> tasks;
+};
+
+void assertParallelEqualsSequential(
+    const image::pixel::Specification& pixelSpecification,
+    const image::Size& inputSize,
+    const image::Size& outputSize) {
+  ThreadPoolExecutor executor(3);
+  ASSERT_EQ(
+      scaleMagicKernel(pixelSpecification, inputSize, outputSize, nullptr, 1),
+      scaleMagicKernel(
+          pixelSpecification, inputSize, outputSize, &executor, 3));
+}
+} // namespace
+
 //
 // MagicKernel
 //
@@ -86,6 +158,32 @@ TEST(ScalingScanlineProcessingBlock, magic_whenReadingBeforeFinished_thenNull) {
   ASSERT_FALSE(block.produce());
 }
 
+TEST(
+    ScalingScanlineProcessingBlock,
+    magic_whenDownscaling_thenOutputProducedBeforeInputFinished) {
+  const image::Size inputSize = {2, 16};
+  const image::Size outputSize = {2, 4};
+  ScalingScanlineProcessingBlock block(
+      image::pixel::specifications::Gray,
+      inputSize,
+      outputSize,
+      Configuration::General::SamplingMethod::MagicKernel);
+
+  std::size_t numConsumed = 0;
+  while (numConsumed < inputSize.height) {
+    block.consume(image::testutils::makeScanlineGray({{100}, {100}}));
+    numConsumed++;
+
+    if (auto scanline = block.produce()) {
+      ASSERT_TRUE(
+          image::testutils::assertScanlineGray({{100}, {100}}, scanline.get()));
+      break;
+    }
+  }
+
+  ASSERT_LT(numConsumed, inputSize.height);
+}
+
 TEST(
     ScalingScanlineProcessingBlock,
     magic_whenDownscaleUniformImage_thenEqual) {
@@ -144,6 +242,52 @@ TEST(
   ASSERT_FALSE(block.produce());
 }
 
+TEST(
+    ScalingScanlineProcessingBlock,
+    magic_whenDownscalingWithThreads_thenEqualsSequential) {
+  assertParallelEqualsSequential(
+      image::pixel::specifications::Gray, {97, 211}, {41, 83});
+  assertParallelEqualsSequential(
+      image::pixel::specifications::RGB, {97, 211}, {41, 83});
+  assertParallelEqualsSequential(
+      image::pixel::specifications::RGBA, {97, 211}, {41, 83});
+}
+
+TEST(
+    ScalingScanlineProcessingBlock,
+    magic_whenUpscalingWithThreads_thenEqualsSequential) {
+  assertParallelEqualsSequential(
+      image::pixel::specifications::RGB, {23, 37}, {61, 101});
+}
+
+TEST(
+    ScalingScanlineProcessingBlock,
+    magic_whenTooSmallForStripesWithThreads_thenEqualsSequential) {
+  assertParallelEqualsSequential(
+      image::pixel::specifications::RGB, {40, 40}, {20, 2});
+  assertParallelEqualsSequential(
+      image::pixel::specifications::RGB, {40, 40}, {20, 10});
+}
+
+TEST(
+    ScalingScanlineProcessingBlock,
+    magic_whenExecutorNeverRunsStripes_thenScaledByWaitingThread) {
+  const auto pixelSpecification = image::pixel::specifications::RGB;
+  StalledExecutor executor;
+  const auto result = scaleMagicKernel(
+      pixelSpecification, {97, 211}, {41, 83}, &executor, 3);
+
+  ASSERT_FALSE(executor.tasks.empty());
+  ASSERT_EQ(
+      scaleMagicKernel(pixelSpecification, {97, 211}, {41, 83}, nullptr, 1),
+      result);
+
+  // the stripes have already been scaled
+  for (auto& task : executor.tasks) {
+    task();
+  }
+}
+
 //
 // Bicubic
 //
@@ -254,6 +398,31 @@ TEST(ScalingScanlineProcessingBlock, bicubic_whenDownscaleAllWhite_thenEqual) {
       {{255}, {255}}, block.produce().get()));
 }
 
+TEST(ScalingScanlineProcessingBlock, bicubic_whenDownscaleGradient_thenEqual) {
+  const image::Size inputSize = {4, 4};
+  const image::Size outputSize = {2, 2};
+  ScalingScanlineProcessingBlock block(
+      image::pixel::specifications::Gray,
+      inputSize,
+      outputSize,
+      Configuration::General::SamplingMethod::Bicubic);
+
+  block.consume(
+      image::testutils::makeScanlineGray({{0}, {80}, {160}, {240}}));
+  block.consume(
+      image::testutils::makeScanlineGray({{5}, {85}, {165}, {245}}));
+  block.consume(
+      image::testutils::makeScanlineGray({{10}, {90}, {170}, {250}}));
+  block.consume(
+      image::testutils::makeScanlineGray({{15}, {95}, {175}, {255}}));
+
+  ASSERT_TRUE(image::testutils::assertScanlineGray(
+      {{37}, {207}}, block.produce().get()));
+  ASSERT_TRUE(image::testutils::assertScanlineGray(
+      {{47}, {217}}, block.produce().get()));
+  ASSERT_EQ(nullptr, block.produce());
+}
+
 TEST(ScalingScanlineProcessingBlock, whenNoScale_thenEqualRbg) {
   const image::Size inputSize = {1, 3};
   const image::Size outputSize = {1, 3};
@@ -0,0 +1,101 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <spectrum/core/proc/ScanlineBatchQueue.h>
+
+#include <spectrum/image/Scanline.h>
+#include <spectrum/testutils/TestUtils.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+namespace test {
+
+namespace {
+ScanlineBatchQueue::Scanlines makeBatch(const std::uint8_t value) {
+  ScanlineBatchQueue::Scanlines batch;
+  batch.push_back(image::testutils::makeScanlineGray({{value}}));
+  return batch;
+}
+} // namespace
+
+TEST(
+    ScanlineBatchQueue,
+    whenPushedFromOtherThread_thenBatchesPoppedInOrderUntilClosed) {
+  ScanlineBatchQueue queue{2};
+
+  std::thread producer([&] {
+    for (std::uint8_t i = 0; i < 100; ++i) {
+      ASSERT_TRUE(queue.push(makeBatch(i)));
+    }
+    queue.close();
+  });
+
+  std::vector<std::uint8_t> values;
+  ScanlineBatchQueue::Scanlines batch;
+  while (queue.pop(batch)) {
+    ASSERT_EQ(1, batch.size());
+    values.push_back(*batch.front()->data());
+  }
+  producer.join();
+
+  ASSERT_EQ(100, values.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(i, values[i]);
+  }
+}
+
+TEST(ScanlineBatchQueue, whenClosed_thenPendingBatchesStillPopped) {
+  ScanlineBatchQueue queue{2};
+  ASSERT_TRUE(queue.push(makeBatch(1)));
+  ASSERT_TRUE(queue.push(makeBatch(2)));
+  queue.close();
+
+  ScanlineBatchQueue::Scanlines batch;
+  ASSERT_TRUE(queue.pop(batch));
+  ASSERT_EQ(1, *batch.front()->data());
+  ASSERT_TRUE(queue.pop(batch));
+  ASSERT_EQ(2, *batch.front()->data());
+  ASSERT_FALSE(queue.pop(batch));
+}
+
+TEST(ScanlineBatchQueue, whenCancelled_thenWaitingPushFails) {
+  ScanlineBatchQueue queue{1};
+  ASSERT_TRUE(queue.push(makeBatch(1)));
+
+  // the queue is full, so the push waits until it is cancelled
+  std::thread producer([&] { ASSERT_FALSE(queue.push(makeBatch(2))); });
+  queue.cancel();
+  producer.join();
+
+  ScanlineBatchQueue::Scanlines batch;
+  ASSERT_TRUE(queue.isCancelled());
+  ASSERT_FALSE(queue.pop(batch));
+}
+
+TEST(ScanlineBatchQueue, whenCancelled_thenWaitingPopFails) {
+  ScanlineBatchQueue queue{1};
+
+  std::thread consumer([&] {
+    ScanlineBatchQueue::Scanlines batch;
+    ASSERT_FALSE(queue.pop(batch));
+  });
+  queue.cancel();
+  consumer.join();
+}
+
+} // namespace test
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
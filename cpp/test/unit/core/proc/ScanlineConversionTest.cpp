@@ -6,8 +6,10 @@
 #include <spectrum/core/proc/ScanlineConversion.h>
 #include <spectrum/testutils/TestUtils.h>
 
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -343,6 +345,116 @@ TEST(
       image::Color{20, 40, 60});
 }
 
+//
+// Vectorized conversions
+//
+
+TEST(
+    core_proc_ScanlineConverter,
+    whenConvertingLongScanlines_thenEqualsDynamicConversion) {
+  const auto background = image::Color{255, 128, 7};
+  const std::vector<std::pair<image::pixel::Specification,
+                              image::pixel::Specification>>
+      specifications = {
+          {image::pixel::specifications::Gray,
+           image::pixel::specifications::RGB},
+          {image::pixel::specifications::Gray,
+           image::pixel::specifications::RGBA},
+          {image::pixel::specifications::Gray,
+           image::pixel::specifications::ARGB},
+          {image::pixel::specifications::RGB,
+           image::pixel::specifications::Gray},
+          {image::pixel::specifications::RGB,
+           image::pixel::specifications::RGBA},
+          {image::pixel::specifications::RGB,
+           image::pixel::specifications::ARGB},
+          {image::pixel::specifications::RGBA,
+           image::pixel::specifications::ARGB},
+          {image::pixel::specifications::ARGB,
+           image::pixel::specifications::RGBA},
+          {image::pixel::specifications::RGBA,
+           image::pixel::specifications::RGB},
+          {image::pixel::specifications::ARGB,
+           image::pixel::specifications::RGB},
+      };
+
+  for (const auto& specification : specifications) {
+    const auto& input = specification.first;
+    const auto& output = specification.second;
+
+    for (const std::size_t width : {1, 5, 6, 15, 16, 17, 31, 33, 67}) {
+      auto scanline = std::make_unique<image::Scanline>(input, width);
+      for (std::size_t i = 0; i < scanline->sizeBytes(); ++i) {
+        // covers transparent, opaque and partial alpha values
+        scanline->data()[i] = static_cast<std::uint8_t>((i * 97 + 13) % 256);
+      }
+      auto expectedScanline = std::make_unique<image::Scanline>(input, width);
+      std::copy_n(
+          scanline->data(), scanline->sizeBytes(), expectedScanline->data());
+
+      const auto actual =
+          makeScanlineConverter(input, output, background)
+              ->convertScanline(std::move(scanline));
+
+      std::unique_ptr<image::Scanline> expected;
+      if (output.colorModel == image::pixel::colormodels::Gray) {
+        expected = DynamicScanlineConverter<indices::RGB, indices::Gray>(
+                       input, output, background)
+                       .convertScanline(std::move(expectedScanline));
+      } else if (input.colorModel == image::pixel::colormodels::Gray) {
+        expected = DynamicScanlineConverter<indices::Gray, indices::RGB>(
+                       input, output, background)
+                       .convertScanline(std::move(expectedScanline));
+      } else {
+        expected = DynamicScanlineConverter<indices::RGB, indices::RGB>(
+                       input, output, background)
+                       .convertScanline(std::move(expectedScanline));
+      }
+
+      ASSERT_EQ(output, actual->specification());
+      ASSERT_EQ(expected->sizeBytes(), actual->sizeBytes());
+      ASSERT_TRUE(std::equal(
+          expected->data(),
+          expected->data() + expected->sizeBytes(),
+          actual->data()))
+          << input.string() << " -> " << output.string() << " @ " << width;
+    }
+  }
+}
+
+TEST(
+    core_proc_ScanlineConverter,
+    whenBytesPerPixelMatch_thenScanlineConvertedInPlace) {
+  for (const auto& output :
+       {image::pixel::specifications::ARGB,
+        image::pixel::specifications::BGRA}) {
+    auto scanline = std::make_unique<image::Scanline>(
+        image::pixel::specifications::RGBA, 5);
+    for (std::size_t i = 0; i < 5; ++i) {
+      std::copy_n(
+          std::array<std::uint8_t, 4>{{1, 2, 3, 4}}.data(),
+          4,
+          scanline->dataAtPixel(i));
+    }
+    const auto data = scanline->data();
+
+    const auto converted =
+        makeScanlineConverter(
+            image::pixel::specifications::RGBA, output, image::Color{0, 0, 0})
+            ->convertScanline(std::move(scanline));
+
+    ASSERT_EQ(data, converted->data());
+    ASSERT_EQ(output, converted->specification());
+    const auto expected = output == image::pixel::specifications::ARGB
+        ? std::array<std::uint8_t, 4>{{4, 1, 2, 3}}
+        : std::array<std::uint8_t, 4>{{3, 2, 1, 4}};
+    for (std::size_t i = 0; i < 5; ++i) {
+      ASSERT_TRUE(std::equal(
+          expected.begin(), expected.end(), converted->dataAtPixel(i)));
+    }
+  }
+}
+
 TEST(core_proc_indices_RGB, whenGeneratingRGBAIndices_thenCorrect) {
   assertRgbIndices(image::pixel::specifications::RGBA, 0, 1, 2, 3);
 }
@@ -0,0 +1,118 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <spectrum/core/proc/ScanlineFanOut.h>
+
+#include <spectrum/core/proc/RotationScanlineProcessingBlock.h>
+#include <spectrum/image/Scanline.h>
+#include <spectrum/testutils/TestUtils.h>
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+namespace test {
+
+namespace {
+ScanlinePump::ScanlineBatchConsumer makeCollector(
+    ScanlinePump::Scanlines& output,
+    std::vector<std::size_t>& batchSizes) {
+  return [&output, &batchSizes](ScanlinePump::Scanlines scanlines) {
+    batchSizes.push_back(scanlines.size());
+    for (auto& scanline : scanlines) {
+      output.push_back(std::move(scanline));
+    }
+  };
+}
+
+ScanlinePump::Scanlines makeInput() {
+  ScanlinePump::Scanlines scanlines;
+  scanlines.push_back(image::testutils::makeScanlineGray({{1}, {2}, {3}}));
+  scanlines.push_back(image::testutils::makeScanlineGray({{4}, {5}, {6}}));
+  return scanlines;
+}
+} // namespace
+
+TEST(ScanlineFanOut, whenNoBranches_thenThrow) {
+  ASSERT_ANY_THROW(ScanlineFanOut({}, 2));
+}
+
+TEST(ScanlineFanOut, whenTwoBranches_thenEachReceivesAllScanlines) {
+  ScanlinePump::Scanlines firstOutput;
+  ScanlinePump::Scanlines secondOutput;
+  std::vector<std::size_t> firstBatchSizes;
+  std::vector<std::size_t> secondBatchSizes;
+
+  std::vector<ScanlineFanOut::Branch> branches;
+  branches.push_back({{}, makeCollector(firstOutput, firstBatchSizes)});
+  branches.push_back({{}, makeCollector(secondOutput, secondBatchSizes)});
+  ScanlineFanOut fanOut(std::move(branches), 3);
+
+  auto input = makeInput();
+  const auto* const lastInput = input.back().get();
+  fanOut.consume(std::move(input));
+  fanOut.consume(makeInput());
+  fanOut.finish();
+
+  ASSERT_EQ((std::vector<std::size_t>{3, 1}), firstBatchSizes);
+  ASSERT_EQ((std::vector<std::size_t>{3, 1}), secondBatchSizes);
+  ASSERT_EQ(4, firstOutput.size());
+  ASSERT_EQ(4, secondOutput.size());
+  for (std::size_t i = 0; i < 4; i += 2) {
+    for (const auto* output : {&firstOutput, &secondOutput}) {
+      ASSERT_TRUE(image::testutils::assertScanlineGray(
+          {{1}, {2}, {3}}, (*output)[i].get()));
+      ASSERT_TRUE(image::testutils::assertScanlineGray(
+          {{4}, {5}, {6}}, (*output)[i + 1].get()));
+    }
+  }
+
+  // only the last branch is handed the original scanlines
+  ASSERT_NE(lastInput, firstOutput[1].get());
+  ASSERT_EQ(lastInput, secondOutput[1].get());
+}
+
+TEST(ScanlineFanOut, whenBranchesHaveBlocks_thenBlocksAppliedPerBranch) {
+  ScanlinePump::Scanlines rotatedOutput;
+  ScanlinePump::Scanlines unchangedOutput;
+  std::vector<std::size_t> batchSizes;
+
+  std::vector<ScanlineFanOut::Branch> branches(2);
+  branches[0].processingBlocks.push_back(
+      std::make_unique<RotationScanlineProcessingBlock>(
+          image::pixel::specifications::Gray,
+          image::Size{3, 2},
+          image::Orientation::Right));
+  branches[0].scanlineBatchConsumer = makeCollector(rotatedOutput, batchSizes);
+  branches[1].scanlineBatchConsumer =
+      makeCollector(unchangedOutput, batchSizes);
+  ScanlineFanOut fanOut(std::move(branches), 16);
+
+  fanOut.consume(makeInput());
+  fanOut.finish();
+
+  ASSERT_EQ(3, rotatedOutput.size());
+  ASSERT_TRUE(image::testutils::assertScanlineGray(
+      {{4}, {1}}, rotatedOutput[0].get()));
+  ASSERT_TRUE(image::testutils::assertScanlineGray(
+      {{5}, {2}}, rotatedOutput[1].get()));
+  ASSERT_TRUE(image::testutils::assertScanlineGray(
+      {{6}, {3}}, rotatedOutput[2].get()));
+
+  ASSERT_EQ(2, unchangedOutput.size());
+  ASSERT_TRUE(image::testutils::assertScanlineGray(
+      {{1}, {2}, {3}}, unchangedOutput[0].get()));
+}
+
+} // namespace test
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
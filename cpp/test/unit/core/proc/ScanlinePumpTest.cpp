@@ -10,7 +10,11 @@
 #include <spectrum/testutils/TestUtils.h>
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -125,6 +129,247 @@ TEST(ScanlinePump, whenFourRotationBlockOf90Degree_thenOutputRotated360Degree) {
       image::testutils::assertScanlineGray({{1}, {2}, {3}}, output[3].get()));
 }
 
+TEST(ScanlinePump, whenBatched_thenGeneratorAndConsumerCalledPerBatch) {
+  std::vector<std::size_t> requestedBatchSizes;
+  std::vector<std::size_t> consumedBatchSizes;
+  std::vector<std::unique_ptr<image::Scanline>> output;
+
+  ScanlinePump scanlinePump(
+      [&](const std::size_t numberOfScanlines) {
+        requestedBatchSizes.push_back(numberOfScanlines);
+        ScanlinePump::Scanlines scanlines;
+        for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+          scanlines.push_back(
+              image::testutils::makeScanlineGray({{1}, {2}, {3}}));
+        }
+        return scanlines;
+      },
+      {},
+      [&](ScanlinePump::Scanlines scanlines) {
+        consumedBatchSizes.push_back(scanlines.size());
+        for (auto& scanline : scanlines) {
+          output.push_back(std::move(scanline));
+        }
+      },
+      10,
+      4);
+
+  scanlinePump.pumpAll();
+
+  ASSERT_EQ((std::vector<std::size_t>{4, 4, 2}), requestedBatchSizes);
+  ASSERT_EQ((std::vector<std::size_t>{4, 4, 2}), consumedBatchSizes);
+  ASSERT_EQ(10, output.size());
+  for (const auto& scanline : output) {
+    ASSERT_TRUE(
+        image::testutils::assertScanlineGray({{1}, {2}, {3}}, scanline.get()));
+  }
+}
+
+TEST(ScanlinePump, whenBatchedWithRotation_thenOutputRotatedAndBatched) {
+  std::vector<std::size_t> consumedBatchSizes;
+  std::vector<std::unique_ptr<image::Scanline>> output;
+
+  std::vector<std::unique_ptr<ScanlineProcessingBlock>> processingBlocks;
+  processingBlocks.push_back(std::make_unique<RotationScanlineProcessingBlock>(
+      image::pixel::specifications::Gray,
+      image::Size{5, 4},
+      image::Orientation::Right));
+
+  ScanlinePump scanlinePump(
+      [](const std::size_t numberOfScanlines) {
+        ScanlinePump::Scanlines scanlines;
+        for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+          scanlines.push_back(image::testutils::makeScanlineGray(
+              {{1}, {2}, {3}, {4}, {5}}));
+        }
+        return scanlines;
+      },
+      std::move(processingBlocks),
+      [&](ScanlinePump::Scanlines scanlines) {
+        consumedBatchSizes.push_back(scanlines.size());
+        for (auto& scanline : scanlines) {
+          output.push_back(std::move(scanline));
+        }
+      },
+      4,
+      2);
+
+  scanlinePump.pumpAll();
+
+  // all 5 output rows appear after the last input row and are still batched
+  ASSERT_EQ((std::vector<std::size_t>{2, 2, 1}), consumedBatchSizes);
+  ASSERT_EQ(5, output.size());
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    const auto value = static_cast<std::uint8_t>(i + 1);
+    ASSERT_TRUE(image::testutils::assertScanlineGray(
+        {{value}, {value}, {value}, {value}}, output[i].get()));
+  }
+}
+
+namespace {
+ScanlinePump makeRotatingPump(
+    std::vector<std::size_t>& consumedBatchSizes,
+    ScanlinePump::Scanlines& output,
+    const std::size_t numInputScanlines,
+    const std::size_t batchSize) {
+  std::vector<std::unique_ptr<ScanlineProcessingBlock>> processingBlocks;
+  processingBlocks.push_back(std::make_unique<RotationScanlineProcessingBlock>(
+      image::pixel::specifications::Gray,
+      image::Size{3, static_cast<std::uint32_t>(numInputScanlines)},
+      image::Orientation::Bottom));
+
+  auto value = std::uint8_t{0};
+  return ScanlinePump(
+      [value](const std::size_t numberOfScanlines) mutable {
+        ScanlinePump::Scanlines scanlines;
+        for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+          ++value;
+          scanlines.push_back(
+              image::testutils::makeScanlineGray({{value}, {value}, {value}}));
+        }
+        return scanlines;
+      },
+      std::move(processingBlocks),
+      [&](ScanlinePump::Scanlines scanlines) {
+        consumedBatchSizes.push_back(scanlines.size());
+        for (auto& scanline : scanlines) {
+          output.push_back(std::move(scanline));
+        }
+      },
+      numInputScanlines,
+      batchSize);
+}
+} // namespace
+
+TEST(ScanlinePump, whenPipelined_thenOutputAndBatchesEqualLockstep) {
+  std::vector<std::size_t> consumedBatchSizes;
+  ScanlinePump::Scanlines output;
+  makeRotatingPump(consumedBatchSizes, output, 50, 4).pumpAll();
+
+  std::vector<std::size_t> pipelinedConsumedBatchSizes;
+  ScanlinePump::Scanlines pipelinedOutput;
+  makeRotatingPump(pipelinedConsumedBatchSizes, pipelinedOutput, 50, 4)
+      .pumpAllPipelined(1);
+
+  ASSERT_EQ(consumedBatchSizes, pipelinedConsumedBatchSizes);
+  ASSERT_EQ(50, output.size());
+  ASSERT_EQ(50, pipelinedOutput.size());
+  for (std::size_t i = 0; i < pipelinedOutput.size(); ++i) {
+    const auto value = static_cast<std::uint8_t>(50 - i);
+    ASSERT_TRUE(image::testutils::assertScanlineGray(
+        {{value}, {value}, {value}}, output[i].get()));
+    ASSERT_TRUE(image::testutils::assertScanlineGray(
+        {{value}, {value}, {value}}, pipelinedOutput[i].get()));
+  }
+}
+
+TEST(ScanlinePump, whenPipelinedWithoutBlocks_thenOutputEqualsInputInOrder) {
+  std::vector<std::uint8_t> output;
+  auto value = std::uint8_t{0};
+  ScanlinePump scanlinePump(
+      [&](const std::size_t numberOfScanlines) {
+        ScanlinePump::Scanlines scanlines;
+        for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+          scanlines.push_back(image::testutils::makeScanlineGray({{++value}}));
+        }
+        return scanlines;
+      },
+      {},
+      [&](ScanlinePump::Scanlines scanlines) {
+        for (const auto& scanline : scanlines) {
+          output.push_back(*scanline->data());
+        }
+      },
+      200,
+      3);
+
+  scanlinePump.pumpAllPipelined(2);
+
+  ASSERT_EQ(200, output.size());
+  for (std::size_t i = 0; i < output.size(); ++i) {
+    ASSERT_EQ(static_cast<std::uint8_t>(i + 1), output[i]);
+  }
+}
+
+TEST(ScanlinePump, whenPipelinedGeneratorThrows_thenRethrown) {
+  std::size_t numberOfConsumedScanlines = 0;
+  std::size_t numberOfCalls = 0;
+  ScanlinePump scanlinePump(
+      [&](const std::size_t numberOfScanlines) {
+        if (++numberOfCalls == 3) {
+          throw std::runtime_error("generator");
+        }
+        ScanlinePump::Scanlines scanlines;
+        for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+          scanlines.push_back(image::testutils::makeScanlineGray({{1}}));
+        }
+        return scanlines;
+      },
+      {},
+      [&](ScanlinePump::Scanlines scanlines) {
+        numberOfConsumedScanlines += scanlines.size();
+      },
+      100,
+      4);
+
+  ASSERT_THROW(scanlinePump.pumpAllPipelined(), std::runtime_error);
+  ASSERT_LE(numberOfConsumedScanlines, 8);
+}
+
+TEST(ScanlinePump, whenPipelinedConsumerThrows_thenRethrownAndStagesStopped) {
+  std::size_t numberOfGeneratedScanlines = 0;
+  ScanlinePump scanlinePump(
+      [&](const std::size_t numberOfScanlines) {
+        ScanlinePump::Scanlines scanlines;
+        for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+          scanlines.push_back(image::testutils::makeScanlineGray({{1}}));
+        }
+        numberOfGeneratedScanlines += numberOfScanlines;
+        return scanlines;
+      },
+      {},
+      [](ScanlinePump::Scanlines /* unused */) {
+        throw std::runtime_error("consumer");
+      },
+      1000,
+      1);
+
+  ASSERT_THROW(scanlinePump.pumpAllPipelined(1), std::runtime_error);
+
+  // the generator stops once the queues are full
+  ASSERT_LT(numberOfGeneratedScanlines, 1000);
+}
+
+TEST(ScanlinePump, whenPipelinedStagesThrow_thenFirstErrorRethrown) {
+  std::atomic<bool> hasConsumerFailed{false};
+  std::size_t numberOfCalls = 0;
+  ScanlinePump scanlinePump(
+      [&](const std::size_t numberOfScanlines) {
+        if (++numberOfCalls == 2) {
+          // fail after the consumer, whose error has been recorded by then
+          while (!hasConsumerFailed) {
+            std::this_thread::yield();
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+          throw std::logic_error("generator");
+        }
+        ScanlinePump::Scanlines scanlines;
+        for (std::size_t i = 0; i < numberOfScanlines; ++i) {
+          scanlines.push_back(image::testutils::makeScanlineGray({{1}}));
+        }
+        return scanlines;
+      },
+      {},
+      [&](ScanlinePump::Scanlines /* unused */) {
+        hasConsumerFailed = true;
+        throw std::runtime_error("consumer");
+      },
+      100,
+      4);
+
+  ASSERT_THROW(scanlinePump.pumpAllPipelined(), std::runtime_error);
+}
+
 } // namespace test
 } // namespace proc
 } // namespace core
@@ -0,0 +1,117 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <spectrum/core/proc/legacy/FixedPointQ11Kernels.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace facebook {
+namespace spectrum {
+namespace core {
+namespace proc {
+namespace legacy {
+namespace kernels {
+namespace test {
+
+namespace {
+const auto instructionSets = {
+    InstructionSet::Sse41,
+    InstructionSet::Avx2,
+    InstructionSet::Neon,
+};
+
+// Q21.11 pixels with some overshoot, products with the weights fit 32 bits
+std::vector<int32_t> makeRow(std::mt19937& random, const std::size_t n) {
+  std::uniform_int_distribution<int32_t> distribution(
+      -64 * (1 << 11), 320 * (1 << 11));
+  std::vector<int32_t> row(n);
+  for (auto& value : row) {
+    value = distribution(random);
+  }
+  return row;
+}
+} // namespace
+
+TEST(core_proc_legacy_kernels, whenScalar_thenSupported) {
+  ASSERT_TRUE(isSupported(InstructionSet::Scalar));
+}
+
+TEST(core_proc_legacy_kernels, whenAddingWeightedRow_thenEqualsScalar) {
+  std::mt19937 random(42);
+  const auto& scalar = kernelsFor(InstructionSet::Scalar);
+
+  for (const auto instructionSet : instructionSets) {
+    if (!isSupported(instructionSet)) {
+      continue;
+    }
+    const auto& vector = kernelsFor(instructionSet);
+
+    for (const std::size_t n : {0, 1, 3, 7, 8, 17, 33, 301}) {
+      for (const int32_t w : {-506, 3060, 1, 2048}) {
+        const auto src = makeRow(random, n);
+        auto expected = makeRow(random, n);
+        auto actual = expected;
+
+        scalar.addWeightedRowQ11(expected.data(), src.data(), w, n);
+        vector.addWeightedRowQ11(actual.data(), src.data(), w, n);
+        ASSERT_EQ(expected, actual);
+      }
+    }
+  }
+}
+
+TEST(core_proc_legacy_kernels, whenConvertingRow_thenEqualsScalar) {
+  std::mt19937 random(42);
+  const auto& scalar = kernelsFor(InstructionSet::Scalar);
+
+  for (const auto instructionSet : instructionSets) {
+    if (!isSupported(instructionSet)) {
+      continue;
+    }
+    const auto& vector = kernelsFor(instructionSet);
+
+    for (const std::size_t n : {0, 1, 7, 8, 15, 16, 17, 301}) {
+      auto src = makeRow(random, n);
+      if (n > 0) {
+        // rounding boundaries and extremes
+        src[0] = 1023;
+        src[n / 2] = 1024;
+        src[n - 1] = INT32_MAX;
+      }
+      if (n > 2) {
+        src[1] = INT32_MIN;
+        src[2] = -1025;
+      }
+      std::vector<std::uint8_t> expected(n);
+      std::vector<std::uint8_t> actual(n);
+
+      scalar.convertRowQ11ToUint8(src.data(), expected.data(), n);
+      vector.convertRowQ11ToUint8(src.data(), actual.data(), n);
+      ASSERT_EQ(expected, actual);
+    }
+  }
+}
+
+TEST(core_proc_legacy_kernels, whenConvertingRow_thenRoundedAndClamped) {
+  const std::vector<int32_t> src = {
+      -1, 0, 1023, 1024, 255 * 2048, 255 * 2048 + 1024, INT32_MAX, INT32_MIN};
+  std::vector<std::uint8_t> dst(src.size());
+
+  kernels().convertRowQ11ToUint8(src.data(), dst.data(), src.size());
+  ASSERT_EQ(
+      (std::vector<std::uint8_t>{0, 0, 0, 1, 255, 255, 255, 0}), dst);
+}
+
+} // namespace test
+} // namespace kernels
+} // namespace legacy
+} // namespace proc
+} // namespace core
+} // namespace spectrum
+} // namespace facebook
@@ -0,0 +1,91 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <spectrum/image/ScanlinePool.h>
+
+#include <gtest/gtest.h>
+
+namespace facebook {
+namespace spectrum {
+namespace image {
+namespace test {
+
+TEST(image_ScanlinePool, whenEmpty_thenAcquireAllocatesMatchingScanline) {
+  auto pool = ScanlinePool{};
+  const auto scanline = pool.acquire(pixel::specifications::RGB, 10);
+
+  ASSERT_EQ(pixel::specifications::RGB, scanline->specification());
+  ASSERT_EQ(10, scanline->width());
+  ASSERT_EQ(30, scanline->sizeBytes());
+  ASSERT_EQ(0, pool.size());
+}
+
+TEST(image_ScanlinePool, whenReleased_thenSameScanlineReused) {
+  auto pool = ScanlinePool{};
+  auto scanline = pool.acquire(pixel::specifications::RGB, 10);
+  const auto data = scanline->data();
+
+  pool.release(std::move(scanline));
+  ASSERT_EQ(1, pool.size());
+
+  const auto reusedScanline = pool.acquire(pixel::specifications::RGB, 10);
+  ASSERT_EQ(data, reusedScanline->data());
+  ASSERT_EQ(0, pool.size());
+}
+
+TEST(image_ScanlinePool, whenViewReleased_thenParentReused) {
+  auto pool = ScanlinePool{};
+  auto parent = pool.acquire(pixel::specifications::RGB, 10);
+  const auto data = parent->data();
+
+  pool.release(std::make_unique<Scanline>(std::move(parent), 2, 5));
+  ASSERT_EQ(1, pool.size());
+  ASSERT_EQ(data, pool.acquire(pixel::specifications::RGB, 10)->data());
+}
+
+TEST(image_ScanlinePool, whenViewWithoutParentReleased_thenNotRetained) {
+  auto pool = ScanlinePool{};
+  std::vector<std::uint8_t> bytes(30);
+  pool.release(std::make_unique<Scanline>(
+      pixel::specifications::RGB, bytes.data(), 10, nullptr));
+  ASSERT_EQ(0, pool.size());
+}
+
+TEST(image_ScanlinePool, whenWidthDiffers_thenNotReused) {
+  auto pool = ScanlinePool{};
+  pool.release(std::make_unique<Scanline>(pixel::specifications::RGB, 10));
+
+  const auto scanline = pool.acquire(pixel::specifications::RGB, 11);
+  ASSERT_EQ(11, scanline->width());
+  ASSERT_EQ(1, pool.size());
+}
+
+TEST(image_ScanlinePool, whenSpecificationDiffers_thenNotReused) {
+  auto pool = ScanlinePool{};
+  pool.release(std::make_unique<Scanline>(pixel::specifications::RGBA, 10));
+
+  const auto scanline = pool.acquire(pixel::specifications::ARGB, 10);
+  ASSERT_EQ(pixel::specifications::ARGB, scanline->specification());
+  ASSERT_EQ(1, pool.size());
+}
+
+TEST(image_ScanlinePool, whenFull_thenReleasedScanlinesFreed) {
+  auto pool = ScanlinePool{2};
+  pool.release(std::make_unique<Scanline>(pixel::specifications::Gray, 1));
+  pool.release(std::make_unique<Scanline>(pixel::specifications::Gray, 1));
+  pool.release(std::make_unique<Scanline>(pixel::specifications::Gray, 1));
+
+  ASSERT_EQ(2, pool.size());
+}
+
+TEST(image_ScanlinePool, makeScanline_whenNoPool_thenAllocates) {
+  const auto scanline = makeScanline(nullptr, pixel::specifications::Gray, 4);
+  ASSERT_EQ(4, scanline->width());
+}
+
+} // namespace test
+} // namespace image
+} // namespace spectrum
+} // namespace facebook
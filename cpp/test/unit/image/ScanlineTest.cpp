@@ -5,6 +5,10 @@
 
 #include <spectrum/image/Scanline.h>
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 using namespace facebook::spectrum::image;
@@ -52,6 +56,51 @@ TEST(image_Scanline, copyPixelFromTo_whenCopyingRgb_thenMatches) {
   ASSERT_TRUE(std::memcmp(output.data() + 3, pixelsData.data() + 6, 3) == 0);
 }
 
+TEST(image_Scanline, whenViewOfParent_thenSharesParentBytes) {
+  auto parent = std::make_unique<Scanline>(pixel::specifications::RGB, 4);
+  for (std::uint8_t offset = 0; offset < parent->sizeBytes(); offset++) {
+    *(parent->data() + offset) = offset;
+  }
+  const auto parentData = parent->data();
+
+  auto view = Scanline(std::move(parent), 1, 2);
+  ASSERT_TRUE(view.isView());
+  ASSERT_EQ(2, view.width());
+  ASSERT_EQ(6, view.sizeBytes());
+  ASSERT_EQ(pixel::specifications::RGB, view.specification());
+  ASSERT_EQ(parentData + 3, view.data());
+  ASSERT_EQ(parentData, view.takeParent()->data());
+}
+
+TEST(image_Scanline, whenViewOfParentOutOfBounds_thenThrows) {
+  ASSERT_ANY_THROW(Scanline(
+      std::make_unique<Scanline>(pixel::specifications::RGB, 4), 3, 2));
+}
+
+TEST(image_Scanline, whenViewOfOwnedMemory_thenOwnerKeptAlive) {
+  auto bytes = std::make_shared<std::vector<std::uint8_t>>(
+      std::vector<std::uint8_t>{0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+
+  auto view =
+      Scanline(pixel::specifications::RGB, bytes->data() + 3, 1, bytes);
+  const std::weak_ptr<std::vector<std::uint8_t>> weakBytes = bytes;
+  bytes = nullptr;
+
+  ASSERT_FALSE(weakBytes.expired());
+  ASSERT_EQ(0x04, *view.data());
+}
+
+TEST(image_Scanline, whenCopyingView_thenCopyOwnsBytes) {
+  std::vector<std::uint8_t> bytes{0x01, 0x02, 0x03};
+  const auto view =
+      Scanline(pixel::specifications::RGB, bytes.data(), 1, nullptr);
+
+  const auto copy = view;
+  ASSERT_FALSE(copy.isView());
+  ASSERT_NE(view.data(), copy.data());
+  ASSERT_TRUE(std::memcmp(view.data(), copy.data(), 3) == 0);
+}
+
 } // namespace test
 } // namespace image
 } // namespace spectrum
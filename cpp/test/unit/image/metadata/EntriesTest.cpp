@@ -307,6 +307,68 @@ TEST(
   ASSERT_EQ(4, newEntries.tiff().size());
 }
 
+namespace { /* anonymous */
+std::vector<std::uint8_t> makeTestLayoutWithThumbnail(
+    const std::vector<std::uint8_t>& thumbnail,
+    const std::uint32_t thumbnailLength) {
+  // empty 0th IFD that links the 1st IFD right after it
+  const std::uint32_t ifd1Offset = Entries::MemoryLayout::DEFAULT_OFFSET +
+      sizeof(std::uint16_t) + sizeof(std::uint32_t);
+  const std::uint32_t thumbnailOffset = ifd1Offset + sizeof(std::uint16_t) +
+      2 * sizeof(Entry::MemoryLayout) + sizeof(std::uint32_t);
+
+  auto data = makeTestLayout();
+  utils::insertValueIntoData(ifd1Offset, data);
+  utils::insertValueIntoData(std::uint16_t{2}, data);
+  Entry{Entry::JPEG_INTERCHANGE_FORMAT, Entry::LONG, thumbnailOffset}
+      .insertIntoData(data);
+  Entry{Entry::JPEG_INTERCHANGE_FORMAT_LENGTH, Entry::LONG, thumbnailLength}
+      .insertIntoData(data);
+  utils::insertValueIntoData(std::uint32_t{0}, data);
+  data.insert(data.end(), thumbnail.begin(), thumbnail.end());
+  return data;
+}
+} // namespace
+
+TEST(image_metadata_Entries, whenFirstIfdHasThumbnail_thenItIsFound) {
+  const auto thumbnail = std::vector<std::uint8_t>{0xFF, 0xD8, 0xFF, 0xD9};
+  const auto data = makeTestLayoutWithThumbnail(thumbnail, thumbnail.size());
+
+  const auto dataRange = Entries::findThumbnail(data.data(), data.size());
+
+  ASSERT_TRUE(dataRange.hasValue());
+  ASSERT_EQ(data.data() + data.size() - thumbnail.size(), dataRange->begin);
+  ASSERT_EQ(thumbnail.size(), dataRange->length);
+
+  // the thumbnail is not part of the entries
+  ASSERT_EQ(0, Entries(data.data(), data.size()).entriesSize());
+}
+
+TEST(image_metadata_Entries, whenThumbnailExceedsData_thenNone) {
+  const auto thumbnail = std::vector<std::uint8_t>{0xFF, 0xD8, 0xFF, 0xD9};
+  const auto data =
+      makeTestLayoutWithThumbnail(thumbnail, thumbnail.size() + 1);
+
+  ASSERT_FALSE(Entries::findThumbnail(data.data(), data.size()).hasValue());
+}
+
+TEST(image_metadata_Entries, whenNoFirstIfd_thenNoThumbnail) {
+  const auto entries = makeEntriesData({Entry{
+      Entry::Tag::MAKE,
+      Entry::Type::ASCII,
+      std::vector<std::uint8_t>{'A', '\0'}}});
+
+  ASSERT_FALSE(
+      Entries::findThumbnail(entries.second.data(), entries.second.size())
+          .hasValue());
+}
+
+TEST(image_metadata_Entries, whenNotExif_thenNoThumbnail) {
+  const auto data = makeTestLayout(Entries::MemoryLayout{"NotExif"});
+
+  ASSERT_FALSE(Entries::findThumbnail(data.data(), data.size()).hasValue());
+}
+
 namespace { /* anonymous */
 auto makeEntriesWithOrientation(const short orientationValue) {
   return makeEntries(
@@ -8,15 +8,42 @@
 #include <array>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
 #include <string>
 
 #include <gtest/gtest.h>
+#include <unistd.h>
 
 namespace facebook {
 namespace spectrum {
 namespace io {
 namespace test {
 
+namespace {
+/**
+ * Creates an empty temporary file that is removed on destruction.
+ */
+struct TemporaryFile {
+  std::string path{"/tmp/spectrum_file_image_sink_XXXXXX"};
+  int fileDescriptor;
+
+  TemporaryFile() : fileDescriptor(::mkstemp(&path[0])) {}
+
+  ~TemporaryFile() {
+    ::close(fileDescriptor);
+    std::remove(path.c_str());
+  }
+
+  std::string content() const {
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(
+        std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  }
+};
+} // namespace
+
 TEST(FileImageSink, whenOpeningDevNull_thenNothingThrows) {
   FileImageSink sink("/dev/null");
 }
@@ -41,6 +68,79 @@ TEST(FileImageSink, whenWritingToDevNull_thenWriteCountIncreases) {
   ASSERT_EQ(5, sink.totalBytesWritten());
 }
 
+TEST(FileImageSink, whenWritingSmallChunks_thenFileWrittenOnFlush) {
+  TemporaryFile file;
+  FileImageSink sink(file.path);
+
+  sink.write("abc", 3);
+  sink.write("def", 3);
+  ASSERT_EQ("", file.content());
+
+  sink.flush();
+  ASSERT_EQ("abcdef", file.content());
+}
+
+TEST(FileImageSink, whenDestroyed_thenPendingBytesWritten) {
+  TemporaryFile file;
+  {
+    FileImageSink sink(file.path);
+    sink.write("abc", 3);
+  }
+  ASSERT_EQ("abc", file.content());
+}
+
+TEST(FileImageSink, whenBufferFull_thenPendingAndNewBytesWritten) {
+  TemporaryFile file;
+  FileImageSink sink(file.path, FileImageSinkOptions{.bufferSize = 4});
+
+  sink.write("abc", 3);
+  ASSERT_EQ("", file.content());
+  sink.write("defgh", 5);
+  ASSERT_EQ("abcdefgh", file.content());
+  sink.write("i", 1);
+  ASSERT_EQ("abcdefgh", file.content());
+  ASSERT_EQ(9, sink.totalBytesWritten());
+}
+
+TEST(FileImageSink, whenBufferSizeZero_thenEveryWriteReachesFile) {
+  TemporaryFile file;
+  FileImageSink sink(file.path, FileImageSinkOptions{.bufferSize = 0});
+
+  sink.write("abc", 3);
+  ASSERT_EQ("abc", file.content());
+}
+
+TEST(FileImageSink, whenExpectedSizeGiven_thenFileSizeMatchesWrittenBytes) {
+  TemporaryFile file;
+  {
+    FileImageSink sink(
+        file.path, FileImageSinkOptions{.expectedSize = std::size_t{1024}});
+    sink.write("abc", 3);
+  }
+  ASSERT_EQ("abc", file.content());
+}
+
+TEST(FileImageSink, whenWritingToFileDescriptor_thenNotClosed) {
+  TemporaryFile file;
+  {
+    FileImageSink sink(file.fileDescriptor);
+    sink.write("abc", 3);
+  }
+  ASSERT_EQ(3, ::write(file.fileDescriptor, "def", 3));
+  ASSERT_EQ("abcdef", file.content());
+}
+
+TEST(FileImageSink, whenMoved_thenPendingBytesWrittenOnce) {
+  TemporaryFile file;
+  {
+    FileImageSink sink(file.path);
+    sink.write("abc", 3);
+    FileImageSink movedSink(std::move(sink));
+    movedSink.write("def", 3);
+  }
+  ASSERT_EQ("abcdef", file.content());
+}
+
 } // namespace test
 } // namespace io
 } // namespace spectrum
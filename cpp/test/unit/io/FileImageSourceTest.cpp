@@ -8,15 +8,41 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
 
 #include <gtest/gtest.h>
+#include <unistd.h>
 
 namespace facebook {
 namespace spectrum {
 namespace io {
 namespace test {
 
+namespace {
+/**
+ * Creates a temporary file with the given content that is removed on
+ * destruction.
+ */
+struct TemporaryFile {
+  std::string path{"/tmp/spectrum_file_image_source_XXXXXX"};
+  int fileDescriptor;
+
+  explicit TemporaryFile(const std::string& content)
+      : fileDescriptor(::mkstemp(&path[0])) {
+    EXPECT_EQ(
+        static_cast<ssize_t>(content.size()),
+        ::write(fileDescriptor, content.data(), content.size()));
+  }
+
+  ~TemporaryFile() {
+    ::close(fileDescriptor);
+    std::remove(path.c_str());
+  }
+};
+} // namespace
+
 TEST(FileImageSource, whenOpeningNonExistingFile_thenThrow) {
   ASSERT_THROW(
       FileImageSource{testdata::paths::NON_EXISTING_FILE.normalized()},
@@ -86,6 +112,46 @@ TEST(FileImageSource, whenAvailableAfterRead_thenMatchesRemainingBufferLength) {
   ASSERT_EQ(26 - 10, source.available());
 }
 
+TEST(FileImageSource, whenNotMemoryMapped_thenNoContiguousBytes) {
+  FileImageSource source(testdata::paths::misc::alphabetTxt.normalized());
+
+  ASSERT_FALSE(source.contiguousBytes().hasValue());
+  testutils::assertRead("abcdefghij", 10, source);
+}
+
+TEST(FileImageSource, whenContiguousBytes_thenMatchesRemainingBytes) {
+  FileImageSource source(
+      testdata::paths::misc::alphabetTxt.normalized(), true);
+
+  testutils::assertRead("abcdefghij", 10, source);
+  const auto bytes = source.contiguousBytes();
+  ASSERT_TRUE(bytes.hasValue());
+  ASSERT_EQ(
+      "klmnopqrstuvwxyz",
+      std::string(reinterpret_cast<const char*>(bytes->data()), bytes->size()));
+  ASSERT_EQ(10, source.getTotalBytesRead());
+}
+
+TEST(FileImageSource, whenFileTruncatedAfterOpening_thenReadStopsAtNewEnd) {
+  TemporaryFile file("abcdefghijklmnopqrstuvwxyz");
+  FileImageSource source(file.path);
+
+  ASSERT_EQ(0, ::ftruncate(file.fileDescriptor, 10));
+  testutils::assertRead("abcdefghij", 30, source);
+  testutils::assertRead("", 30, source);
+}
+
+TEST(FileImageSource, whenSkipping_thenReadHeadAdvanced) {
+  FileImageSource source(testdata::paths::misc::alphabetTxt.normalized());
+
+  ASSERT_EQ(10, source.skip(10));
+  testutils::assertRead("klm", 3, source);
+  ASSERT_EQ(13, source.available());
+  ASSERT_EQ(13, source.skip(20));
+  ASSERT_EQ(26, source.getTotalBytesRead());
+  testutils::assertRead("", 10, source);
+}
+
 } // namespace test
 } // namespace io
 } // namespace spectrum
@@ -4,6 +4,8 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <spectrum/io/RewindableImageSource.h>
+#include <spectrum/core/Constants.h>
+#include <spectrum/io/FileImageSource.h>
 #include <spectrum/testutils/TestUtils.h>
 
 #include <algorithm>
@@ -24,7 +26,7 @@ static constexpr auto ALPHABET = "abcdefghijklmnopqrstuvwxzy";
 //
 
 TEST(RewindableImageSource, whenJustReadFromSource_thenReadAsNormal) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
 
   testutils::assertRead("abcdefghijklmnopqrst", 20, imageSource);
@@ -34,7 +36,7 @@ TEST(RewindableImageSource, whenJustReadFromSource_thenReadAsNormal) {
 }
 
 TEST(RewindableImageSource, whenJustMarked_thenReadAsNormal) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
   imageSource.mark();
 
@@ -44,13 +46,13 @@ TEST(RewindableImageSource, whenJustMarked_thenReadAsNormal) {
 }
 
 TEST(RewindableImageSource, whenJustReset_thenThrow) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
   ASSERT_THROW(imageSource.reset(), SpectrumException);
 }
 
 TEST(RewindableImageSource, whenMarkedAndThenReset_thenReadAsNormal) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
   imageSource.mark();
   imageSource.reset();
@@ -63,7 +65,7 @@ TEST(RewindableImageSource, whenMarkedAndThenReset_thenReadAsNormal) {
 TEST(
     RewindableImageSource,
     whenMarkedAndThenResetAndThenMark_thenReadAsNormal) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
   imageSource.mark();
   imageSource.reset();
@@ -75,7 +77,7 @@ TEST(
 }
 
 TEST(RewindableImageSource, whenRewindableWithinRewindable_thenReadAsNormal) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
   auto outerSource =
       RewindableImageSource{static_cast<IImageSource&>(imageSource)};
@@ -92,7 +94,7 @@ TEST(RewindableImageSource, whenRewindableWithinRewindable_thenReadAsNormal) {
 TEST(
     RewindableImageSource,
     whenSequenceMarkReadResetRead_thenFirstPartReadTwice) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
 
   imageSource.mark();
@@ -110,7 +112,7 @@ TEST(
 TEST(
     RewindableImageSource,
     whenSequenceMarkReadResetMarkReadResetRead_thenFirstPartReadThreeTimes) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
 
   imageSource.mark();
@@ -134,7 +136,7 @@ TEST(
 TEST(
     RewindableImageSource,
     whenSequenceMarkReadResetReadMarkRead_thenFirstPartReadTwice) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
 
   imageSource.mark();
@@ -155,7 +157,7 @@ TEST(
 TEST(
     RewindableImageSource,
     whenSequenceMarkReadResetReadMarkResetRead_thenFirstPartTwiceAndSubpartThreeTimes) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
 
   imageSource.mark();
@@ -185,7 +187,7 @@ TEST(
 TEST(
     RewindableImageSource,
     whenSequenceReadAndReread_thenByteCounterReflectsUnderlyingStream) {
-  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
   auto imageSource = RewindableImageSource{fakeSource};
 
   imageSource.mark();
@@ -221,13 +223,13 @@ TEST(
 //
 
 TEST(RewindableImageSource, whenEmptySource_thenAvailable0) {
-  auto fakeSource = io::testutils::makeVectorImageSource("");
+  auto fakeSource = io::testutils::makeStreamingImageSource("");
   auto imageSource = RewindableImageSource{fakeSource};
   ASSERT_EQ(0, imageSource.available());
 }
 
 TEST(RewindableImageSource, whenSourceCompletelyRead_thenAvailable0) {
-  auto fakeSource = io::testutils::makeVectorImageSource("abc");
+  auto fakeSource = io::testutils::makeStreamingImageSource("abc");
   auto imageSource = RewindableImageSource{fakeSource};
 
   testutils::assertRead("abc", 3, imageSource);
@@ -235,7 +237,7 @@ TEST(RewindableImageSource, whenSourceCompletelyRead_thenAvailable0) {
 }
 
 TEST(RewindableImageSource, whenSourceHasByteLeft_thenAvailableFullMinusRead) {
-  auto fakeSource = io::testutils::makeVectorImageSource("abc");
+  auto fakeSource = io::testutils::makeStreamingImageSource("abc");
   auto imageSource = RewindableImageSource{fakeSource};
 
   testutils::assertRead("ab", 2, imageSource);
@@ -245,7 +247,7 @@ TEST(RewindableImageSource, whenSourceHasByteLeft_thenAvailableFullMinusRead) {
 TEST(
     RewindableImageSource,
     whenSourceCompletelyReadButThenResetted_thenAvailableFull) {
-  auto fakeSource = io::testutils::makeVectorImageSource("abc");
+  auto fakeSource = io::testutils::makeStreamingImageSource("abc");
   auto imageSource = RewindableImageSource{fakeSource};
 
   imageSource.mark();
@@ -254,6 +256,176 @@ TEST(
   ASSERT_EQ(3, imageSource.available());
 }
 
+TEST(RewindableImageSource, whenUnmarkedWithoutMark_thenThrow) {
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource};
+  ASSERT_THROW(imageSource.unmark(), SpectrumException);
+}
+
+TEST(RewindableImageSource, whenMarkedReadAndUnmarked_thenReadContinues) {
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource};
+  imageSource.mark();
+
+  testutils::assertRead("abcde", 5, imageSource);
+  imageSource.unmark();
+  testutils::assertRead("fghij", 5, imageSource);
+  ASSERT_THROW(imageSource.reset(), SpectrumException);
+}
+
+TEST(
+    RewindableImageSource,
+    whenUnmarkedWhileReadingFromBuffer_thenRemainingBufferStillRead) {
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource};
+  imageSource.mark();
+  testutils::assertRead("abcde", 5, imageSource);
+  imageSource.reset();
+
+  imageSource.mark();
+  testutils::assertRead("ab", 2, imageSource);
+  imageSource.unmark();
+
+  testutils::assertRead("cdefg", 5, imageSource);
+}
+
+TEST(RewindableImageSource, whenSkippingWhileMarked_thenSkippedBytesReadAgain) {
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource};
+
+  imageSource.mark();
+  ASSERT_EQ(5, imageSource.skip(5));
+  imageSource.reset();
+
+  testutils::assertRead("abcdefg", 7, imageSource);
+  ASSERT_EQ(19, imageSource.skip(30));
+  testutils::assertRead("", 10, imageSource);
+}
+
+TEST(RewindableImageSource, whenReadAfterResetAndThenMarked_thenResetToMark) {
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource};
+  imageSource.mark();
+  testutils::assertRead("abcde", 5, imageSource);
+  imageSource.reset();
+
+  testutils::assertRead("ab", 2, imageSource);
+  imageSource.mark();
+  testutils::assertRead("cdefg", 5, imageSource);
+  imageSource.reset();
+
+  testutils::assertRead("cdefghij", 8, imageSource);
+}
+
+TEST(RewindableImageSource, whenMarkedReadsSpanChunks_thenReadAgainAfterReset) {
+  std::string content;
+  for (std::size_t i = 0; i < 3 * core::DefaultBufferSize + 100; ++i) {
+    content.push_back(ALPHABET[i % 26]);
+  }
+  auto fakeSource = io::testutils::makeStreamingImageSource(content);
+  auto imageSource = RewindableImageSource{fakeSource};
+
+  testutils::assertRead(content.substr(0, 10), 10, imageSource);
+  imageSource.mark();
+  testutils::assertRead(
+      content.substr(10, core::DefaultBufferSize),
+      core::DefaultBufferSize,
+      imageSource);
+  ASSERT_EQ(core::DefaultBufferSize, imageSource.skip(core::DefaultBufferSize));
+  imageSource.reset();
+
+  imageSource.mark();
+  testutils::assertRead(
+      content.substr(10, 2 * core::DefaultBufferSize + 10),
+      2 * core::DefaultBufferSize + 10,
+      imageSource);
+  imageSource.reset();
+
+  testutils::assertRead(content.substr(10), content.size(), imageSource);
+  ASSERT_EQ(content.size(), imageSource.getTotalBytesRead());
+}
+
+TEST(RewindableImageSource, whenMarkedReadExceedsMaximumBufferSize_thenThrow) {
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource, 10};
+
+  imageSource.mark();
+  testutils::assertRead("abcdefghij", 10, imageSource);
+  char c;
+  ASSERT_THROW(imageSource.read(&c, 1), SpectrumException);
+}
+
+TEST(RewindableImageSource, whenUnmarked_thenMaximumBufferSizeNotApplied) {
+  auto fakeSource = io::testutils::makeStreamingImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource, 10};
+
+  testutils::assertRead("abcdefghijklmnopqrst", 20, imageSource);
+  imageSource.mark();
+  testutils::assertRead("uvw", 3, imageSource);
+  imageSource.reset();
+  testutils::assertRead("uvwxzy", 20, imageSource);
+}
+
+//
+// Image sources that hold their bytes in contiguous memory
+//
+
+TEST(
+    RewindableImageSource,
+    whenContiguousSequenceMarkReadResetReadMarkResetRead_thenReadAsBuffered) {
+  auto fakeSource = io::testutils::makeVectorImageSource(ALPHABET);
+  auto imageSource = RewindableImageSource{fakeSource, 0};
+
+  imageSource.mark();
+  testutils::assertRead("abcde", 5, imageSource);
+  imageSource.reset();
+  imageSource.mark();
+  testutils::assertRead("abc", 3, imageSource);
+  imageSource.mark();
+  testutils::assertRead("def", 3, imageSource);
+  ASSERT_EQ(6, imageSource.getTotalBytesRead());
+  imageSource.reset();
+
+  testutils::assertRead("defghijklmnopqrst", 17, imageSource);
+  testutils::assertRead("uvwxzy", 20, imageSource);
+  ASSERT_EQ(26, imageSource.getTotalBytesRead());
+}
+
+TEST(RewindableImageSource, whenContiguousSourceReset_thenReadAgain) {
+  FileImageSource fileSource(testdata::paths::misc::alphabetTxt.normalized());
+  auto imageSource = RewindableImageSource{fileSource};
+
+  imageSource.mark();
+  testutils::assertRead("abcde", 5, imageSource);
+  ASSERT_EQ(5, imageSource.skip(5));
+  imageSource.reset();
+
+  ASSERT_EQ(26, imageSource.available());
+  testutils::assertRead("abcdefgh", 8, imageSource);
+  ASSERT_EQ(10, imageSource.getTotalBytesRead());
+  testutils::assertRead("ijkl", 4, imageSource);
+  ASSERT_EQ(12, imageSource.getTotalBytesRead());
+}
+
+TEST(
+    RewindableImageSource,
+    whenContiguousSourceReset_thenContiguousBytesStartAtMark) {
+  FileImageSource fileSource(
+      testdata::paths::misc::alphabetTxt.normalized(), true);
+  auto imageSource = RewindableImageSource{fileSource};
+
+  testutils::assertRead("ab", 2, imageSource);
+  imageSource.mark();
+  ASSERT_EQ(24, imageSource.skip(30));
+  imageSource.reset();
+
+  const auto bytes = imageSource.contiguousBytes();
+  ASSERT_TRUE(bytes.hasValue());
+  ASSERT_EQ(
+      "cdefghijklmnopqrstuvwxyz",
+      std::string(reinterpret_cast<const char*>(bytes->data()), bytes->size()));
+}
+
 } // namespace test
 } // namespace io
 } // namespace spectrum
@@ -51,6 +51,35 @@ TEST(VectorImageSource, whenReadFromString_thenByteCountCorrect) {
   ASSERT_EQ(20, imageSource.getTotalBytesRead());
 }
 
+TEST(VectorImageSource, whenContiguousBytes_thenRemainingBytesReturned) {
+  auto imageSource =
+      io::testutils::makeVectorImageSource("abcdefghijklmnopqrst");
+
+  testutils::assertRead("abcdefghij", 10, imageSource);
+
+  const auto contiguousBytes = imageSource.contiguousBytes();
+  ASSERT_TRUE(contiguousBytes.hasValue());
+  ASSERT_EQ(
+      "klmnopqrst",
+      std::string(
+          reinterpret_cast<const char*>(contiguousBytes->data()),
+          contiguousBytes->size()));
+  ASSERT_EQ(10, imageSource.getTotalBytesRead());
+}
+
+TEST(VectorImageSource, whenSkipping_thenReadHeadAdvanced) {
+  auto imageSource =
+      io::testutils::makeVectorImageSource("abcdefghijklmnopqrst");
+
+  ASSERT_EQ(5, imageSource.skip(5));
+  ASSERT_EQ(5, imageSource.getTotalBytesRead());
+  testutils::assertRead("fghij", 5, imageSource);
+
+  ASSERT_EQ(10, imageSource.skip(20));
+  ASSERT_EQ(20, imageSource.getTotalBytesRead());
+  ASSERT_EQ(0, imageSource.available());
+}
+
 TEST(
     VectorBitmapImageSource,
     whenConstructedWithSpecification_thenSpecificationReads) {
@@ -59,6 +59,33 @@ TEST(
   ASSERT_TRUE(scanline == nullptr);
 }
 
+TEST(
+    plugins_avif_AvifDecompressor,
+    whenReadingSpecification_thenImageDataNotReadYet) {
+  io::FileImageSource source{
+      testdata::paths::avif::s256_170_rav1e_s420.normalized()};
+  auto decompressor = AvifDecompressor{source};
+
+  decompressor.sourceImageSpecification();
+  ASSERT_LT(0u, source.available());
+}
+
+TEST(
+    plugins_avif_AvifDecompressor,
+    whenDecodingWithMultipleThreads_thenAllScanlinesReturned) {
+  io::FileImageSource source{
+      testdata::paths::avif::s256_170_rav1e_s420.normalized()};
+  Configuration configuration;
+  configuration.avif.maxThreads(4);
+  auto decompressor = AvifDecompressor{source, configuration};
+
+  const auto specifications = decompressor.sourceImageSpecification();
+  for (auto row = 0; row < specifications.size.height; row++) {
+    ASSERT_TRUE(decompressor.readScanline() != nullptr);
+  }
+  ASSERT_TRUE(decompressor.readScanline() == nullptr);
+}
+
 } // namespace test
 } // namespace avif
 } // namespace plugins
@@ -8,11 +8,15 @@
 #include <spectrum/Configuration.h>
 #include <spectrum/io/FileImageSource.h>
 #include <spectrum/testutils/TestUtils.h>
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -305,6 +309,234 @@ TEST(
   }
 }
 
+//
+// Reading scanlines in batches
+//
+
+TEST(
+    plugins_jpeg_LibJpegDecompressor,
+    whenReadingScanlinesInBatches_thenEqualToReadingSingleScanlines) {
+  io::FileImageSource batchSource{
+      testdata::paths::jpeg::s128x85_Q75_BASELINE.normalized()};
+  io::FileImageSource singleSource{
+      testdata::paths::jpeg::s128x85_Q75_BASELINE.normalized()};
+  auto batchDecompressor = LibJpegDecompressor{batchSource};
+  auto singleDecompressor = LibJpegDecompressor{singleSource};
+
+  const std::size_t height =
+      batchDecompressor.outputImageSpecification().size.height;
+  std::size_t row = 0;
+  while (row < height) {
+    const auto scanlines = batchDecompressor.readScanlines(
+        std::min<std::size_t>(16, height - row));
+    for (const auto& scanline : scanlines) {
+      const auto expected = singleDecompressor.readScanline();
+      ASSERT_EQ(expected->sizeBytes(), scanline->sizeBytes());
+      ASSERT_EQ(
+          0,
+          std::memcmp(
+              expected->data(), scanline->data(), scanline->sizeBytes()));
+      ++row;
+    }
+  }
+}
+
+TEST(
+    plugins_jpeg_LibJpegDecompressor,
+    whenReadingMoreScanlinesThanRemaining_thenThrow) {
+  io::FileImageSource source{
+      testdata::paths::jpeg::s16x16_WHITE_Q75_GRAYSCALE.normalized()};
+  auto decompressor = LibJpegDecompressor{source};
+
+  ASSERT_EQ(8, decompressor.readScanlines(8).size());
+  ASSERT_THROW(decompressor.readScanlines(9), SpectrumException);
+}
+
+//
+// Progressive scan limit
+//
+
+namespace {
+std::vector<std::unique_ptr<image::Scanline>> readAllScanlines(
+    LibJpegDecompressor& decompressor) {
+  return decompressor.readScanlines(
+      decompressor.outputImageSpecification().size.height);
+}
+
+bool equalScanlines(
+    const std::vector<std::unique_ptr<image::Scanline>>& lhs,
+    const std::vector<std::unique_ptr<image::Scanline>>& rhs) {
+  return std::equal(
+      lhs.cbegin(),
+      lhs.cend(),
+      rhs.cbegin(),
+      rhs.cend(),
+      [](const std::unique_ptr<image::Scanline>& l,
+         const std::unique_ptr<image::Scanline>& r) {
+        return l->sizeBytes() == r->sizeBytes() &&
+            std::memcmp(l->data(), r->data(), l->sizeBytes()) == 0;
+      });
+}
+
+Configuration makeConfigurationWithScanLimit(const int maxProgressiveScans) {
+  auto configuration = Configuration{};
+  configuration.jpeg.maxProgressiveScans(maxProgressiveScans);
+  return configuration;
+}
+} // namespace
+
+TEST(
+    plugins_jpeg_LibJpegDecompressor,
+    whenLimitingScansOfProgressiveImage_thenApproximationDecoded) {
+  const auto path = testdata::paths::jpeg::s128x85_Q75_PROGRESSIVE;
+  io::FileImageSource fullSource{path.normalized()};
+  io::FileImageSource limitedSource{path.normalized()};
+  auto fullDecompressor = LibJpegDecompressor{fullSource};
+  auto limitedDecompressor = LibJpegDecompressor{
+      limitedSource, makeConfigurationWithScanLimit(1)};
+
+  ASSERT_EQ(
+      fullDecompressor.outputImageSpecification(),
+      limitedDecompressor.outputImageSpecification());
+#if defined(SPECTRUM_LIBJPEG_SCAN_LIMIT)
+  ASSERT_FALSE(equalScanlines(
+      readAllScanlines(fullDecompressor),
+      readAllScanlines(limitedDecompressor)));
+#else
+  // all scans keep being decoded
+  ASSERT_TRUE(equalScanlines(
+      readAllScanlines(fullDecompressor),
+      readAllScanlines(limitedDecompressor)));
+#endif
+}
+
+TEST(
+    plugins_jpeg_LibJpegDecompressor,
+    whenScanLimitNotReached_thenEqualToFullDecode) {
+  // a baseline image has a single scan, the progressive one less than 100
+  for (const auto& pathAndScanLimit :
+       {std::make_pair(testdata::paths::jpeg::s128x85_Q75_BASELINE, 1),
+        std::make_pair(testdata::paths::jpeg::s128x85_Q75_PROGRESSIVE, 100)}) {
+    const auto path = pathAndScanLimit.first.normalized();
+    io::FileImageSource fullSource{path};
+    io::FileImageSource limitedSource{path};
+    auto fullDecompressor = LibJpegDecompressor{fullSource};
+    auto limitedDecompressor = LibJpegDecompressor{
+        limitedSource, makeConfigurationWithScanLimit(pathAndScanLimit.second)};
+
+    ASSERT_TRUE(equalScanlines(
+        readAllScanlines(fullDecompressor),
+        readAllScanlines(limitedDecompressor)));
+  }
+}
+
+TEST(
+    plugins_jpeg_LibJpegDecompressor,
+    whenLimitingScansWithSampling_thenSampledSizeDecoded) {
+  io::FileImageSource source{
+      testdata::paths::jpeg::s128x85_Q75_PROGRESSIVE.normalized()};
+  auto decompressor = LibJpegDecompressor{
+      source, makeConfigurationWithScanLimit(2), image::Ratio{2, 8}};
+
+  ASSERT_EQ(
+      (image::Size{32, 22}), decompressor.outputImageSpecification().size);
+  ASSERT_EQ(22, readAllScanlines(decompressor).size());
+}
+
+//
+// Region of interest
+//
+
+namespace {
+/**
+ * Decodes the requested region with and without a region of interest and
+ * compares the pixels.
+ */
+void assertRegionEqualsFullDecode(
+    const testdata::Path& path,
+    const folly::Optional<image::Ratio>& samplingRatio,
+    const image::Rect& requestedRegion,
+    const Configuration& configuration = Configuration()) {
+  io::FileImageSource regionSource{path.normalized()};
+  io::FileImageSource fullSource{path.normalized()};
+  auto regionDecompressor =
+      LibJpegDecompressor{regionSource, configuration, samplingRatio};
+  auto fullDecompressor =
+      LibJpegDecompressor{fullSource, configuration, samplingRatio};
+
+  const auto region = regionDecompressor.setRegionOfInterest(requestedRegion);
+
+#if !defined(SPECTRUM_LIBJPEG_REGION_OF_INTEREST)
+  // the whole image keeps being decoded
+  ASSERT_FALSE(region.hasValue());
+  ASSERT_EQ(
+      fullDecompressor.outputImageSpecification(),
+      regionDecompressor.outputImageSpecification());
+  return;
+#endif
+
+  // the columns are extended to iMCU boundaries (and beyond for context)
+  ASSERT_TRUE(region.hasValue());
+  ASSERT_LE(region->topLeft.x, requestedRegion.topLeft.x);
+  ASSERT_GE(region->maxX(), requestedRegion.maxX());
+  ASSERT_EQ(requestedRegion.topLeft.y, region->topLeft.y);
+  ASSERT_EQ(requestedRegion.size.height, region->size.height);
+  ASSERT_EQ(region->size, regionDecompressor.outputImageSpecification().size);
+
+  const auto bytesPerPixel = fullDecompressor.outputImageSpecification()
+                                 .pixelSpecification.bytesPerPixel;
+  const auto scanlines =
+      regionDecompressor.readScanlines(requestedRegion.size.height);
+  fullDecompressor.readScanlines(requestedRegion.topLeft.y);
+  for (const auto& scanline : scanlines) {
+    const auto expected = fullDecompressor.readScanline();
+    ASSERT_EQ(region->size.width, scanline->width());
+    ASSERT_EQ(
+        0,
+        std::memcmp(
+            expected->dataAtPixel(requestedRegion.topLeft.x),
+            scanline->dataAtPixel(
+                requestedRegion.topLeft.x - region->topLeft.x),
+            requestedRegion.size.width * bytesPerPixel));
+  }
+
+  ASSERT_THROW(regionDecompressor.readScanlines(1), SpectrumException);
+}
+} // namespace
+
+TEST(
+    plugins_jpeg_LibJpegDecompressor,
+    whenSettingRegionOfInterest_thenRegionEqualsFullDecode) {
+  const auto region =
+      image::Rect{{.x = 37, .y = 21}, {.width = 50, .height = 30}};
+  assertRegionEqualsFullDecode(
+      testdata::paths::jpeg::s128x85_Q75_BASELINE, folly::none, region);
+  assertRegionEqualsFullDecode(
+      testdata::paths::jpeg::s128x85_Q75_PROGRESSIVE, folly::none, region);
+  assertRegionEqualsFullDecode(
+      testdata::paths::jpeg::s128x85_Q75_PROGRESSIVE,
+      folly::none,
+      image::Rect{{.x = 70, .y = 33}, {.width = 40, .height = 20}},
+      makeConfigurationWithScanLimit(2));
+  assertRegionEqualsFullDecode(
+      testdata::paths::jpeg::s128x85_Q75_BASELINE,
+      image::Ratio{4, 8},
+      image::Rect{{.x = 9, .y = 5}, {.width = 30, .height = 20}});
+}
+
+TEST(
+    plugins_jpeg_LibJpegDecompressor,
+    whenRegionOfInterestOutsideOfImage_thenThrow) {
+  io::FileImageSource source{
+      testdata::paths::jpeg::s128x85_Q75_BASELINE.normalized()};
+  auto decompressor = LibJpegDecompressor{source};
+
+  ASSERT_THROW(
+      decompressor.setRegionOfInterest(
+          image::Rect{{.x = 100, .y = 0}, {.width = 50, .height = 10}}),
+      SpectrumException);
+}
+
 } // namespace test
 } // namespace jpeg
 } // namespace plugins
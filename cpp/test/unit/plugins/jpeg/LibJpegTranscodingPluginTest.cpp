@@ -6,13 +6,22 @@
 #include <spectrum/plugins/jpeg/LibJpegTranscodingPlugin.h>
 
 #include <spectrum/Spectrum.h>
+#include <spectrum/image/metadata/Entries.h>
+#include <spectrum/io/FileImageSource.h>
+#include <spectrum/io/VectorImageSink.h>
+#include <spectrum/io/VectorImageSource.h>
+#include <spectrum/plugins/jpeg/LibJpegDecompressor.h>
 #include <spectrum/testutils/TestUtils.h>
 
 #include <array>
 #include <cstddef>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -22,6 +31,126 @@ namespace plugins {
 namespace jpeg {
 namespace test {
 
+namespace {
+TranscodeOptions makeOptions(
+    const folly::Optional<requirements::Resize>& resizeRequirement) {
+  auto transformations = Transformations{};
+  transformations.resizeRequirement = resizeRequirement;
+  return TranscodeOptions(
+      requirements::Encode{.format = image::formats::Jpeg, .quality = 90},
+      transformations);
+}
+
+image::Size decodedSize(io::CharVectorEncodedImageSink& sink) {
+  io::CharVectorEncodedImageSource source{sink.getVectorReference()};
+  LibJpegDecompressor decompressor{source};
+  const auto size = decompressor.outputImageSpecification().size;
+  for (std::uint32_t i = 0; i < size.height; ++i) {
+    decompressor.readScanline();
+  }
+  return size;
+}
+
+std::vector<char> readFile(const testdata::Path& path) {
+  std::ifstream stream{path.normalized(), std::ios::binary};
+  return {
+      std::istreambuf_iterator<char>(stream),
+      std::istreambuf_iterator<char>()};
+}
+
+/**
+ * Inserts an EXIF segment with the orientation and the thumbnail in its 1st
+ * IFD after the JFIF segment of the image.
+ */
+std::vector<char> makeJpegWithThumbnail(
+    const testdata::Path& imagePath,
+    const testdata::Path& thumbnailPath,
+    const image::Orientation orientation) {
+  using image::metadata::Entries;
+  using image::metadata::Entry;
+
+  const auto tiffEntries = Entry::TagMap{
+      {Entry::ORIENTATION,
+       Entry{
+           Entry::ORIENTATION,
+           Entry::SHORT,
+           static_cast<std::uint16_t>(orientation)}},
+  };
+  auto exif = Entries{tiffEntries}.makeData();
+
+  // link the 1st IFD from the end of the 0th IFD and append it
+  const auto tiffHeaderBegin =
+      sizeof(Entries::MemoryLayout) - Entries::MemoryLayout::DEFAULT_OFFSET;
+  const auto nextIfdOffsetBegin = sizeof(Entries::MemoryLayout) +
+      sizeof(std::uint16_t) + sizeof(Entry::MemoryLayout);
+  const auto ifd1Offset =
+      static_cast<std::uint32_t>(exif.size() - tiffHeaderBegin);
+  std::memcpy(&exif[nextIfdOffsetBegin], &ifd1Offset, sizeof(ifd1Offset));
+
+  const auto thumbnail = readFile(thumbnailPath);
+  const auto thumbnailOffset = static_cast<std::uint32_t>(
+      ifd1Offset + sizeof(std::uint16_t) + 2 * sizeof(Entry::MemoryLayout) +
+      sizeof(std::uint32_t));
+  image::metadata::utils::insertValueIntoData(std::uint16_t{2}, exif);
+  Entry{Entry::JPEG_INTERCHANGE_FORMAT, Entry::LONG, thumbnailOffset}
+      .insertIntoData(exif);
+  Entry{
+      Entry::JPEG_INTERCHANGE_FORMAT_LENGTH,
+      Entry::LONG,
+      static_cast<std::uint32_t>(thumbnail.size())}
+      .insertIntoData(exif);
+  image::metadata::utils::insertValueIntoData(std::uint32_t{0}, exif);
+  exif.insert(exif.end(), thumbnail.begin(), thumbnail.end());
+
+  // SOI and APP0 are followed by the APP1 segment
+  const auto image = readFile(imagePath);
+  const auto app0Length = (static_cast<std::uint8_t>(image[4]) << 8) +
+      static_cast<std::uint8_t>(image[5]);
+  const auto app1Length = exif.size() + 2;
+  const auto app1Begin = image.begin() + 4 + app0Length;
+  auto result = std::vector<char>(image.begin(), app1Begin);
+  result.push_back(static_cast<char>(0xFF));
+  result.push_back(static_cast<char>(0xE1));
+  result.push_back(static_cast<char>(app1Length >> 8));
+  result.push_back(static_cast<char>(app1Length & 0xFF));
+  result.insert(result.end(), exif.begin(), exif.end());
+  result.insert(result.end(), app1Begin, image.end());
+  return result;
+}
+
+Result transcodeWithThumbnail(
+    const image::Orientation orientation,
+    const image::Size& targetSize,
+    const bool useEmbeddedThumbnail,
+    io::CharVectorEncodedImageSink& sink,
+    const bool forceUpOrientation = false) {
+  std::vector<Plugin> plugins;
+  plugins.push_back(makeTranscodingPlugin());
+  const auto spectrum = Spectrum{std::move(plugins)};
+
+  io::CharVectorEncodedImageSource source{makeJpegWithThumbnail(
+      testdata::paths::jpeg::s800x530_Q75_BASELINE,
+      testdata::paths::jpeg::s128x85_Q75_GRAYSCALE,
+      orientation)};
+  auto transformations = Transformations{};
+  transformations.resizeRequirement = requirements::Resize{
+      .mode = requirements::Resize::Mode::ExactOrSmaller,
+      .targetSize = targetSize};
+  if (forceUpOrientation) {
+    transformations.rotateRequirement =
+        requirements::Rotate{.forceUpOrientation = true};
+  }
+  auto configuration = Configuration{};
+  configuration.jpeg.useEmbeddedThumbnail(useEmbeddedThumbnail);
+  const auto options = TranscodeOptions(
+      requirements::Encode{.format = image::formats::Jpeg, .quality = 90},
+      transformations,
+      folly::none,
+      configuration);
+  return spectrum.transcode(source, sink, options);
+}
+} // namespace
+
 TEST(
     plugins_jpeg_LibJpegTranscodingPlugin,
     whenFetchingDecompressorProvider_thenSupportedSamplingRatiosAreCorrect) {
@@ -41,6 +170,146 @@ TEST(
   }
 }
 
+TEST(
+    plugins_jpeg_LibJpegTranscodingPlugin,
+    whenTranscodingMultiple_thenEachOutputDecodedFromSharedDecode) {
+  std::vector<Plugin> plugins;
+  plugins.push_back(makeTranscodingPlugin());
+  const auto spectrum = Spectrum{std::move(plugins)};
+
+  io::FileImageSource source{
+      testdata::paths::jpeg::s128x85_Q75_BASELINE.normalized()};
+  io::CharVectorEncodedImageSink largeSink;
+  io::CharVectorEncodedImageSink smallSink;
+  io::CharVectorEncodedImageSink exactSink;
+
+  const auto results = spectrum.transcodeMultiple(
+      source,
+      {
+          {largeSink,
+           makeOptions(requirements::Resize{
+               .mode = requirements::Resize::Mode::ExactOrSmaller,
+               .targetSize = image::Size{64, 64}})},
+          {smallSink,
+           makeOptions(requirements::Resize{
+               .mode = requirements::Resize::Mode::ExactOrSmaller,
+               .targetSize = image::Size{32, 32}})},
+          {exactSink,
+           makeOptions(requirements::Resize{
+               .mode = requirements::Resize::Mode::Exact,
+               .targetSize = image::Size{50, 50}})},
+      });
+
+  ASSERT_EQ(3, results.size());
+  ASSERT_EQ((image::Size{64, 43}), results[0].outputImageSpecification.size);
+  ASSERT_EQ((image::Size{32, 22}), results[1].outputImageSpecification.size);
+  ASSERT_EQ((image::Size{50, 34}), results[2].outputImageSpecification.size);
+
+  ASSERT_EQ((image::Size{64, 43}), decodedSize(largeSink));
+  ASSERT_EQ((image::Size{32, 22}), decodedSize(smallSink));
+  ASSERT_EQ((image::Size{50, 34}), decodedSize(exactSink));
+
+  for (const auto& result : results) {
+    ASSERT_EQ((image::Size{128, 85}), result.inputImageSpecification.size);
+    ASSERT_GT(result.totalBytesWritten, 0);
+  }
+}
+
+TEST(
+    plugins_jpeg_LibJpegTranscodingPlugin,
+    whenThumbnailLargeEnough_thenThumbnailDecoded) {
+  io::CharVectorEncodedImageSink sink;
+  const auto result = transcodeWithThumbnail(
+      image::Orientation::Up, image::Size{64, 64}, true, sink);
+
+  // the grayscale thumbnail has been decoded instead of the colored image
+  ASSERT_EQ("libjpeg_embedded_thumbnail", result.ruleName);
+  ASSERT_EQ((image::Size{800, 530}), result.inputImageSpecification.size);
+  ASSERT_EQ(
+      image::pixel::specifications::Gray,
+      result.outputImageSpecification.pixelSpecification);
+  ASSERT_EQ((image::Size{64, 43}), result.outputImageSpecification.size);
+  ASSERT_EQ((image::Size{64, 43}), decodedSize(sink));
+}
+
+TEST(
+    plugins_jpeg_LibJpegTranscodingPlugin,
+    whenThumbnailTooSmall_thenImageDecoded) {
+  io::CharVectorEncodedImageSink sink;
+  const auto result = transcodeWithThumbnail(
+      image::Orientation::Up, image::Size{200, 200}, true, sink);
+
+  ASSERT_EQ("base", result.ruleName);
+  ASSERT_EQ(
+      image::pixel::specifications::RGB,
+      result.outputImageSpecification.pixelSpecification);
+  ASSERT_EQ((image::Size{200, 133}), result.outputImageSpecification.size);
+  ASSERT_EQ((image::Size{200, 133}), decodedSize(sink));
+}
+
+TEST(
+    plugins_jpeg_LibJpegTranscodingPlugin,
+    whenEmbeddedThumbnailNotEnabled_thenImageDecoded) {
+  io::CharVectorEncodedImageSink sink;
+  const auto result = transcodeWithThumbnail(
+      image::Orientation::Up, image::Size{64, 64}, false, sink);
+
+  ASSERT_EQ("base", result.ruleName);
+  ASSERT_EQ(
+      image::pixel::specifications::RGB,
+      result.outputImageSpecification.pixelSpecification);
+  ASSERT_EQ((image::Size{64, 43}), result.outputImageSpecification.size);
+}
+
+TEST(
+    plugins_jpeg_LibJpegTranscodingPlugin,
+    whenImageOriented_thenThumbnailOrientedAlike) {
+  io::CharVectorEncodedImageSink sink;
+  const auto result = transcodeWithThumbnail(
+      image::Orientation::Right, image::Size{64, 64}, true, sink, true);
+
+  ASSERT_EQ(
+      image::pixel::specifications::Gray,
+      result.outputImageSpecification.pixelSpecification);
+  ASSERT_EQ(
+      image::Orientation::Up, result.outputImageSpecification.orientation);
+  ASSERT_EQ((image::Size{43, 64}), result.outputImageSpecification.size);
+  ASSERT_EQ((image::Size{43, 64}), decodedSize(sink));
+}
+
+TEST(
+    plugins_jpeg_LibJpegTranscodingPlugin,
+    whenPipelined_thenOutputEqualsSingleThreaded) {
+  std::vector<Plugin> plugins;
+  plugins.push_back(makeTranscodingPlugin());
+  const auto spectrum = Spectrum{std::move(plugins)};
+
+  auto transformations = Transformations{};
+  transformations.resizeRequirement = requirements::Resize{
+      .mode = requirements::Resize::Mode::Exact,
+      .targetSize = image::Size{300, 300}};
+
+  std::vector<std::vector<char>> outputs;
+  for (const auto usePipelining : {false, true}) {
+    auto configuration = Configuration{};
+    configuration.general.usePipelining(usePipelining);
+    const auto options = TranscodeOptions(
+        requirements::Encode{.format = image::formats::Jpeg, .quality = 90},
+        transformations,
+        folly::none,
+        configuration);
+
+    io::FileImageSource source{
+        testdata::paths::jpeg::s800x530_Q75_BASELINE.normalized()};
+    io::CharVectorEncodedImageSink sink;
+    const auto result = spectrum.transcode(source, sink, options);
+    ASSERT_EQ((image::Size{300, 199}), result.outputImageSpecification.size);
+    outputs.push_back(sink.getVectorReference());
+  }
+
+  ASSERT_EQ(outputs[0], outputs[1]);
+}
+
 } // namespace test
 } // namespace jpeg
 } // namespace plugins
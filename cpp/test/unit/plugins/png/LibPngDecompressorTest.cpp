@@ -7,8 +7,10 @@
 
 #include <spectrum/io/FileImageSource.h>
 #include <spectrum/testutils/TestUtils.h>
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -326,6 +328,44 @@ TEST(
   }
 }
 
+//
+// Reading scanlines in batches
+//
+
+TEST(
+    plugins_png_LibPngDecompressor,
+    whenReadingScanlinesInBatches_thenEqualToReadingSingleScanlines) {
+  for (const auto& path :
+       {testdata::paths::png::s128x85_RGB,
+        testdata::paths::png::s128x85_RGB_INTERLACED}) {
+    io::FileImageSource batchSource{path.normalized()};
+    io::FileImageSource singleSource{path.normalized()};
+    auto batchDecompressor = LibPngDecompressor{batchSource};
+    auto singleDecompressor = LibPngDecompressor{singleSource};
+
+    const std::size_t height =
+        batchDecompressor.sourceImageSpecification().size.height;
+    std::size_t row = 0;
+    while (row < height) {
+      const auto scanlines = batchDecompressor.readScanlines(
+          std::min<std::size_t>(16, height - row));
+      for (const auto& scanline : scanlines) {
+        const auto expected = singleDecompressor.readScanline();
+        ASSERT_EQ(expected->sizeBytes(), scanline->sizeBytes());
+        ASSERT_EQ(
+            0,
+            std::memcmp(
+                expected->data(), scanline->data(), scanline->sizeBytes()));
+        ++row;
+      }
+    }
+  }
+}
+
+//
+// Error handling
+//
+
 //
 // Error handling
 //
@@ -149,6 +149,48 @@ TEST(
   }
 }
 
+TEST(
+    plugins_webp_LibWebpDecompressor,
+    whenReadingFirstScanline_thenInputNotReadCompletely) {
+  io::FileImageSource source{
+      testdata::paths::webp::s400x301_WITH_ALPHA_LOSSLESS.normalized()};
+  auto decompressor = LibWebpDecompressor{source};
+
+  decompressor.readScanline();
+  ASSERT_LT(0u, source.available());
+}
+
+TEST(
+    plugins_webp_LibWebpDecompressor,
+    whenSampling_thenOutputSizeScaledAndScanlinesRead) {
+  io::FileImageSource source{
+      testdata::paths::webp::s128x85_RGB_LOSSY.normalized()};
+  LibWebpDecompressor decompressor{source, image::Ratio{4, 8}};
+  const auto outputImageSpecification = decompressor.outputImageSpecification();
+
+  ASSERT_EQ(
+      (image::Size{128, 85}), decompressor.sourceImageSpecification().size);
+  ASSERT_EQ((image::Size{64, 43}), outputImageSpecification.size);
+
+  for (int i = 0; i < outputImageSpecification.size.height; i++) {
+    const auto scanline = decompressor.readScanline();
+    ASSERT_EQ(64, scanline->width());
+  }
+  ASSERT_THROW(decompressor.readScanline(), SpectrumException);
+}
+
+TEST(
+    plugins_webp_LibWebpDecompressor,
+    whenSamplingWithUnsupportedRatio_thenThrows) {
+  io::FileImageSource source{
+      testdata::paths::webp::s128x85_RGB_LOSSY.normalized()};
+
+  ASSERT_THROW(
+      LibWebpDecompressor(source, image::Ratio{1, 3}), SpectrumException);
+  ASSERT_THROW(
+      LibWebpDecompressor(source, image::Ratio{9, 8}), SpectrumException);
+}
+
 //
 // Error handling
 //
@@ -35,6 +35,27 @@ CharVectorEncodedImageSource makeVectorImageSource(const std::string& content) {
   return CharVectorEncodedImageSource(std::move(v));
 }
 
+StreamingImageSource::StreamingImageSource(const std::string& content)
+    : IEncodedImageSource(), _source(makeVectorImageSource(content)) {}
+
+std::size_t StreamingImageSource::read(
+    char* const destination,
+    const std::size_t length) {
+  return _source.read(destination, length);
+}
+
+std::size_t StreamingImageSource::getTotalBytesRead() const {
+  return _source.getTotalBytesRead();
+}
+
+std::size_t StreamingImageSource::available() {
+  return _source.available();
+}
+
+StreamingImageSource makeStreamingImageSource(const std::string& content) {
+  return StreamingImageSource(content);
+}
+
 CharVectorBitmapImageSource makeVectorBitmapImageSource(
     const std::string& content,
     const image::Specification& imageSpecification) {
@@ -26,6 +26,24 @@ void assertRead(
 
 CharVectorEncodedImageSource makeVectorImageSource(const std::string& content);
 
+/**
+ * An encoded image source that does not expose its content as contiguous
+ * memory and thereby behaves like a stream.
+ */
+class StreamingImageSource : public IEncodedImageSource {
+ public:
+  explicit StreamingImageSource(const std::string& content);
+
+  std::size_t read(char* const destination, const std::size_t length) override;
+  std::size_t getTotalBytesRead() const override;
+  std::size_t available() override;
+
+ private:
+  CharVectorEncodedImageSource _source;
+};
+
+StreamingImageSource makeStreamingImageSource(const std::string& content);
+
 CharVectorBitmapImageSource makeVectorBitmapImageSource(
     const std::string& content,
     const image::Specification& imageSpecification);